@@ -0,0 +1,120 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mpi.h>
+
+#include "base.hpp"
+#include "oneapi/ccl.hpp"
+
+/*
+   measures kvs, communicator creation and split time,
+   run it with growing number of local ranks to see how bootstrap scales:
+   mpiexec -n <ranks> ./cpu_comm_create_test [iters]
+   compare with CCL_KVS_TREE_RADIX=4 to see the tree based bootstrap barrier
+*/
+struct time_stat {
+    double min_time = 0;
+    double max_time = 0;
+    double total_time = 0;
+
+    void update(int iter, double time) {
+        double iter_max_time = 0;
+        MPI_Reduce(&time, &iter_max_time, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        min_time = (iter == 0) ? iter_max_time : std::min(min_time, iter_max_time);
+        max_time = std::max(max_time, iter_max_time);
+        total_time += iter_max_time;
+    }
+
+    void print(const char* name, int size, int iters) const {
+        std::cout << "ranks: " << size << ", iters: " << iters << ", " << name << " time (ms)"
+                  << " min: " << min_time << ", avg: " << total_time / iters
+                  << ", max: " << max_time << "\n";
+    }
+};
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::max(atoi(argv[1]), 1) : 10;
+
+    ccl::init();
+
+    int size, rank;
+    MPI_Init(NULL, NULL);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    atexit(mpi_finalize);
+
+    time_stat create_stat, split_stat;
+
+    for (int iter = 0; iter < iters; iter++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto start = std::chrono::steady_clock::now();
+
+        ccl::shared_ptr_class<ccl::kvs> kvs;
+        ccl::kvs::address_type main_addr;
+        if (rank == 0) {
+            kvs = ccl::create_main_kvs();
+            main_addr = kvs->get_address();
+            MPI_Bcast((void*)main_addr.data(), main_addr.size(), MPI_BYTE, 0, MPI_COMM_WORLD);
+        }
+        else {
+            MPI_Bcast((void*)main_addr.data(), main_addr.size(), MPI_BYTE, 0, MPI_COMM_WORLD);
+            kvs = ccl::create_kvs(main_addr);
+        }
+
+        auto comm = ccl::create_communicator(size, rank, kvs);
+
+        create_stat.update(
+            iter,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count());
+
+        if (comm.size() != size) {
+            std::cout << "FAILED: unexpected comm size " << comm.size() << "\n";
+            return -1;
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        start = std::chrono::steady_clock::now();
+
+        int color = rank % 2;
+        auto split_comm = ccl::split_communicator(comm, color, rank);
+
+        split_stat.update(
+            iter,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count());
+
+        int expected_size = (size + 1 - color) / 2;
+        if (split_comm.size() != expected_size || split_comm.rank() != rank / 2) {
+            std::cout << "FAILED: unexpected split comm size " << split_comm.size() << ", rank "
+                      << split_comm.rank() << "\n";
+            return -1;
+        }
+    }
+
+    if (rank == 0) {
+        create_stat.print("comm create", size, iters);
+        split_stat.print("comm split", size, iters);
+        std::cout << "PASSED\n";
+    }
+
+    return 0;
+}
@@ -78,17 +78,9 @@ int atl_base_comm::create_comm_id() {
 
     auto comm_id_map = transport->get_comm_id_storage().get_map();
     int send_bytes = sizeof(new_comm_id) * comm_id_map.size();
-    std::vector<int> all_comm_id_maps(size * comm_id_map.size(),
-                                      atl_comm_id_storage::invalid_comm_id);
 
-    std::vector<size_t> recv_bytes(size, send_bytes);
-    std::vector<size_t> offsets(size, 0);
-    for (int i = 1; i < size; i++) {
-        offsets[i] = offsets[i - 1] + recv_bytes[i - 1];
-    }
-
-    LOG_DEBUG("rank2rank_map: ", ccl::utils::vec_to_string(rank2rank_map));
-    LOG_DEBUG("rank2proc_map: ", ccl::utils::vec_to_string(rank2proc_map));
+    LOG_DEBUG("rank2rank_map: ", rank2rank_map.to_string());
+    LOG_DEBUG("rank2proc_map: ", rank2proc_map.to_string());
     // LOG_DEBUG("comm_id_map: ", ccl::utils::vec_to_string(comm_id_map));
 
     if (std::any_of(comm_id_map.begin(), comm_id_map.end(), [](int id) {
@@ -97,6 +89,51 @@ int atl_base_comm::create_comm_id() {
         CCL_THROW("comm_id_map contains invalid value: ", ccl::utils::vec_to_string(comm_id_map));
     }
 
+    // comm_id is free only if it is free on every rank, so min over ranks is enough,
+    // it keeps the exchange size independent of comm size
+    std::vector<int> common_comm_id_map(comm_id_map.size(), 0);
+    atl_req_t reduce_req{};
+    atl_status_t reduce_status = allreduce(0 /* ep_idx */,
+                                           comm_id_map.data(),
+                                           common_comm_id_map.data(),
+                                           send_bytes,
+                                           ATL_DTYPE_INT32,
+                                           ATL_REDUCTION_MIN,
+                                           reduce_req);
+
+    if (reduce_status == ATL_STATUS_SUCCESS) {
+        wait(0, reduce_req);
+        auto it = std::find(common_comm_id_map.begin(), common_comm_id_map.end(), 1);
+        if (it != common_comm_id_map.end()) {
+            new_comm_id = std::distance(common_comm_id_map.begin(), it);
+        }
+    }
+    else {
+        CCL_THROW_IF_NOT(reduce_status == ATL_STATUS_UNSUPPORTED, "comm_id allreduce failed");
+        new_comm_id = create_comm_id_by_allgatherv(comm_id_map);
+    }
+
+    LOG_DEBUG("new_comm_id ", new_comm_id);
+    CCL_THROW_IF_NOT(new_comm_id != atl_comm_id_storage::invalid_comm_id, "unexpected comm_id");
+
+    transport->get_comm_id_storage().acquire(new_comm_id);
+
+    return new_comm_id;
+}
+
+int atl_base_comm::create_comm_id_by_allgatherv(const std::vector<int>& comm_id_map) {
+    int new_comm_id = atl_comm_id_storage::invalid_comm_id;
+
+    int send_bytes = sizeof(new_comm_id) * comm_id_map.size();
+    std::vector<int> all_comm_id_maps(size * comm_id_map.size(),
+                                      atl_comm_id_storage::invalid_comm_id);
+
+    std::vector<size_t> recv_bytes(size, send_bytes);
+    std::vector<size_t> offsets(size, 0);
+    for (int i = 1; i < size; i++) {
+        offsets[i] = offsets[i - 1] + recv_bytes[i - 1];
+    }
+
     atl_req_t req{};
     allgatherv(0 /* ep_idx */,
                comm_id_map.data(),
@@ -129,11 +166,6 @@ int atl_base_comm::create_comm_id() {
         }
     }
 
-    LOG_DEBUG("new_comm_id ", new_comm_id);
-    CCL_THROW_IF_NOT(new_comm_id != atl_comm_id_storage::invalid_comm_id, "unexpected comm_id");
-
-    transport->get_comm_id_storage().acquire(new_comm_id);
-
     return new_comm_id;
 }
 
@@ -154,6 +186,10 @@ void atl_base_comm::init_tag() {
                     new ccl_atl_tag_impl<common_tag_layout>(tag_bits, max_tag));
             }
             break;
+        case ccl_atl_shm:
+            tag_creator = std::shared_ptr<ccl_atl_tag>(
+                new ccl_atl_tag_impl<common_tag_layout>(tag_bits, max_tag));
+            break;
 #ifdef CCL_ENABLE_MPI
         case ccl_atl_mpi:
             CCL_THROW_IF_NOT(max_tag >= mpi_tag_layout::op_id_mask + mpi_tag_layout::sched_id_mask,
@@ -184,7 +220,8 @@ std::shared_ptr<atl_base_comm> atl_comm_manager::create() {
     auto transport_type = ccl::global_data::env().atl_transport;
 
     switch (transport_type) {
-        case ccl_atl_ofi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm()); break;
+        case ccl_atl_ofi:
+        case ccl_atl_shm: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm()); break;
 #ifdef CCL_ENABLE_MPI
         case ccl_atl_mpi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_mpi_comm()); break;
 #endif // CCL_ENABLE_MPI
@@ -202,7 +239,8 @@ std::shared_ptr<atl_base_comm> atl_comm_manager::create(ccl::ccl_comm_attr_impl&
     auto transport_type = ccl::global_data::env().atl_transport;
 
     switch (transport_type) {
-        case ccl_atl_ofi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm()); break;
+        case ccl_atl_ofi:
+        case ccl_atl_shm: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm()); break;
 #ifdef CCL_ENABLE_MPI
         case ccl_atl_mpi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_mpi_comm()); break;
 #endif // CCL_ENABLE_MPI
@@ -221,7 +259,8 @@ std::shared_ptr<atl_base_comm> atl_comm_manager::create(std::shared_ptr<ikvs_wra
     auto transport_type = ccl::global_data::env().atl_transport;
 
     switch (transport_type) {
-        case ccl_atl_ofi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm(k)); break;
+        case ccl_atl_ofi:
+        case ccl_atl_shm: atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm(k)); break;
 #ifdef CCL_ENABLE_MPI
         case ccl_atl_mpi: atl_comm = std::shared_ptr<atl_base_comm>(new atl_mpi_comm(k)); break;
 #endif // CCL_ENABLE_MPI
@@ -243,6 +282,7 @@ std::shared_ptr<atl_base_comm> atl_comm_manager::create(int comm_size,
 
     switch (transport_type) {
         case ccl_atl_ofi:
+        case ccl_atl_shm:
             atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm(comm_size, ranks, k));
             break;
 #ifdef CCL_ENABLE_MPI
@@ -263,7 +303,8 @@ std::shared_ptr<atl_base_comm> atl_comm_manager::create_with_id(
     auto transport_type = ccl::global_data::env().atl_transport;
 
     switch (transport_type) {
-        case ccl_atl_ofi: {
+        case ccl_atl_ofi:
+        case ccl_atl_shm: {
             std::shared_ptr<atl_ofi_comm> ofi_base_comm =
                 std::dynamic_pointer_cast<atl_ofi_comm>(base_comm);
             atl_comm = std::shared_ptr<atl_base_comm>(new atl_ofi_comm(*ofi_base_comm.get()));
@@ -15,6 +15,8 @@
 */
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <list>
@@ -22,6 +24,8 @@
 
 #include "atl/atl_base_transport.hpp"
 #include "atl/atl_def.h"
+#include "common/log/trace.hpp"
+#include "common/utils/rank_map.hpp"
 #include "comm/atl_tag.hpp"
 #include "util/pm/pmi_resizable_rt/pmi_resizable/kvs/ikvs_wrapper.h"
 #include "util/pm/pmi_resizable_rt/pmi_resizable/kvs/internal_kvs.h"
@@ -62,13 +66,19 @@ public:
         return transport->mr_dereg(mr);
     }
 
+    virtual atl_status_t mr_cache_invalidate(const void* buf, size_t len) {
+        return transport->mr_cache_invalidate(buf, len);
+    }
+
     virtual atl_status_t send(size_t ep_idx,
                               const void* buf,
                               size_t len,
                               int dst_proc_idx,
                               uint64_t tag,
                               atl_req_t& req) {
-        return transport->send(eps[ep_idx], buf, len, dst_proc_idx, tag, req);
+        atl_status_t ret = transport->send(eps[ep_idx], buf, len, dst_proc_idx, tag, req);
+        trace_post("atl_send", req, len, ret);
+        return ret;
     }
 
     virtual atl_status_t recv(size_t ep_idx,
@@ -77,7 +87,9 @@ public:
                               int src_proc_idx,
                               uint64_t tag,
                               atl_req_t& req) {
-        return transport->recv(eps[ep_idx], buf, len, src_proc_idx, tag, req);
+        atl_status_t ret = transport->recv(eps[ep_idx], buf, len, src_proc_idx, tag, req);
+        trace_post("atl_recv", req, len, ret);
+        return ret;
     }
 
     virtual atl_status_t probe(size_t ep_idx,
@@ -213,8 +225,21 @@ public:
         return transport->poll(eps[ep_idx]);
     }
 
+    virtual atl_status_t get_wait_fds(size_t ep_idx, std::vector<int>& fds) {
+        return transport->get_wait_fds(eps[ep_idx], fds);
+    }
+
+    virtual atl_status_t try_wait(size_t ep_idx) {
+        return transport->try_wait(eps[ep_idx]);
+    }
+
     virtual atl_status_t check(size_t ep_idx, atl_req_t& req) {
-        return transport->check(eps[ep_idx], req);
+        int was_completed = req.is_completed;
+        atl_status_t ret = transport->check(eps[ep_idx], req);
+        if (!was_completed && req.is_completed) {
+            CCL_TRACE(atl_complete, &req, "atl_req");
+        }
+        return ret;
     }
 
     virtual std::shared_ptr<atl_base_comm> comm_split(int color, int key) = 0;
@@ -235,11 +260,12 @@ public:
         return coord.hostname_hash;
     }
 
-    std::vector<int> get_rank2rank_map() const {
+    const ccl_rank_map& get_rank2rank_map() const {
         return rank2rank_map;
     }
 
     int create_comm_id();
+    int create_comm_id_by_allgatherv(const std::vector<int>& comm_id_map);
 
     int get_comm_id() const {
         return comm_id;
@@ -258,6 +284,17 @@ protected:
     void init_tag();
     void update_executor();
 
+    /* request may be completed inline by transport, then check is not called for it */
+    static void trace_post(const char* name, const atl_req_t& req, size_t len, atl_status_t ret) {
+        if (ret == ATL_STATUS_SUCCESS) {
+            CCL_TRACE(
+                atl_post, &req, name, static_cast<uint32_t>(std::min<size_t>(len, UINT32_MAX)));
+            if (req.is_completed) {
+                CCL_TRACE(atl_complete, &req, "atl_req");
+            }
+        }
+    }
+
     friend class atl_comm_manager;
 
     int rank;
@@ -266,8 +303,8 @@ protected:
     int parent_rank;
     int parent_size;
 
-    std::vector<int> rank2rank_map{};
-    std::vector<int> rank2proc_map{};
+    ccl_rank_map rank2rank_map{};
+    ccl_rank_map rank2proc_map{};
     atl_proc_coord_t coord;
 
     int comm_id = atl_comm_id_storage::invalid_comm_id;
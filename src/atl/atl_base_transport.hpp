@@ -69,6 +69,11 @@ public:
 
     virtual atl_status_t mr_dereg(atl_mr_t* mr) = 0;
 
+    /* drops cached registrations which overlap with the range, e.g. before the memory is freed */
+    virtual atl_status_t mr_cache_invalidate(const void* buf, size_t len) {
+        return ATL_STATUS_SUCCESS;
+    }
+
     virtual atl_status_t send(atl_ep_t& ep,
                               const void* buf,
                               size_t len,
@@ -179,8 +184,26 @@ public:
 
     virtual atl_status_t poll(atl_ep_t& ep) = 0;
 
+    /*
+       file descriptors which become readable when completions arrive on ep,
+       transports without wait objects return ATL_STATUS_UNSUPPORTED
+    */
+    virtual atl_status_t get_wait_fds(atl_ep_t& ep, std::vector<int>& fds) {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    /* returns ATL_STATUS_AGAIN if completions are pending and blocking on wait fds is not safe */
+    virtual atl_status_t try_wait(atl_ep_t& ep) {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
     virtual atl_status_t check(atl_ep_t& ep, atl_req_t& req) = 0;
 
+    /* marks request as completed for operations which comm layer builds on top of send/recv */
+    virtual void set_req_completed(atl_req_t& req) {
+        CCL_THROW("set_req_completed is not supported by transport");
+    }
+
     virtual atl_proc_coord_t create_proc_coord(atl_ep_t& ep) = 0;
 
     virtual void comms_free(std::vector<atl_ep_t>& eps) = 0;
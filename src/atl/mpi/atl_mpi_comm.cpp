@@ -66,8 +66,9 @@ atl_mpi_comm::atl_mpi_comm(atl_mpi_comm* parent, int color, int key) {
 
     atl_mpi_ep_t* mpi_ep = ((atl_mpi_ep_t*)eps[0].internal);
 
-    rank2rank_map.resize(size);
-    MPI_Allgather(&parent_rank, 1, MPI_INT, rank2rank_map.data(), 1, MPI_INT, mpi_ep->mpi_comm);
+    std::vector<int> parent_ranks(size);
+    MPI_Allgather(&parent_rank, 1, MPI_INT, parent_ranks.data(), 1, MPI_INT, mpi_ep->mpi_comm);
+    rank2rank_map = ccl_rank_map(parent_ranks);
 }
 
 void atl_mpi_comm::update_eps() {
@@ -123,10 +124,7 @@ atl_status_t atl_mpi_comm::init_transport(bool is_new,
         parent_rank = rank = coord.global_idx;
         parent_size = size = coord.global_count;
 
-        rank2rank_map.resize(size);
-        for (int i = 0; i < size; i++) {
-            rank2rank_map[i] = i;
-        }
+        rank2rank_map = ccl_rank_map::identity(size);
     }
 
     init_tag();
@@ -352,6 +352,11 @@ atl_status_t atl_ofi::mr_dereg(atl_mr_t* mr) {
     return ATL_OFI_RET(ret);
 }
 
+atl_status_t atl_ofi::mr_cache_invalidate(const void* buf, size_t len) {
+    cache.invalidate(buf, len);
+    return ATL_STATUS_SUCCESS;
+}
+
 atl_status_t atl_ofi::send(atl_ep_t& ep,
                            const void* buf,
                            size_t len,
@@ -665,6 +670,44 @@ atl_status_t atl_ofi::poll(atl_ep_t& ep) {
     return ATL_STATUS_SUCCESS;
 }
 
+atl_status_t atl_ofi::get_wait_fds(atl_ep_t& ep, std::vector<int>& fds) {
+    atl_ofi_ep_t* ofi_ep = ((atl_ofi_ep_t*)ep.internal);
+
+    fds.clear();
+    for (size_t idx = 0; idx < ofi_ep->active_prov_count; idx++) {
+        atl_ofi_prov_ep_t* prov_ep = &(ctx.provs[ofi_ep->active_prov_idxs[idx]].eps[ep.idx]);
+        /* blocking is possible only if every active provider can wake us up */
+        if (prov_ep->wait_fd < 0) {
+            fds.clear();
+            return ATL_STATUS_UNSUPPORTED;
+        }
+        fds.push_back(prov_ep->wait_fd);
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_ofi::try_wait(atl_ep_t& ep) {
+    atl_ofi_ep_t* ofi_ep = ((atl_ofi_ep_t*)ep.internal);
+
+    for (size_t idx = 0; idx < ofi_ep->active_prov_count; idx++) {
+        atl_ofi_prov_t* prov = &(ctx.provs[ofi_ep->active_prov_idxs[idx]]);
+        atl_ofi_prov_ep_t* prov_ep = &(prov->eps[ep.idx]);
+        struct fid* fids[1] = { &prov_ep->cq->fid };
+
+        int ret = fi_trywait(prov->fabric, fids, 1);
+        if (ret == -FI_EAGAIN) {
+            return ATL_STATUS_AGAIN;
+        }
+        else if (ret != FI_SUCCESS) {
+            LOG_DEBUG("fi_trywait failed, prov ", prov->idx, ", ret ", ret);
+            return ATL_STATUS_FAILURE;
+        }
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
 atl_status_t atl_ofi::check(atl_ep_t& ep, atl_req_t& req) {
     atl_status_t status;
     atl_ofi_req_t* ofi_req;
@@ -687,6 +730,10 @@ atl_status_t atl_ofi::check(atl_ep_t& ep, atl_req_t& req) {
     return status;
 }
 
+void atl_ofi::set_req_completed(atl_req_t& req) {
+    ((atl_ofi_req_t*)req.internal)->comp_state = ATL_OFI_COMP_COMPLETED;
+}
+
 atl_status_t atl_ofi::get_rank2proc_map(std::shared_ptr<ipmi> pmi,
                                         std::vector<int>& rank2proc_map,
                                         atl_proc_coord_t coord) {
@@ -1190,7 +1237,9 @@ err:
 // cache
 
 void atl_ofi::fi_cache::clear() {
+    std::lock_guard<ccl_spinlock> lock{ guard };
     for (auto& instance : memory_regions) {
+        LOG_DEBUG("mr cache: ", instance.get_stats());
         instance.clear();
     }
 }
@@ -1213,6 +1262,7 @@ void atl_ofi::fi_cache::get(atl_ep_t& ep,
     *mr = nullptr;
 #ifdef CCL_ENABLE_OFI_HMEM
     if (enable_hmem) {
+        std::lock_guard<ccl_spinlock> lock{ guard };
         memory_regions.at(ep.idx % memory_regions.size()).get(ep, prov, buf, bytes, mr);
     }
 #endif // CCL_ENABLE_OFI_HMEM
@@ -1220,24 +1270,98 @@ void atl_ofi::fi_cache::get(atl_ep_t& ep,
 
 void atl_ofi::fi_cache::push(size_t idx, fid_mr* mr) {
 #ifdef CCL_ENABLE_OFI_HMEM
-    if (mr)
+    if (mr) {
+        std::lock_guard<ccl_spinlock> lock{ guard };
         memory_regions.at(idx % memory_regions.size()).push(mr);
+    }
 #endif // CCL_ENABLE_OFI_HMEM
 }
 
+void atl_ofi::fi_cache::invalidate(const void* buf, size_t bytes) {
+    std::lock_guard<ccl_spinlock> lock{ guard };
+    for (auto& instance : memory_regions) {
+        instance.invalidate(buf, bytes);
+    }
+}
+
 atl_ofi::mr_cache::~mr_cache() {
-    if (!cache.empty()) {
-        LOG_WARN("mr cache is not empty, size: ", cache.size());
+    if (!entries.empty()) {
+        LOG_WARN("mr cache is not empty, size: ", entries.size());
         clear();
     }
 }
 
 void atl_ofi::mr_cache::clear() {
-    LOG_DEBUG("mr cache size: ", cache.size());
-    for (auto& key_value : cache) {
-        fi_close(&key_value.second->fid);
+    LOG_DEBUG("mr cache size: ", entries.size());
+    for (auto& key_value : entries) {
+        fi_close(&key_value.first->fid);
+    }
+    entries.clear();
+    intervals.clear();
+    lru.clear();
+    max_len = 0;
+}
+
+atl_ofi::mr_cache::entry* atl_ofi::mr_cache::find(fid_domain* domain,
+                                                  uintptr_t start,
+                                                  size_t len) {
+    uintptr_t end = start + len;
+
+    /* candidates start not after the requested range, walk them from the closest one */
+    auto it = intervals.upper_bound(key_t(domain, start));
+    while (it != intervals.begin()) {
+        --it;
+        if (it->first.first != domain) {
+            break;
+        }
+
+        entry* e = it->second;
+        if (e->start + max_len < end) {
+            /* remaining registrations start too early to cover the range */
+            break;
+        }
+
+        if (e->start + e->len >= end) {
+            return e;
+        }
+    }
+
+    return nullptr;
+}
+
+void atl_ofi::mr_cache::remove(entry* e) {
+    auto range = intervals.equal_range(key_t(e->domain, e->start));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == e) {
+            intervals.erase(it);
+            break;
+        }
+    }
+    lru.erase(e->lru_it);
+    e->is_cached = false;
+}
+
+void atl_ofi::mr_cache::release(entry* e) {
+    CCL_THROW_IF_NOT(!e->is_cached && !e->ref_count);
+    fi_close(&e->mr->fid);
+    entries.erase(e->mr);
+}
+
+void atl_ofi::mr_cache::evict(size_t capacity) {
+    auto it = lru.end();
+    while (lru.size() > capacity && it != lru.begin()) {
+        auto cur = std::prev(it);
+        entry* e = *cur;
+        if (e->ref_count) {
+            /* used by pending operation */
+            it = cur;
+            continue;
+        }
+        LOG_DEBUG("evict from mr cache: buf: ", (void*)e->start, ", bytes: ", e->len);
+        remove(e);
+        release(e);
+        evict_count++;
     }
-    cache.clear();
 }
 
 void atl_ofi::mr_cache::get(atl_ep_t& ep,
@@ -1248,14 +1372,19 @@ void atl_ofi::mr_cache::get(atl_ep_t& ep,
     CCL_THROW_IF_NOT(prov->domain);
     CCL_THROW_IF_NOT(mr);
 
-    if (ccl::global_data::env().enable_atl_cache) {
-        key_t key(prov->domain, buf, bytes);
-        auto key_value = cache.find(key);
-        if (key_value != cache.end()) {
-            *mr = key_value->second;
+    bool use_cache = ccl::global_data::env().enable_atl_cache;
+
+    if (use_cache) {
+        entry* e = find(prov->domain, (uintptr_t)buf, bytes);
+        if (e) {
+            e->ref_count++;
+            lru.splice(lru.begin(), lru, e->lru_it);
+            hit_count++;
+            *mr = e->mr;
             LOG_DEBUG("loaded from mr cache: buf: ", buf, ", bytes: ", bytes);
             return;
         }
+        miss_count++;
     }
 
     struct fi_mr_attr mr_attr;
@@ -1264,8 +1393,11 @@ void atl_ofi::mr_cache::get(atl_ep_t& ep,
     memset(&mr_attr, 0, sizeof(mr_attr));
     memset(&iov, 0, sizeof(iov));
 
-    iov.iov_base = buf;
-    iov.iov_len = bytes;
+    /* register whole pages, so neighbour parts of the buffer hit the cache */
+    uintptr_t page_mask = CCL_REG_MSG_ALIGNMENT - 1;
+    uintptr_t reg_start = (uintptr_t)buf & ~page_mask;
+    iov.iov_base = (void*)reg_start;
+    iov.iov_len = (((uintptr_t)buf + bytes + page_mask) & ~page_mask) - reg_start;
     mr_attr.mr_iov = &iov;
     mr_attr.iov_count = 1;
     mr_attr.access = FI_SEND | FI_RECV | FI_REMOTE_READ | FI_REMOTE_WRITE;
@@ -1303,6 +1435,15 @@ void atl_ofi::mr_cache::get(atl_ep_t& ep,
         CCL_THROW_IF_NOT(dev_idx != -1);
         mr_attr.device.ze = dev_idx;
     }
+
+    if (mr_attr.iface == FI_HMEM_ZE) {
+        /* register the whole allocation, so any part of it hits the cache */
+        void* base_ptr = nullptr;
+        size_t alloc_size = 0;
+        ZE_CALL(zeMemGetAddressRange, (context, buf, &base_ptr, &alloc_size));
+        iov.iov_base = base_ptr;
+        iov.iov_len = alloc_size;
+    }
 #endif // CCL_ENABLE_OFI_HMEM
 
     int ofi_ret;
@@ -1322,20 +1463,74 @@ void atl_ofi::mr_cache::get(atl_ep_t& ep,
         fi_mr_enable(*mr);
     }
 
-    if (ccl::global_data::env().enable_atl_cache) {
-        key_t key(prov->domain, buf, bytes);
-        LOG_DEBUG("inserted to mr cache: buf: ", buf, ", bytes: ", bytes);
-        cache.insert({ std::move(key), *mr });
+    if (use_cache) {
+        std::unique_ptr<entry> e(new entry{
+            prov->domain, (uintptr_t)iov.iov_base, iov.iov_len, *mr, 1, true, lru.end() });
+        LOG_DEBUG("inserted to mr cache: buf: ", iov.iov_base, ", bytes: ", iov.iov_len);
+        lru.push_front(e.get());
+        e->lru_it = lru.begin();
+        intervals.insert({ key_t(e->domain, e->start), e.get() });
+        max_len = std::max(max_len, e->len);
+        entries.emplace(*mr, std::move(e));
+
+        size_t capacity = ccl::global_data::env().atl_cache_capacity;
+        size_t prov_capacity = prov->info->domain_attr->mr_cnt;
+        if (prov_capacity && (!capacity || prov_capacity < capacity)) {
+            capacity = prov_capacity;
+        }
+        if (capacity) {
+            evict(capacity);
+        }
     }
 }
 
 void atl_ofi::mr_cache::push(fid_mr* mr) {
     CCL_THROW_IF_NOT(mr);
-    if (ccl::global_data::env().enable_atl_cache) {
-        /* do nothing, all mem regions will be closed in clear() */
+    if (!ccl::global_data::env().enable_atl_cache) {
+        fi_close(&mr->fid);
         return;
     }
-    fi_close(&mr->fid);
+
+    auto it = entries.find(mr);
+    CCL_THROW_IF_NOT(it != entries.end(), "unknown mr in mr cache: ", mr);
+
+    entry* e = it->second.get();
+    CCL_THROW_IF_NOT(e->ref_count, "unexpected ref_count for mr ", mr);
+    e->ref_count--;
+
+    if (!e->ref_count && !e->is_cached) {
+        /* was invalidated while in use */
+        release(e);
+    }
+}
+
+void atl_ofi::mr_cache::invalidate(const void* buf, size_t bytes) {
+    uintptr_t start = (uintptr_t)buf;
+    uintptr_t end = start + bytes;
+
+    std::vector<entry*> overlapped;
+    for (const auto& key_value : intervals) {
+        entry* e = key_value.second;
+        if (e->start < end && start < e->start + e->len) {
+            overlapped.push_back(e);
+        }
+    }
+
+    for (auto e : overlapped) {
+        LOG_DEBUG("invalidate in mr cache: buf: ", (void*)e->start, ", bytes: ", e->len);
+        remove(e);
+        invalidate_count++;
+        if (!e->ref_count) {
+            release(e);
+        }
+    }
+}
+
+std::string atl_ofi::mr_cache::get_stats() const {
+    std::stringstream ss;
+    ss << "hits: " << hit_count << ", misses: " << miss_count << ", evictions: " << evict_count
+       << ", invalidations: " << invalidate_count << ", entries: " << entries.size();
+    return ss.str();
 }
 
 fi_addr_t atl_ofi::atl_ofi_get_addr(atl_ofi_prov_t* prov, int proc_idx, size_t ep_idx) {
@@ -16,7 +16,10 @@
 #pragma once
 
 #include <iostream>
+#include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "atl/atl_base_transport.hpp"
@@ -44,6 +47,8 @@ public:
 
     atl_status_t mr_dereg(atl_mr_t* mr) override;
 
+    atl_status_t mr_cache_invalidate(const void* buf, size_t len) override;
+
     atl_status_t send(atl_ep_t& ep,
                       const void* buf,
                       size_t len,
@@ -175,8 +180,14 @@ public:
 
     atl_status_t poll(atl_ep_t& ep) override;
 
+    atl_status_t get_wait_fds(atl_ep_t& ep, std::vector<int>& fds) override;
+
+    atl_status_t try_wait(atl_ep_t& ep) override;
+
     atl_status_t check(atl_ep_t& ep, atl_req_t& req) override;
 
+    void set_req_completed(atl_req_t& req) override;
+
     atl_proc_coord_t create_proc_coord(atl_ep_t& ep) override {
         return coord;
     }
@@ -237,6 +248,12 @@ private:
 
     atl_ofi_ctx_t ctx;
 
+    /*
+       registrations are kept in an interval map ordered by start address,
+       so a request is served by any registration which covers it,
+       registrations are reference counted by pending operations
+       and least recently used unreferenced ones are released on overflow
+    */
     class mr_cache {
     public:
         mr_cache() = default;
@@ -249,13 +266,40 @@ private:
         void clear();
         void get(atl_ep_t& ep, atl_ofi_prov_t* prov, void* buf, size_t bytes, fid_mr** mr);
         void push(fid_mr* mr);
+        void invalidate(const void* buf, size_t bytes);
+
+        std::string get_stats() const;
 
     private:
+        struct entry {
+            fid_domain* domain;
+            uintptr_t start;
+            size_t len;
+            fid_mr* mr;
+            size_t ref_count;
+            bool is_cached;
+            std::list<entry*>::iterator lru_it;
+        };
+
+        using key_t = std::pair<fid_domain*, uintptr_t>;
+
+        entry* find(fid_domain* domain, uintptr_t start, size_t len);
+        void remove(entry* e);
+        void release(entry* e);
+        void evict(size_t capacity);
+
         size_t mr_key = 0;
+        size_t max_len = 0;
+
+        std::multimap<key_t, entry*> intervals{};
+        /* most recently used at front */
+        std::list<entry*> lru{};
+        std::unordered_map<fid_mr*, std::unique_ptr<entry>> entries{};
 
-        using key_t = typename std::tuple<fid_domain*, void*, size_t>;
-        using value_t = fid_mr*;
-        std::unordered_multimap<key_t, value_t, ccl::utils::tuple_hash> cache{};
+        size_t hit_count = 0;
+        size_t miss_count = 0;
+        size_t evict_count = 0;
+        size_t invalidate_count = 0;
     };
 
     class fi_cache {
@@ -270,9 +314,12 @@ private:
         void init(size_t instance_count, int ctx_enable_hmem);
         void get(atl_ep_t& ep, atl_ofi_prov_t* prov, void* buf, size_t bytes, fid_mr** mr);
         void push(size_t idx, fid_mr* mr);
+        void invalidate(const void* buf, size_t bytes);
 
     private:
         int enable_hmem{ 0 };
+        /* invalidation may come from another thread */
+        ccl_spinlock guard;
         std::vector<mr_cache> memory_regions;
     };
 
@@ -19,6 +19,7 @@
 #include "atl/util/pm/pmi_resizable_rt/pmi_resizable/kvs/internal_kvs.h"
 #include "atl/util/pm/pmi_resizable_rt/pmi_resizable_simple_internal.h"
 #include "atl/ofi/atl_ofi.hpp"
+#include "atl/shm/atl_shm.hpp"
 #include "exec/exec.hpp"
 
 atl_ofi_comm::atl_ofi_comm() {
@@ -45,6 +46,88 @@ atl_ofi_comm::atl_ofi_comm(int comm_size,
     CCL_THROW_IF_NOT(init_transport(true) == ATL_STATUS_SUCCESS, "init transport failed");
 }
 
+int atl_ofi_comm::get_tag_comm_id() const {
+    return (comm_id != atl_comm_id_storage::invalid_comm_id) ? comm_id
+                                                             : atl_comm_id_storage::max_comm_id;
+}
+
+atl_status_t atl_ofi_comm::sendrecv(size_t ep_idx,
+                                    const void* send_buf,
+                                    size_t send_len,
+                                    int dst,
+                                    void* recv_buf,
+                                    size_t recv_len,
+                                    int src,
+                                    int round) {
+    int tag_comm_id = get_tag_comm_id();
+    atl_req send_req{}, recv_req{};
+    send_req.is_completed = recv_req.is_completed = true;
+    atl_status_t ret;
+
+    if (dst >= 0) {
+        send_req.is_completed = false;
+        uint64_t op_tag = tag_creator->create(rank, tag_comm_id, tag_counter, round);
+        do {
+            ret = send(ep_idx, send_buf, send_len, dst, op_tag, send_req);
+            CCL_THROW_IF_NOT(ret != ATL_STATUS_FAILURE, "send failed");
+            if (ret == ATL_STATUS_AGAIN) {
+                ccl_yield(ccl::global_data::env().yield_type);
+            }
+        } while (ret == ATL_STATUS_AGAIN);
+    }
+
+    if (src >= 0) {
+        recv_req.is_completed = false;
+        uint64_t op_tag = tag_creator->create(src, tag_comm_id, tag_counter, round);
+        do {
+            ret = recv(ep_idx, recv_buf, recv_len, src, op_tag, recv_req);
+            CCL_THROW_IF_NOT(ret != ATL_STATUS_FAILURE, "recv failed");
+            if (ret == ATL_STATUS_AGAIN) {
+                ccl_yield(ccl::global_data::env().yield_type);
+            }
+        } while (ret == ATL_STATUS_AGAIN);
+    }
+
+    while (!send_req.is_completed || !recv_req.is_completed) {
+        poll(ep_idx);
+        if (!send_req.is_completed) {
+            CCL_THROW_IF_NOT(check(ep_idx, send_req) != ATL_STATUS_FAILURE, "check send failed");
+        }
+        if (!recv_req.is_completed) {
+            CCL_THROW_IF_NOT(check(ep_idx, recv_req) != ATL_STATUS_FAILURE, "check recv failed");
+        }
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+void atl_ofi_comm::complete_op(atl_req_t& req) {
+    // to let user complete this operation through wait(req)
+    req.is_completed = false;
+    transport->set_req_completed(req);
+
+    tag_counter++;
+}
+
+atl_status_t atl_ofi_comm::allgather(size_t ep_idx,
+                                     const void* send_buf,
+                                     void* recv_buf,
+                                     size_t len,
+                                     atl_req_t& req) {
+    std::vector<size_t> recv_lens(size, len);
+    std::vector<size_t> offsets(size);
+    for (int i = 0; i < size; i++) {
+        offsets[i] = i * len;
+    }
+    return allgatherv(ep_idx, send_buf, len, recv_buf, recv_lens.data(), offsets.data(), req);
+}
+
+/*
+   Bruck allgather: ceil(log2(size)) rounds, in round with distance d
+   every rank sends blocks which it already has to rank - d and receives
+   the same number of blocks from rank + d. Blocks are kept in rank order
+   rotated by own rank, so the sent blocks are always a prefix of the buffer.
+*/
 atl_status_t atl_ofi_comm::allgatherv(size_t ep_idx,
                                       const void* send_buf,
                                       size_t send_len,
@@ -52,13 +135,6 @@ atl_status_t atl_ofi_comm::allgatherv(size_t ep_idx,
                                       const size_t* recv_lens,
                                       const size_t* offsets,
                                       atl_req_t& req) {
-    std::vector<atl_req> send_reqs(size - 1);
-    std::vector<atl_req> recv_reqs(size - 1);
-
-    int tag_comm_id = (comm_id != atl_comm_id_storage::invalid_comm_id)
-                          ? comm_id
-                          : atl_comm_id_storage::max_comm_id;
-
     LOG_DEBUG("ofi_allgatherv: comm_rank: ",
               rank,
               ", comm_size: ",
@@ -68,87 +144,200 @@ atl_status_t atl_ofi_comm::allgatherv(size_t ep_idx,
               ", comm_id: ",
               comm_id,
               ", tag_comm_id: ",
-              tag_comm_id,
+              get_tag_comm_id(),
               ", tag_counter: ",
               tag_counter);
 
-    for (int peer = 0, req_idx = 0; peer < size; peer++) {
-        if (peer == rank)
+    CCL_THROW_IF_NOT(send_len == recv_lens[rank],
+                     "unexpected send_len ",
+                     send_len,
+                     ", expected ",
+                     recv_lens[rank]);
+
+    // block_offsets[i] is the offset of block of rank (rank + i) % size
+    std::vector<size_t> block_offsets(size + 1, 0);
+    for (int i = 0; i < size; i++) {
+        block_offsets[i + 1] = block_offsets[i] + recv_lens[(rank + i) % size];
+    }
+
+    std::vector<char> tmp_buf(block_offsets[size]);
+    memcpy(tmp_buf.data(), send_buf, send_len);
+
+    for (int dist = 1, round = 0; dist < size; dist *= 2, round++) {
+        int count = std::min(dist, size - dist);
+        size_t send_bytes = block_offsets[count];
+        size_t recv_bytes = block_offsets[dist + count] - block_offsets[dist];
+
+        // both peers know all lengths, so empty exchanges are skipped consistently
+        if (!send_bytes && !recv_bytes) {
             continue;
+        }
 
-        uint64_t op_tag = tag_creator->create(rank, tag_comm_id, tag_counter);
-        // LOG_DEBUG("ofi_allgatherv: send: rank: ", rank,
-        //     ", peer: ", peer,
-        //     ", comm_id: ", comm_id,
-        //     ", tag_comm_id: ", tag_comm_id,
-        //     ", tag_counter: ", tag_counter,
-        //     ", op_tag: ", op_tag);
+        ATL_CHECK_STATUS(sendrecv(ep_idx,
+                                  tmp_buf.data(),
+                                  send_bytes,
+                                  (send_bytes) ? (rank - dist + size) % size : -1,
+                                  tmp_buf.data() + block_offsets[dist],
+                                  recv_bytes,
+                                  (recv_bytes) ? (rank + dist) % size : -1,
+                                  round),
+                         "allgatherv round failed");
+    }
 
-        atl_status_t ret;
+    for (int i = 0; i < size; i++) {
+        int peer = (rank + i) % size;
+        memcpy((char*)recv_buf + offsets[peer], tmp_buf.data() + block_offsets[i], recv_lens[peer]);
+    }
 
-        do {
-            ret = send(ep_idx, send_buf, send_len, peer, op_tag, send_reqs[req_idx]);
-            CCL_THROW_IF_NOT(ret != ATL_STATUS_FAILURE, "send failed");
-            if (ret == ATL_STATUS_AGAIN) {
-                ccl_yield(ccl::global_data::env().yield_type);
-            }
-        } while (ret == ATL_STATUS_AGAIN);
+    complete_op(req);
 
-        op_tag = tag_creator->create(peer, tag_comm_id, tag_counter);
-        // LOG_DEBUG("ofi_allgatherv: recv: rank: ", rank,
-        //     ", peer: ", peer,
-        //     ", comm_id: ", comm_id,
-        //     ", tag_comm_id: ", tag_comm_id,
-        //     ", tag_counter: ", tag_counter,
-        //     ", op_tag: ", op_tag);
+    return ATL_STATUS_SUCCESS;
+}
 
-        do {
-            ret = recv(ep_idx,
-                       (char*)recv_buf + offsets[peer],
-                       recv_lens[peer],
-                       peer,
-                       op_tag,
-                       recv_reqs[req_idx]);
-            CCL_THROW_IF_NOT(ret != ATL_STATUS_FAILURE, "recv failed");
-            if (ret == ATL_STATUS_AGAIN) {
-                ccl_yield(ccl::global_data::env().yield_type);
-            }
-        } while (ret == ATL_STATUS_AGAIN);
+namespace {
+
+template <class T>
+void ofi_comm_reduce(void* inout_buf, const void* in_buf, size_t count, atl_reduction_t op) {
+    T* inout = static_cast<T*>(inout_buf);
+    const T* in = static_cast<const T*>(in_buf);
+    for (size_t i = 0; i < count; i++) {
+        switch (op) {
+            case ATL_REDUCTION_SUM: inout[i] = inout[i] + in[i]; break;
+            case ATL_REDUCTION_PROD: inout[i] = inout[i] * in[i]; break;
+            case ATL_REDUCTION_MIN: inout[i] = std::min(inout[i], in[i]); break;
+            case ATL_REDUCTION_MAX: inout[i] = std::max(inout[i], in[i]); break;
+            default: CCL_FATAL("unexpected reduction ", op);
+        }
+    }
+}
 
-        req_idx++;
+size_t ofi_comm_get_dtype_size(atl_datatype_t dtype) {
+    switch (dtype) {
+        case ATL_DTYPE_INT32:
+        case ATL_DTYPE_UINT32:
+        case ATL_DTYPE_FLOAT32: return 4;
+        case ATL_DTYPE_INT64:
+        case ATL_DTYPE_UINT64:
+        case ATL_DTYPE_FLOAT64: return 8;
+        default: return 0;
     }
+}
 
-    if ((char*)recv_buf + offsets[rank] != send_buf) {
-        memcpy((char*)recv_buf + offsets[rank], send_buf, recv_lens[rank]);
+void ofi_comm_reduce(void* inout_buf,
+                     const void* in_buf,
+                     size_t count,
+                     atl_datatype_t dtype,
+                     atl_reduction_t op) {
+    switch (dtype) {
+        case ATL_DTYPE_INT32: ofi_comm_reduce<int32_t>(inout_buf, in_buf, count, op); break;
+        case ATL_DTYPE_UINT32: ofi_comm_reduce<uint32_t>(inout_buf, in_buf, count, op); break;
+        case ATL_DTYPE_INT64: ofi_comm_reduce<int64_t>(inout_buf, in_buf, count, op); break;
+        case ATL_DTYPE_UINT64: ofi_comm_reduce<uint64_t>(inout_buf, in_buf, count, op); break;
+        case ATL_DTYPE_FLOAT32: ofi_comm_reduce<float>(inout_buf, in_buf, count, op); break;
+        case ATL_DTYPE_FLOAT64: ofi_comm_reduce<double>(inout_buf, in_buf, count, op); break;
+        default: CCL_FATAL("unexpected dtype ", dtype);
     }
+}
 
-    bool is_completed = false;
-    while (!is_completed) {
-        is_completed = true;
-        poll(ep_idx);
-        for (size_t i = 0; i < send_reqs.size(); i++) {
-            if (!send_reqs[i].is_completed) {
-                CCL_THROW_IF_NOT(check(ep_idx, send_reqs[i]) != ATL_STATUS_FAILURE,
-                                 "check send failed");
-                is_completed = false;
-                break;
-            }
-            if (!recv_reqs[i].is_completed) {
-                CCL_THROW_IF_NOT(check(ep_idx, recv_reqs[i]) != ATL_STATUS_FAILURE,
-                                 "check recv failed");
-                is_completed = false;
-                break;
-            }
+} // namespace
+
+/*
+   recursive doubling allreduce for small bootstrap data,
+   ranks above the largest power of two are folded into their neighbours
+*/
+atl_status_t atl_ofi_comm::allreduce(size_t ep_idx,
+                                     const void* send_buf,
+                                     void* recv_buf,
+                                     size_t len,
+                                     atl_datatype_t dtype,
+                                     atl_reduction_t op,
+                                     atl_req_t& req) {
+    size_t dtype_size = ofi_comm_get_dtype_size(dtype);
+    if (!dtype_size || op == ATL_REDUCTION_CUSTOM || len % dtype_size) {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    size_t count = len / dtype_size;
+
+    if (send_buf != recv_buf) {
+        memcpy(recv_buf, send_buf, len);
+    }
+
+    std::vector<char> tmp_buf(len);
+
+    int pof2 = static_cast<int>(ccl::utils::pof2(size));
+    int rem = size - pof2;
+    int new_rank = rank - rem;
+    int round = 0;
+
+    // round ids are part of tags, so folded ranks have to skip the same number of rounds
+    int unfold_round = 1;
+    for (int mask = 1; mask < pof2; mask <<= 1) {
+        unfold_round++;
+    }
+
+    if (rank < 2 * rem) {
+        if (rank % 2 == 0) {
+            ATL_CHECK_STATUS(sendrecv(ep_idx, recv_buf, len, rank + 1, nullptr, 0, -1, round),
+                             "allreduce fold failed");
+            new_rank = -1;
+        }
+        else {
+            ATL_CHECK_STATUS(
+                sendrecv(ep_idx, nullptr, 0, -1, tmp_buf.data(), len, rank - 1, round),
+                "allreduce fold failed");
+            ofi_comm_reduce(recv_buf, tmp_buf.data(), count, dtype, op);
+            new_rank = rank / 2;
+        }
+    }
+    round++;
+
+    if (new_rank != -1) {
+        for (int mask = 1; mask < pof2; mask <<= 1, round++) {
+            int new_peer = new_rank ^ mask;
+            int peer = (new_peer < rem) ? new_peer * 2 + 1 : new_peer + rem;
+            ATL_CHECK_STATUS(
+                sendrecv(ep_idx, recv_buf, len, peer, tmp_buf.data(), len, peer, round),
+                "allreduce round failed");
+            // operands are commutative, so both peers get bitwise equal results
+            ofi_comm_reduce(recv_buf, tmp_buf.data(), count, dtype, op);
         }
     }
+    round = unfold_round;
 
-    // to let user complete this operation through wait(req)
-    req.is_completed = false;
+    if (rank < 2 * rem) {
+        if (rank % 2) {
+            ATL_CHECK_STATUS(sendrecv(ep_idx, recv_buf, len, rank - 1, nullptr, 0, -1, round),
+                             "allreduce unfold failed");
+        }
+        else {
+            ATL_CHECK_STATUS(sendrecv(ep_idx, nullptr, 0, -1, recv_buf, len, rank + 1, round),
+                             "allreduce unfold failed");
+        }
+    }
 
-    atl_ofi_req_t* ofi_req = ((atl_ofi_req_t*)req.internal);
-    ofi_req->comp_state = ATL_OFI_COMP_COMPLETED;
+    complete_op(req);
 
-    tag_counter++;
+    return ATL_STATUS_SUCCESS;
+}
+
+/* dissemination barrier: ceil(log2(size)) rounds of token exchange */
+atl_status_t atl_ofi_comm::barrier(size_t ep_idx, atl_req_t& req) {
+    char send_token = 0, recv_token = 0;
+
+    for (int dist = 1, round = 0; dist < size; dist *= 2, round++) {
+        ATL_CHECK_STATUS(sendrecv(ep_idx,
+                                  &send_token,
+                                  sizeof(send_token),
+                                  (rank + dist) % size,
+                                  &recv_token,
+                                  sizeof(recv_token),
+                                  (rank - dist + size) % size,
+                                  round),
+                         "barrier round failed");
+    }
+
+    complete_op(req);
 
     return ATL_STATUS_SUCCESS;
 }
@@ -218,9 +407,9 @@ atl_ofi_comm::atl_ofi_comm(atl_ofi_comm* parent, int color) {
               ", ",
               to_string(coord),
               ", rank2proc_map: ",
-              ccl::utils::vec_to_string(rank2proc_map),
+              rank2proc_map.to_string(),
               ", parent rank2proc_map: ",
-              ccl::utils::vec_to_string(parent->rank2proc_map));
+              parent->rank2proc_map.to_string());
 
     coord.validate(rank, size);
 
@@ -236,7 +425,13 @@ atl_status_t atl_ofi_comm::init_transport(bool is_new) {
         {
             std::lock_guard<std::mutex> lock(memory_mutex);
             if (!transport) {
-                transport = new atl_ofi();
+                /* single-host jobs may use native shm transport with the same pmi bootstrap */
+                if (ccl::global_data::env().atl_transport == ccl_atl_shm) {
+                    transport = new atl_shm();
+                }
+                else {
+                    transport = new atl_ofi();
+                }
             }
             if (!transport->is_inited()) {
                 CCL_THROW_IF_NOT(
@@ -257,11 +452,10 @@ atl_status_t atl_ofi_comm::init_transport(bool is_new) {
         coord = transport->get_proc_coord();
         coord.validate(rank, size);
 
-        transport->get_rank2proc_map(pmi, rank2proc_map, coord);
-        rank2rank_map.resize(size);
-        for (int i = 0; i < size; i++) {
-            rank2rank_map[i] = i;
-        }
+        std::vector<int> proc_map;
+        transport->get_rank2proc_map(pmi, proc_map, coord);
+        rank2proc_map = ccl_rank_map(proc_map);
+        rank2rank_map = ccl_rank_map::identity(size);
     }
 
     init_tag();
@@ -53,7 +53,10 @@ public:
                       int dst_proc_idx,
                       uint64_t tag,
                       atl_req_t& req) override {
-        return transport->send(eps[ep_idx], buf, len, rank2proc_map[dst_proc_idx], tag, req);
+        atl_status_t ret =
+            transport->send(eps[ep_idx], buf, len, rank2proc_map[dst_proc_idx], tag, req);
+        trace_post("atl_send", req, len, ret);
+        return ret;
     }
 
     atl_status_t recv(size_t ep_idx,
@@ -62,7 +65,10 @@ public:
                       int src_proc_idx,
                       uint64_t tag,
                       atl_req_t& req) override {
-        return transport->recv(eps[ep_idx], buf, len, rank2proc_map[src_proc_idx], tag, req);
+        atl_status_t ret =
+            transport->recv(eps[ep_idx], buf, len, rank2proc_map[src_proc_idx], tag, req);
+        trace_post("atl_recv", req, len, ret);
+        return ret;
     }
 
     atl_status_t probe(size_t ep_idx,
@@ -77,9 +83,7 @@ public:
                            const void* send_buf,
                            void* recv_buf,
                            size_t len,
-                           atl_req_t& req) override {
-        return ATL_STATUS_UNSUPPORTED;
-    }
+                           atl_req_t& req) override;
 
     atl_status_t allgatherv(size_t ep_idx,
                             const void* send_buf,
@@ -95,9 +99,7 @@ public:
                            size_t len,
                            atl_datatype_t dtype,
                            atl_reduction_t op,
-                           atl_req_t& req) override {
-        return ATL_STATUS_UNSUPPORTED;
-    }
+                           atl_req_t& req) override;
 
     atl_status_t alltoall(size_t ep_idx,
                           const void* send_buf,
@@ -118,9 +120,7 @@ public:
         return ATL_STATUS_UNSUPPORTED;
     }
 
-    atl_status_t barrier(size_t ep_idx, atl_req_t& req) override {
-        return ATL_STATUS_UNSUPPORTED;
-    }
+    atl_status_t barrier(size_t ep_idx, atl_req_t& req) override;
 
     atl_status_t bcast(size_t ep_idx, void* buf, size_t len, int root, atl_req_t& req) override {
         return ATL_STATUS_UNSUPPORTED;
@@ -186,5 +186,18 @@ private:
     atl_ofi_comm(atl_ofi_comm* parent, int color);
     atl_status_t init_transport(bool is_new);
 
+    // blocking point-to-point step of bootstrap collectives,
+    // negative dst/src skips the corresponding direction
+    int get_tag_comm_id() const;
+    atl_status_t sendrecv(size_t ep_idx,
+                          const void* send_buf,
+                          size_t send_len,
+                          int dst,
+                          void* recv_buf,
+                          size_t recv_len,
+                          int src,
+                          int round);
+    void complete_op(atl_req_t& req);
+
     uint64_t tag_counter = 0;
 };
@@ -202,15 +202,16 @@ atl_status_t atl_ofi_get_local_proc_coord(atl_proc_coord_t& coord, std::shared_p
 
         ATL_CHECK_STATUS(pmi->pmrt_barrier(), "barrier failed");
 
+        std::vector<int> proc_idxs(coord.global_count);
         for (i = 0; i < coord.global_count; i++) {
-            ret = pmi->pmrt_kvs_get((char*)ATL_OFI_HOSTNAME_PM_KEY,
-                                    i * ATL_OFI_PMI_PROC_MULTIPLIER,
-                                    all_hostnames + i * ATL_MAX_HOSTNAME_LEN,
-                                    ATL_MAX_HOSTNAME_LEN);
-            if (ret) {
-                LOG_ERROR("pmrt_kvs_get: ret: ", ret);
-                goto fn_err;
-            }
+            proc_idxs[i] = i * ATL_OFI_PMI_PROC_MULTIPLIER;
+        }
+
+        ret = pmi->pmrt_kvs_get_batch(
+            (char*)ATL_OFI_HOSTNAME_PM_KEY, proc_idxs, all_hostnames, ATL_MAX_HOSTNAME_LEN);
+        if (ret) {
+            LOG_ERROR("pmrt_kvs_get_batch: ret: ", ret);
+            goto fn_err;
         }
     }
     else {
@@ -404,6 +405,10 @@ atl_status_t atl_ofi_prov_update_addr_table(atl_ofi_ctx_t& ctx,
 
         /* variable initialization must happen before the first *goto* statement */
         std::vector<char> ret_ep_name(addr_len, '\0');
+        size_t batch_val_len = prov->is_shm ? FI_NAME_MAX : addr_len;
+        std::vector<int> batch_keys;
+        std::vector<char> batch_ep_names;
+        size_t batch_idx = 0;
 
         if (ccl::global_data::env().kvs_init_mode != ccl::kvs_mode::pmix_ofi) {
             if (pmi->pmrt_barrier() != ATL_STATUS_SUCCESS) {
@@ -411,6 +416,27 @@ atl_status_t atl_ofi_prov_update_addr_table(atl_ofi_ctx_t& ctx,
                 ret = ATL_STATUS_FAILURE;
                 goto err_ep_names;
             }
+
+            /* fetch all names in one request instead of a round trip per name */
+            for (i = 0; i < coord.global_count; i++) {
+                if (prov->is_shm && coord.global2local_map[i] == -1) {
+                    continue;
+                }
+                for (j = 0; j < named_ep_count; j++) {
+                    batch_keys.push_back(i * ATL_OFI_PMI_PROC_MULTIPLIER +
+                                         prov_idx * ATL_OFI_PMI_PROV_MULTIPLIER + j);
+                }
+            }
+            batch_ep_names.resize(batch_keys.size() * batch_val_len, '\0');
+
+            ret = pmi->pmrt_kvs_get_batch((char*)ATL_OFI_FI_ADDR_PM_KEY,
+                                          batch_keys,
+                                          (void*)batch_ep_names.data(),
+                                          batch_val_len);
+            if (ret) {
+                LOG_ERROR("pmrt_kvs_get_batch failed: ret: ", ret);
+                goto err_ep_names;
+            }
         }
 
         next_ep_name = ep_names_table;
@@ -456,10 +482,12 @@ atl_status_t atl_ofi_prov_update_addr_table(atl_ofi_ctx_t& ctx,
                     }
                 }
                 else {
-                    ret = pmi->pmrt_kvs_get((char*)ATL_OFI_FI_ADDR_PM_KEY,
-                                            key,
-                                            (void*)ret_ep_name.data(),
-                                            ret_ep_name.size());
+                    CCL_THROW_IF_NOT(batch_idx < batch_keys.size() && batch_keys[batch_idx] == key,
+                                     "unexpected ep name key ",
+                                     key);
+                    ret_ep_name.assign(batch_ep_names.data() + batch_idx * batch_val_len,
+                                       batch_ep_names.data() + (batch_idx + 1) * batch_val_len);
+                    batch_idx++;
 
                     if (prov->is_shm) {
                         size_t original_size = ret_ep_name.size();
@@ -772,6 +800,7 @@ void atl_ofi_prov_ep_destroy(atl_ofi_prov_t* prov, atl_ofi_prov_ep_t* ep) {
 
     ep->rx = ep->tx = nullptr;
     ep->cq = nullptr;
+    ep->wait_fd = -1;
     ep->name.addr = nullptr;
     ep->name.len = 0;
 }
@@ -854,8 +883,30 @@ atl_status_t atl_ofi_prov_ep_init(atl_ofi_prov_t* prov, size_t ep_idx) {
     memset(&cq_attr, 0, sizeof(cq_attr));
     cq_attr.format = FI_CQ_FORMAT_TAGGED;
 
-    ATL_OFI_CALL(
-        fi_cq_open(prov->domain, &cq_attr, &ep->cq, nullptr), ret, return ATL_STATUS_FAILURE);
+    ep->wait_fd = -1;
+
+    /* worker may block on CQ events instead of busy polling */
+    if (ccl::global_data::env().worker_hybrid_wait) {
+        cq_attr.wait_obj = FI_WAIT_FD;
+        ret = fi_cq_open(prov->domain, &cq_attr, &ep->cq, nullptr);
+        if (ret == FI_SUCCESS) {
+            ret = fi_control(&ep->cq->fid, FI_GETWAIT, (void*)&ep->wait_fd);
+            if (ret != FI_SUCCESS) {
+                LOG_DEBUG("can't get CQ wait fd, prov ", prov->idx, ", ret ", ret);
+                ep->wait_fd = -1;
+            }
+        }
+        else {
+            LOG_DEBUG("can't open CQ with wait fd, prov ", prov->idx, ", ret ", ret);
+            ep->cq = nullptr;
+            cq_attr.wait_obj = FI_WAIT_NONE;
+        }
+    }
+
+    if (!ep->cq) {
+        ATL_OFI_CALL(
+            fi_cq_open(prov->domain, &cq_attr, &ep->cq, nullptr), ret, return ATL_STATUS_FAILURE);
+    }
 
     if (prov->sep) {
         rx_attr = *prov->info->rx_attr;
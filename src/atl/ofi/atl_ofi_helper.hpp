@@ -168,6 +168,8 @@ typedef struct {
     struct fid_ep* tx;
     struct fid_ep* rx;
     struct fid_cq* cq;
+    /* fd of CQ wait object, -1 if CQ is opened without wait object */
+    int wait_fd;
     atl_ofi_prov_ep_name_t name;
 } atl_ofi_prov_ep_t;
 
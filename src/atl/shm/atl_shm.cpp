@@ -0,0 +1,692 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "atl/ofi/atl_ofi_helper.hpp"
+#include "atl/shm/atl_shm.hpp"
+#include "common/global/global.hpp"
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "ring indices have to be lock-free across processes");
+
+atl_shm::~atl_shm() {
+    if (!is_finalized) {
+        finalize();
+    }
+}
+
+atl_status_t atl_shm::init(int* argc,
+                           char*** argv,
+                           atl_attr_t* attr,
+                           const char* main_addr,
+                           std::shared_ptr<ipmi> pmi) {
+    CCL_THROW_IF_NOT(!inited, "atl_shm reinit is not expected");
+    inited = true;
+
+    CCL_THROW_IF_NOT((sizeof(atl_shm_req_t) <= sizeof(atl_req_t) - offsetof(atl_req_t, internal)),
+                     "unexpected offset: atl_shm_request size ",
+                     sizeof(atl_shm_req_t),
+                     ", atl_request size ",
+                     sizeof(atl_req_t),
+                     ", expected offset ",
+                     offsetof(atl_req_t, internal));
+
+    if (!pmi) {
+        LOG_ERROR("pmi is null");
+        return ATL_STATUS_FAILURE;
+    }
+
+    coord.global_count = pmi->get_size();
+    coord.global_idx = pmi->get_rank();
+
+    ccl_logger::set_global_idx(coord.global_idx);
+
+    ATL_CHECK_STATUS(atl_ofi_get_local_proc_coord(coord, pmi),
+                     "atl_ofi_get_local_proc_coord error");
+
+    LOG_INFO(::to_string(coord));
+    coord.validate();
+
+    if (coord.local_count != coord.global_count) {
+        LOG_ERROR("atl_shm requires all processes on a single host, local_count ",
+                  coord.local_count,
+                  ", global_count ",
+                  coord.global_count);
+        return ATL_STATUS_FAILURE;
+    }
+
+    for (size_t ep_idx = 0; ep_idx < attr->in.ep_count; ep_idx++) {
+        atl_ep_t ep;
+        ep.idx = ep_idx;
+        eps.push_back(ep);
+
+        std::unique_ptr<ep_ctx> ctx(new ep_ctx());
+        ctx->send_queues.resize(coord.global_count);
+        ctx->ack_queues.resize(coord.global_count);
+        ctx->recv_states.resize(coord.global_count, recv_state{ nullptr, nullptr });
+        ep_ctxs.push_back(std::move(ctx));
+    }
+
+    ATL_CHECK_STATUS(create_segment(pmi), "failed to create shm segment");
+
+    /* report actual attributes back to upper level */
+    attr->out.enable_shm = 1;
+    attr->out.enable_rma = 0;
+    attr->out.enable_hmem = 0;
+    attr->out.mnic_type = ATL_MNIC_NONE;
+    attr->out.mnic_count = 1;
+    attr->out.tag_bits = 64;
+    attr->out.max_tag = 0xFFFFFFFFFFFFFFFF;
+    attr->out.max_order_waw_size = 0;
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::create_segment(std::shared_ptr<ipmi> pmi) {
+    char name[ATL_SHM_SEGMENT_NAME_LEN] = { 0 };
+    int proc_count = coord.global_count;
+    int proc_idx = coord.global_idx;
+    size_t ep_count = eps.size();
+    int fd = -1;
+
+    size_t rings_offset =
+        sizeof(atl_shm_segment_hdr_t) + proc_count * sizeof(atl_shm_proc_info_t);
+    rings_offset = (rings_offset + CACHELINE_SIZE - 1) / CACHELINE_SIZE * CACHELINE_SIZE;
+    cell_count = ccl::global_data::env().atl_shm_ring_cells;
+    ring_size = sizeof(atl_shm_ring_t) + cell_count * sizeof(atl_shm_cell_t);
+    segment_size = rings_offset + ep_count * proc_count * proc_count * ring_size;
+
+    if (proc_idx == 0) {
+        auto timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        snprintf(name,
+                 ATL_SHM_SEGMENT_NAME_LEN,
+                 "/ccl-atl-shm-%d-%llx",
+                 getpid(),
+                 (unsigned long long)timestamp);
+
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            LOG_ERROR("shm_open ", name, " failed, errno: ", strerror(errno));
+            return ATL_STATUS_FAILURE;
+        }
+
+        /* pages are zero-filled, so rings start empty */
+        if (ftruncate(fd, segment_size)) {
+            LOG_ERROR("ftruncate ", name, " to ", segment_size, " failed, errno: ", strerror(errno));
+            close(fd);
+            shm_unlink(name);
+            return ATL_STATUS_FAILURE;
+        }
+    }
+
+    if (proc_idx == 0) {
+        ATL_CHECK_STATUS(pmi->pmrt_kvs_put((char*)ATL_SHM_SEGMENT_PM_KEY, 0, name, sizeof(name)),
+                         "pmrt_kvs_put failed");
+    }
+
+    ATL_CHECK_STATUS(pmi->pmrt_barrier(), "barrier failed");
+
+    if (proc_idx != 0) {
+        ATL_CHECK_STATUS(pmi->pmrt_kvs_get((char*)ATL_SHM_SEGMENT_PM_KEY, 0, name, sizeof(name)),
+                         "pmrt_kvs_get failed");
+        fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) {
+            LOG_ERROR("shm_open ", name, " failed, errno: ", strerror(errno));
+            return ATL_STATUS_FAILURE;
+        }
+    }
+
+    segment_name = name;
+    segment = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (segment == MAP_FAILED) {
+        LOG_ERROR("mmap ", name, " failed, errno: ", strerror(errno));
+        segment = nullptr;
+        if (proc_idx == 0) {
+            shm_unlink(name);
+        }
+        return ATL_STATUS_FAILURE;
+    }
+
+    segment_hdr = static_cast<atl_shm_segment_hdr_t*>(segment);
+    proc_infos = reinterpret_cast<atl_shm_proc_info_t*>(segment_hdr + 1);
+    rings = static_cast<char*>(segment) + rings_offset;
+
+    if (proc_idx == 0) {
+        segment_hdr->proc_count = proc_count;
+        segment_hdr->ep_count = ep_count;
+        segment_hdr->cell_count = cell_count;
+        segment_hdr->magic = ATL_SHM_SEGMENT_MAGIC;
+    }
+
+    proc_infos[proc_idx].pid = getpid();
+
+    ATL_CHECK_STATUS(check_cma(pmi), "failed to check cma");
+
+    CCL_THROW_IF_NOT(segment_hdr->magic == ATL_SHM_SEGMENT_MAGIC &&
+                         segment_hdr->proc_count == proc_count &&
+                         segment_hdr->ep_count == (int)ep_count &&
+                         segment_hdr->cell_count == cell_count,
+                     "unexpected shm segment ",
+                     segment_name,
+                     ", proc_count ",
+                     segment_hdr->proc_count,
+                     ", ep_count ",
+                     segment_hdr->ep_count,
+                     ", cell_count ",
+                     segment_hdr->cell_count,
+                     ", expected cell_count ",
+                     cell_count);
+
+    /* all processes are attached, the segment lives until the last one unmaps it */
+    if (proc_idx == 0) {
+        shm_unlink(name);
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::check_cma(std::shared_ptr<ipmi> pmi) {
+    static const uint64_t cma_probe_value = ATL_SHM_SEGMENT_MAGIC;
+    int proc_idx = coord.global_idx;
+
+#ifdef PR_SET_PTRACER
+    /* let peers read our buffers when ptrace is restricted to descendants */
+    prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif // PR_SET_PTRACER
+
+    proc_infos[proc_idx].cma_probe_addr = (uint64_t)&cma_probe_value;
+
+    ATL_CHECK_STATUS(pmi->pmrt_barrier(), "barrier failed");
+
+    int peer_idx = (proc_idx + 1) % coord.global_count;
+    uint64_t value = 0;
+    struct iovec local = { &value, sizeof(value) };
+    struct iovec remote = { (void*)proc_infos[peer_idx].cma_probe_addr, sizeof(value) };
+    ssize_t ret = process_vm_readv(proc_infos[peer_idx].pid, &local, 1, &remote, 1, 0);
+    proc_infos[proc_idx].is_cma_enabled =
+        (ret == (ssize_t)sizeof(value)) && (value == ATL_SHM_SEGMENT_MAGIC);
+
+    ATL_CHECK_STATUS(pmi->pmrt_barrier(), "barrier failed");
+
+    /* the sender picks the protocol, so every receiver has to be able to read */
+    enable_cma = true;
+    for (int idx = 0; idx < coord.global_count; idx++) {
+        enable_cma = enable_cma && proc_infos[idx].is_cma_enabled;
+    }
+
+    if (!enable_cma && proc_idx == 0) {
+        LOG_INFO("cross memory attach is not available, large messages go through rings");
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_shm_ring_t* atl_shm::get_ring(size_t ep_idx, int src, int dst) {
+    size_t count = coord.global_count;
+    size_t ring_idx = (ep_idx * count + dst) * count + src;
+    return reinterpret_cast<atl_shm_ring_t*>(rings + ring_idx * ring_size);
+}
+
+atl_status_t atl_shm::mr_reg(const void* buf, size_t len, atl_mr_t** mr) {
+    atl_mr_t* shm_mr = (atl_mr_t*)calloc(1, sizeof(atl_mr_t));
+    if (!shm_mr)
+        return ATL_STATUS_FAILURE;
+
+    shm_mr->buf = (void*)buf;
+    shm_mr->len = len;
+    *mr = shm_mr;
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::mr_dereg(atl_mr_t* mr) {
+    free(mr);
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::send(atl_ep_t& ep,
+                           const void* buf,
+                           size_t len,
+                           int dst_proc_idx,
+                           uint64_t tag,
+                           atl_req_t& req) {
+    atl_shm_req_t* shm_req = ((atl_shm_req_t*)req.internal);
+    shm_req->comp_state = ATL_SHM_COMP_POSTED;
+    shm_req->peer = dst_proc_idx;
+    shm_req->tag = tag;
+    shm_req->buf = (void*)buf;
+    shm_req->len = len;
+    shm_req->offset = 0;
+    shm_req->recv_len = 0;
+    shm_req->is_rndv = enable_cma && (len >= ATL_SHM_CMA_THRESHOLD);
+
+    ep_ctx& ctx = *ep_ctxs[ep.idx];
+    ctx.send_queues[dst_proc_idx].push_back(shm_req);
+    progress_sends(ctx, ep.idx, dst_proc_idx);
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::recv(atl_ep_t& ep,
+                           void* buf,
+                           size_t len,
+                           int src_proc_idx,
+                           uint64_t tag,
+                           atl_req_t& req) {
+    atl_shm_req_t* shm_req = ((atl_shm_req_t*)req.internal);
+    shm_req->comp_state = ATL_SHM_COMP_POSTED;
+    shm_req->peer = src_proc_idx;
+    shm_req->tag = tag;
+    shm_req->buf = buf;
+    shm_req->len = len;
+    shm_req->offset = 0;
+    shm_req->recv_len = 0;
+    shm_req->is_rndv = false;
+
+    ep_ctx& ctx = *ep_ctxs[ep.idx];
+
+    auto it = std::find_if(
+        ctx.unexp_msgs.begin(), ctx.unexp_msgs.end(), [src_proc_idx, tag](const unexp_msg& msg) {
+            return (msg.src == src_proc_idx) && (msg.tag == tag);
+        });
+
+    if (it == ctx.unexp_msgs.end()) {
+        ctx.posted_recvs.push_back(shm_req);
+        return ATL_STATUS_SUCCESS;
+    }
+
+    unexp_msg& msg = *it;
+    CCL_THROW_IF_NOT(msg.len <= len,
+                     "message from ",
+                     src_proc_idx,
+                     " is truncated, len ",
+                     msg.len,
+                     ", buffer len ",
+                     len);
+    shm_req->recv_len = msg.len;
+
+    if (msg.is_rndv) {
+        read_remote(ctx, src_proc_idx, buf, msg.len, msg.addr, msg.cookie);
+        shm_req->comp_state = ATL_SHM_COMP_COMPLETED;
+    }
+    else {
+        if (msg.offset) {
+            memcpy(buf, msg.data.data(), msg.offset);
+        }
+        shm_req->offset = msg.offset;
+
+        if (shm_req->offset == shm_req->recv_len) {
+            shm_req->comp_state = ATL_SHM_COMP_COMPLETED;
+        }
+        else {
+            /* the rest of the message is still in flight, land it directly in the user buffer */
+            ctx.recv_states[src_proc_idx] = recv_state{ shm_req, nullptr };
+        }
+    }
+
+    ctx.unexp_msgs.erase(it);
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::probe(atl_ep_t& ep,
+                            int src_proc_idx,
+                            uint64_t tag,
+                            int* found,
+                            size_t* recv_len) {
+    ATL_CHECK_STATUS(progress_ep(ep), "progress_ep failed");
+
+    ep_ctx& ctx = *ep_ctxs[ep.idx];
+
+    auto it = std::find_if(
+        ctx.unexp_msgs.begin(), ctx.unexp_msgs.end(), [src_proc_idx, tag](const unexp_msg& msg) {
+            return (msg.src == src_proc_idx) && (msg.tag == tag);
+        });
+
+    if (found)
+        *found = (it != ctx.unexp_msgs.end());
+    if (recv_len)
+        *recv_len = (it != ctx.unexp_msgs.end()) ? it->len : 0;
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::wait(atl_ep_t& ep, atl_req_t& req) {
+    atl_status_t ret = ATL_STATUS_SUCCESS;
+    atl_shm_req_t* shm_req = ((atl_shm_req_t*)req.internal);
+
+    while ((shm_req->comp_state != ATL_SHM_COMP_COMPLETED) &&
+           ((ret = progress_ep(ep)) == ATL_STATUS_SUCCESS)) {
+    }
+
+    req.is_completed = 1;
+
+    return ret;
+}
+
+atl_status_t atl_shm::wait_all(atl_ep_t& ep, std::vector<atl_req_t>& reqs, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        atl_status_t ret = wait(ep, reqs[i]);
+        if (ret != ATL_STATUS_SUCCESS)
+            return ret;
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::poll(atl_ep_t& ep) {
+    return progress_ep(ep);
+}
+
+atl_status_t atl_shm::check(atl_ep_t& ep, atl_req_t& req) {
+    atl_shm_req_t* shm_req = ((atl_shm_req_t*)req.internal);
+
+    CCL_THROW_IF_NOT(!req.is_completed, "request is already completed");
+
+    req.is_completed = (shm_req->comp_state == ATL_SHM_COMP_COMPLETED);
+    if (req.is_completed) {
+        return ATL_STATUS_SUCCESS;
+    }
+
+    atl_status_t status = progress_ep(ep);
+    req.is_completed = (shm_req->comp_state == ATL_SHM_COMP_COMPLETED);
+
+    return status;
+}
+
+void atl_shm::set_req_completed(atl_req_t& req) {
+    ((atl_shm_req_t*)req.internal)->comp_state = ATL_SHM_COMP_COMPLETED;
+}
+
+atl_status_t atl_shm::get_rank2proc_map(std::shared_ptr<ipmi> pmi,
+                                        std::vector<int>& rank2proc_map,
+                                        atl_proc_coord_t coord) {
+    int pmi_rank = pmi->get_rank();
+    int pmi_size = pmi->get_size();
+    CCL_THROW_IF_NOT(rank2proc_map.empty());
+    rank2proc_map.resize(pmi_size);
+
+    if (!need_extra_exchange) {
+        for (size_t i = 0; i < rank2proc_map.size(); i++) {
+            rank2proc_map[i] = i;
+        }
+        need_extra_exchange = true;
+        return ATL_STATUS_SUCCESS;
+    }
+
+    /* processes of the new kvs are attached to the segment already, map ranks to their slots */
+    int proc_idx = this->coord.global_idx;
+    ATL_CHECK_STATUS(
+        pmi->pmrt_kvs_put((char*)ATL_SHM_PROC_IDX_PM_KEY, pmi_rank, &proc_idx, sizeof(proc_idx)),
+        "pmrt_kvs_put failed");
+
+    ATL_CHECK_STATUS(pmi->pmrt_barrier(), "barrier failed");
+
+    for (int i = 0; i < pmi_size; i++) {
+        ATL_CHECK_STATUS(pmi->pmrt_kvs_get((char*)ATL_SHM_PROC_IDX_PM_KEY,
+                                           i,
+                                           &rank2proc_map[i],
+                                           sizeof(rank2proc_map[i])),
+                         "pmrt_kvs_get failed");
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+std::string atl_shm::to_string() {
+    std::stringstream ss;
+    ss << "atl-shm:\n{\n"
+       << "  ep_count: " << eps.size() << "\n"
+       << "  segment: " << segment_name << "\n"
+       << "  segment_size: " << segment_size << "\n"
+       << "  cell_size: " << ATL_SHM_CELL_SIZE << "\n"
+       << "  cell_count: " << cell_count << "\n"
+       << "  cma: " << enable_cma << "\n"
+       << "  cma_threshold: " << ATL_SHM_CMA_THRESHOLD << "\n"
+       << "}";
+    return ss.str();
+}
+
+atl_status_t atl_shm::finalize(int global_idx) {
+    CCL_THROW_IF_NOT(!is_finalized, "atl_shm refinalize is not expected");
+    is_finalized = true;
+    inited = false;
+
+    if (coord.global_idx == 0) {
+        LOG_INFO("finalizing atl-shm");
+    }
+
+    ep_ctxs.clear();
+
+    if (segment) {
+        munmap(segment, segment_size);
+        segment = nullptr;
+        segment_hdr = nullptr;
+        proc_infos = nullptr;
+        rings = nullptr;
+    }
+
+    if (coord.global_idx == 0) {
+        LOG_INFO("finalized atl-shm");
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t atl_shm::progress_ep(atl_ep_t& ep) {
+    ep_ctx& ctx = *ep_ctxs[ep.idx];
+
+    for (int peer_idx = 0; peer_idx < coord.global_count; peer_idx++) {
+        progress_recvs(ctx, ep.idx, peer_idx);
+        progress_sends(ctx, ep.idx, peer_idx);
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+bool atl_shm::push_cell(atl_shm_ring_t* ring, const atl_shm_cell_hdr_t& hdr, const void* payload) {
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) == cell_count)
+        return false;
+
+    atl_shm_cell_t& cell = get_cell(ring, head);
+    cell.hdr = hdr;
+    if (hdr.frag_len) {
+        memcpy(cell.payload, payload, hdr.frag_len);
+    }
+
+    ring->head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+void atl_shm::progress_sends(ep_ctx& ctx, size_t ep_idx, int dst) {
+    atl_shm_ring_t* ring = get_ring(ep_idx, coord.global_idx, dst);
+
+    auto& acks = ctx.ack_queues[dst];
+    while (!acks.empty()) {
+        atl_shm_cell_hdr_t hdr{};
+        hdr.type = ATL_SHM_MSG_ACK;
+        hdr.cookie = acks.front();
+        if (!push_cell(ring, hdr, nullptr))
+            return;
+        acks.pop_front();
+    }
+
+    /* messages go one after another, so fragments of different messages never interleave */
+    auto& queue = ctx.send_queues[dst];
+    while (!queue.empty()) {
+        atl_shm_req_t* req = queue.front();
+
+        if (req->is_rndv) {
+            atl_shm_cell_hdr_t hdr{};
+            hdr.type = ATL_SHM_MSG_RNDV;
+            hdr.tag = req->tag;
+            hdr.len = req->len;
+            hdr.addr = (uint64_t)req->buf;
+            hdr.cookie = (uint64_t)req;
+            if (!push_cell(ring, hdr, nullptr))
+                return;
+            /* completed by ack once the receiver has copied the buffer */
+            queue.pop_front();
+            continue;
+        }
+
+        do {
+            atl_shm_cell_hdr_t hdr{};
+            hdr.type = (req->offset == 0) ? ATL_SHM_MSG_EAGER : ATL_SHM_MSG_FRAG;
+            hdr.tag = req->tag;
+            hdr.len = req->len;
+            hdr.frag_len = std::min(req->len - req->offset, (size_t)ATL_SHM_CELL_PAYLOAD_SIZE);
+            if (!push_cell(ring, hdr, (char*)req->buf + req->offset))
+                return;
+            req->offset += hdr.frag_len;
+        } while (req->offset < req->len);
+
+        req->comp_state = ATL_SHM_COMP_COMPLETED;
+        queue.pop_front();
+    }
+}
+
+void atl_shm::progress_recvs(ep_ctx& ctx, size_t ep_idx, int src) {
+    atl_shm_ring_t* ring = get_ring(ep_idx, src, coord.global_idx);
+
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+
+    for (; tail != head; tail++) {
+        handle_cell(ctx, src, get_cell(ring, tail));
+        ring->tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+void atl_shm::handle_cell(ep_ctx& ctx, int src, const atl_shm_cell_t& cell) {
+    const atl_shm_cell_hdr_t& hdr = cell.hdr;
+
+    switch (hdr.type) {
+        case ATL_SHM_MSG_ACK:
+            ((atl_shm_req_t*)hdr.cookie)->comp_state = ATL_SHM_COMP_COMPLETED;
+            break;
+        case ATL_SHM_MSG_FRAG: copy_frag(ctx, src, cell); break;
+        case ATL_SHM_MSG_EAGER:
+        case ATL_SHM_MSG_RNDV: {
+            uint64_t tag = hdr.tag;
+            auto it = std::find_if(ctx.posted_recvs.begin(),
+                                   ctx.posted_recvs.end(),
+                                   [src, tag](const atl_shm_req_t* req) {
+                                       return (req->peer == src) && (req->tag == tag);
+                                   });
+
+            if (it != ctx.posted_recvs.end()) {
+                atl_shm_req_t* req = *it;
+                ctx.posted_recvs.erase(it);
+
+                CCL_THROW_IF_NOT(hdr.len <= req->len,
+                                 "message from ",
+                                 src,
+                                 " is truncated, len ",
+                                 hdr.len,
+                                 ", buffer len ",
+                                 req->len);
+                req->recv_len = hdr.len;
+
+                if (hdr.type == ATL_SHM_MSG_RNDV) {
+                    read_remote(ctx, src, req->buf, hdr.len, hdr.addr, hdr.cookie);
+                    req->comp_state = ATL_SHM_COMP_COMPLETED;
+                }
+                else {
+                    ctx.recv_states[src] = recv_state{ req, nullptr };
+                    copy_frag(ctx, src, cell);
+                }
+                break;
+            }
+
+            ctx.unexp_msgs.push_back(unexp_msg{ src,
+                                                tag,
+                                                hdr.len,
+                                                (hdr.type == ATL_SHM_MSG_RNDV),
+                                                hdr.addr,
+                                                hdr.cookie,
+                                                std::vector<char>(),
+                                                0 });
+
+            if (hdr.type == ATL_SHM_MSG_EAGER) {
+                unexp_msg& msg = ctx.unexp_msgs.back();
+                msg.data.resize(msg.len);
+                ctx.recv_states[src] = recv_state{ nullptr, &msg };
+                copy_frag(ctx, src, cell);
+            }
+            break;
+        }
+        default: CCL_THROW("unexpected shm message type ", hdr.type, " from ", src);
+    }
+}
+
+void atl_shm::copy_frag(ep_ctx& ctx, int src, const atl_shm_cell_t& cell) {
+    recv_state& state = ctx.recv_states[src];
+    size_t frag_len = cell.hdr.frag_len;
+
+    if (state.req) {
+        atl_shm_req_t* req = state.req;
+        if (frag_len) {
+            memcpy((char*)req->buf + req->offset, cell.payload, frag_len);
+        }
+        req->offset += frag_len;
+        if (req->offset == req->recv_len) {
+            req->comp_state = ATL_SHM_COMP_COMPLETED;
+            state = recv_state{ nullptr, nullptr };
+        }
+    }
+    else {
+        CCL_THROW_IF_NOT(state.msg, "unexpected fragment from ", src);
+        unexp_msg* msg = state.msg;
+        if (frag_len) {
+            memcpy(msg->data.data() + msg->offset, cell.payload, frag_len);
+        }
+        msg->offset += frag_len;
+        if (msg->offset == msg->len) {
+            state = recv_state{ nullptr, nullptr };
+        }
+    }
+}
+
+void atl_shm::read_remote(ep_ctx& ctx,
+                          int src,
+                          void* buf,
+                          size_t len,
+                          uint64_t addr,
+                          uint64_t cookie) {
+    size_t offset = 0;
+    while (offset < len) {
+        struct iovec local = { (char*)buf + offset, len - offset };
+        struct iovec remote = { (void*)(addr + offset), len - offset };
+        ssize_t ret = process_vm_readv(proc_infos[src].pid, &local, 1, &remote, 1, 0);
+        CCL_THROW_IF_NOT(ret > 0, "process_vm_readv from ", src, " failed, errno: ", strerror(errno));
+        offset += ret;
+    }
+
+    /* sender keeps the buffer until ack, it is sent with the next progress */
+    ctx.ack_queues[src].push_back(cookie);
+}
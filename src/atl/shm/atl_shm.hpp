@@ -0,0 +1,351 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atl/atl_base_transport.hpp"
+#include "common/utils/utils.hpp"
+
+#define ATL_SHM_BASE_PM_KEY     "atl-shm"
+#define ATL_SHM_SEGMENT_PM_KEY  ATL_SHM_BASE_PM_KEY "-segment"
+#define ATL_SHM_PROC_IDX_PM_KEY ATL_SHM_BASE_PM_KEY "-proc-idx"
+
+#define ATL_SHM_SEGMENT_NAME_LEN 64
+#define ATL_SHM_SEGMENT_MAGIC    0x63636c73686dULL
+
+/*
+   every ordered pair of processes has its own ring per endpoint,
+   number of cells in the ring is set by CCL_ATL_SHM_RING_CELLS
+*/
+#define ATL_SHM_CELL_SIZE 4096
+
+/* messages starting from this size are copied by the receiver directly from the sender memory */
+#define ATL_SHM_CMA_THRESHOLD (16 * 1024)
+
+typedef enum {
+    ATL_SHM_MSG_EAGER, /* first fragment of the message, carries tag and total length */
+    ATL_SHM_MSG_FRAG, /* next fragment of the message which is in flight on the ring */
+    ATL_SHM_MSG_RNDV, /* address of the sender buffer for single-copy */
+    ATL_SHM_MSG_ACK /* receiver completed single-copy, sender buffer can be released */
+} atl_shm_msg_type_t;
+
+typedef struct {
+    uint64_t tag;
+    uint64_t len;
+    uint64_t addr;
+    uint64_t cookie;
+    uint32_t type;
+    uint32_t frag_len;
+} atl_shm_cell_hdr_t;
+
+#define ATL_SHM_CELL_PAYLOAD_SIZE (ATL_SHM_CELL_SIZE - CACHELINE_SIZE)
+
+typedef struct {
+    alignas(CACHELINE_SIZE) atl_shm_cell_hdr_t hdr;
+    alignas(CACHELINE_SIZE) char payload[ATL_SHM_CELL_PAYLOAD_SIZE];
+} atl_shm_cell_t;
+
+/*
+   single-producer single-consumer ring,
+   head is advanced by the sender only, tail is advanced by the receiver only,
+   cells follow the ring header
+*/
+typedef struct {
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> head;
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail;
+} atl_shm_ring_t;
+
+static_assert(sizeof(atl_shm_ring_t) % CACHELINE_SIZE == 0, "cells have to be cacheline aligned");
+
+typedef struct {
+    uint64_t magic;
+    int proc_count;
+    int ep_count;
+    uint64_t cell_count;
+} atl_shm_segment_hdr_t;
+
+/* follows the segment header, one per process */
+typedef struct {
+    int pid;
+    int is_cma_enabled;
+    uint64_t cma_probe_addr;
+} atl_shm_proc_info_t;
+
+typedef enum { ATL_SHM_COMP_POSTED, ATL_SHM_COMP_COMPLETED } atl_shm_comp_state_t;
+
+typedef struct {
+    atl_shm_comp_state_t comp_state;
+    int peer;
+    uint64_t tag;
+    void* buf;
+    size_t len;
+    /* bytes pushed to the ring for send, bytes copied into buf for recv */
+    size_t offset;
+    size_t recv_len;
+    bool is_rndv;
+} atl_shm_req_t;
+
+class atl_shm : public atl_base_transport {
+public:
+    atl_shm() = default;
+    atl_shm(const atl_shm& other) = delete;
+    atl_shm& operator=(const atl_shm& other) = delete;
+    ~atl_shm();
+
+    atl_status_t init(int* argc,
+                      char*** argv,
+                      atl_attr_t* attr,
+                      const char* main_addr,
+                      std::shared_ptr<ipmi> pmi) override;
+
+    atl_status_t update(std::shared_ptr<ipmi> pmi) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t mr_reg(const void* buf, size_t len, atl_mr_t** mr) override;
+
+    atl_status_t mr_dereg(atl_mr_t* mr) override;
+
+    atl_status_t send(atl_ep_t& ep,
+                      const void* buf,
+                      size_t len,
+                      int dst_proc_idx,
+                      uint64_t tag,
+                      atl_req_t& req) override;
+
+    atl_status_t recv(atl_ep_t& ep,
+                      void* buf,
+                      size_t len,
+                      int src_proc_idx,
+                      uint64_t tag,
+                      atl_req_t& req) override;
+
+    atl_status_t probe(atl_ep_t& ep,
+                       int src_proc_idx,
+                       uint64_t tag,
+                       int* found,
+                       size_t* recv_len) override;
+
+    atl_status_t allgather(atl_ep_t& ep,
+                           const void* send_buf,
+                           void* recv_buf,
+                           size_t len,
+                           atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t allgatherv(atl_ep_t& ep,
+                            const void* send_buf,
+                            size_t send_len,
+                            void* recv_buf,
+                            const size_t* recv_lens,
+                            const size_t* offsets,
+                            atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t allreduce(atl_ep_t& ep,
+                           const void* send_buf,
+                           void* recv_buf,
+                           size_t len,
+                           atl_datatype_t dtype,
+                           atl_reduction_t op,
+                           atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t alltoall(atl_ep_t& ep,
+                          const void* send_buf,
+                          void* recv_buf,
+                          int len,
+                          atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t alltoallv(atl_ep_t& ep,
+                           const void* send_buf,
+                           const size_t* send_lens,
+                           const size_t* send_offsets,
+                           void* recv_buf,
+                           const size_t* recv_lens,
+                           const size_t* recv_offsets,
+                           atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t barrier(atl_ep_t& ep, atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t bcast(atl_ep_t& ep, void* buf, size_t len, int root, atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t broadcast(atl_ep_t& ep,
+                           void* send_buf,
+                           void* recv_buf,
+                           size_t len,
+                           int root,
+                           atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t reduce(atl_ep_t& ep,
+                        const void* send_buf,
+                        void* recv_buf,
+                        size_t len,
+                        int root,
+                        atl_datatype_t dtype,
+                        atl_reduction_t op,
+                        atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t reduce_scatter(atl_ep_t& ep,
+                                const void* send_buf,
+                                void* recv_buf,
+                                size_t recv_len,
+                                atl_datatype_t dtype,
+                                atl_reduction_t op,
+                                atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t read(atl_ep_t& ep,
+                      void* buf,
+                      size_t len,
+                      atl_mr_t* mr,
+                      uint64_t addr,
+                      uintptr_t remote_key,
+                      int dst_proc_idx,
+                      atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t write(atl_ep_t& ep,
+                       const void* buf,
+                       size_t len,
+                       atl_mr_t* mr,
+                       uint64_t addr,
+                       uintptr_t remote_key,
+                       int dst_proc_idx,
+                       atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t wait(atl_ep_t& ep, atl_req_t& req) override;
+
+    atl_status_t wait_all(atl_ep_t& ep, std::vector<atl_req_t>& reqs, size_t count) override;
+
+    atl_status_t cancel(atl_ep_t& ep, atl_req_t& req) override {
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t poll(atl_ep_t& ep) override;
+
+    atl_status_t check(atl_ep_t& ep, atl_req_t& req) override;
+
+    void set_req_completed(atl_req_t& req) override;
+
+    atl_proc_coord_t create_proc_coord(atl_ep_t& ep) override {
+        return coord;
+    }
+
+    void comms_free(std::vector<atl_ep_t>& eps) override {
+        throw ccl::exception(std::string(__PRETTY_FUNCTION__) + " - is not implemented");
+    }
+
+    atl_status_t comm_split(const std::vector<atl_ep_t>& base_eps,
+                            std::vector<atl_ep_t>& eps,
+                            size_t color,
+                            int key,
+                            int local_idx,
+                            int local_count) override {
+        throw ccl::exception(std::string(__PRETTY_FUNCTION__) + " - is not implemented");
+        return ATL_STATUS_UNSUPPORTED;
+    }
+
+    atl_status_t get_rank2proc_map(std::shared_ptr<ipmi> pmi,
+                                   std::vector<int>& rank2proc_map,
+                                   atl_proc_coord_t coord) override;
+
+    std::string to_string() override;
+
+    atl_status_t finalize(int global_idx = 0) override;
+
+private:
+    /* message which arrived before the matching recv was posted */
+    struct unexp_msg {
+        int src;
+        uint64_t tag;
+        size_t len;
+        bool is_rndv;
+        uint64_t addr;
+        uint64_t cookie;
+        std::vector<char> data;
+        size_t offset;
+    };
+
+    /* destination of the fragments of the message which is in flight from the peer */
+    struct recv_state {
+        atl_shm_req_t* req;
+        unexp_msg* msg;
+    };
+
+    struct ep_ctx {
+        std::list<atl_shm_req_t*> posted_recvs;
+        std::list<unexp_msg> unexp_msgs;
+        std::vector<std::deque<atl_shm_req_t*>> send_queues;
+        std::vector<std::deque<uint64_t>> ack_queues;
+        std::vector<recv_state> recv_states;
+    };
+
+    atl_shm_ring_t* get_ring(size_t ep_idx, int src, int dst);
+    atl_shm_cell_t& get_cell(atl_shm_ring_t* ring, uint64_t idx) {
+        return reinterpret_cast<atl_shm_cell_t*>(ring + 1)[idx % cell_count];
+    }
+
+    atl_status_t create_segment(std::shared_ptr<ipmi> pmi);
+    atl_status_t check_cma(std::shared_ptr<ipmi> pmi);
+
+    atl_status_t progress_ep(atl_ep_t& ep);
+    void progress_sends(ep_ctx& ctx, size_t ep_idx, int dst);
+    void progress_recvs(ep_ctx& ctx, size_t ep_idx, int src);
+    bool push_cell(atl_shm_ring_t* ring, const atl_shm_cell_hdr_t& hdr, const void* payload);
+    void handle_cell(ep_ctx& ctx, int src, const atl_shm_cell_t& cell);
+    void copy_frag(ep_ctx& ctx, int src, const atl_shm_cell_t& cell);
+    void read_remote(ep_ctx& ctx, int src, void* buf, size_t len, uint64_t addr, uint64_t cookie);
+
+    std::vector<std::unique_ptr<ep_ctx>> ep_ctxs;
+
+    std::string segment_name;
+    void* segment{ nullptr };
+    size_t segment_size{ 0 };
+    size_t cell_count{ 0 };
+    size_t ring_size{ 0 };
+    atl_shm_segment_hdr_t* segment_hdr{ nullptr };
+    atl_shm_proc_info_t* proc_infos{ nullptr };
+    char* rings{ nullptr };
+
+    bool enable_cma{ false };
+    bool need_extra_exchange{ false };
+};
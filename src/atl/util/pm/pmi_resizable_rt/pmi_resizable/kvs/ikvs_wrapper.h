@@ -33,6 +33,19 @@ public:
                                                    const std::string& kvs_key,
                                                    std::string& kvs_val) = 0;
 
+    /* missing keys get empty values */
+    virtual kvs_status_t kvs_get_values_by_name_keys(const std::string& kvs_name,
+                                                     const std::vector<std::string>& kvs_keys,
+                                                     std::vector<std::string>& kvs_vals) {
+        kvs_vals.resize(kvs_keys.size());
+        for (size_t idx = 0; idx < kvs_keys.size(); idx++) {
+            kvs_vals[idx].clear();
+            KVS_CHECK_STATUS(kvs_get_value_by_name_key(kvs_name, kvs_keys[idx], kvs_vals[idx]),
+                             "failed to get value");
+        }
+        return KVS_STATUS_SUCCESS;
+    }
+
     virtual kvs_status_t kvs_init(const char* main_addr) = 0;
 
     virtual kvs_status_t kvs_main_server_address_reserve(char* main_addr) = 0;
@@ -145,6 +145,28 @@ kvs_status_t internal_kvs::kvs_get_value_by_name_key(const std::string& kvs_name
     return KVS_STATUS_SUCCESS;
 }
 
+kvs_status_t internal_kvs::kvs_get_values_by_name_keys(const std::string& kvs_name,
+                                                       const std::vector<std::string>& kvs_keys,
+                                                       std::vector<std::string>& kvs_vals) {
+    assert_throw_can_use_internal_kvs();
+    kvs_request_t request;
+    std::vector<char> payload;
+    KVS_CHECK_STATUS(kvs_batch_encode(kvs_keys, payload), "client: get_values encode keys");
+
+    /* one round trip for all keys, key field is not used by the server */
+    KVS_CHECK_STATUS(
+        request.put(client_op_sock, AM_GET_BATCH, client_memory_mutex, kvs_name, kvs_name),
+        "client: get_values");
+    KVS_CHECK_STATUS(request.put(client_op_sock, client_memory_mutex, payload),
+                     "client: get_values put keys");
+
+    KVS_CHECK_STATUS(request.get(client_op_sock, client_memory_mutex, payload),
+                     "client: get_values read data");
+    KVS_CHECK_STATUS(kvs_batch_decode(payload, kvs_vals), "client: get_values decode values");
+    KVS_ERROR_IF_NOT(kvs_vals.size() == kvs_keys.size());
+    return KVS_STATUS_SUCCESS;
+}
+
 kvs_status_t internal_kvs::kvs_get_count_names(const std::string& kvs_name, size_t& count_names) {
     assert_throw_can_use_internal_kvs();
     count_names = 0;
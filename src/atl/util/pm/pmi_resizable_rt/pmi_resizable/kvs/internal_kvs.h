@@ -51,6 +51,10 @@ public:
                                            const std::string& kvs_key,
                                            std::string& kvs_val) override;
 
+    kvs_status_t kvs_get_values_by_name_keys(const std::string& kvs_name,
+                                             const std::vector<std::string>& kvs_keys,
+                                             std::vector<std::string>& kvs_vals) override;
+
     kvs_status_t kvs_register(const std::string& kvs_name,
                               const std::string& kvs_key,
                               std::string& kvs_val);
@@ -109,6 +113,14 @@ public:
         local_id = val;
     }
 
+    const char* get_local_host_ip() const {
+        return local_host_ip;
+    }
+
+    sa_family_t get_address_family() const {
+        return address_family;
+    }
+
 private:
     kvs_status_t init_main_server_by_string(const char* main_addr);
     kvs_status_t init_main_server_by_env();
@@ -19,16 +19,24 @@
 #include <list>
 #include <map>
 #include <mutex>
-#include <poll.h>
+#include <set>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <sys/epoll.h>
 #include <unistd.h>
 #include <memory>
+#include <unordered_map>
 
 #include "common/log/log.hpp"
 #include "internal_kvs_server.hpp"
 
+/*
+   single server with a star topology: every client talks to this process only,
+   so barrier and keys-values exchange stay O(P) on the server per operation.
+   epoll and batched gets keep it at one round trip per client and O(1) work per request;
+   there is no tree barrier or allgather and comm creation is not logarithmic in rank count
+*/
 class server {
 public:
     server(server_args_t* server_args) : args(server_args) {}
@@ -36,6 +44,7 @@ public:
     kvs_status_t check_finalize(size_t& to_finalize);
     kvs_status_t make_client_request(int& socket);
     kvs_status_t try_to_connect_new();
+    kvs_status_t get_batch(int socket);
 
 private:
     struct clients_info {
@@ -62,76 +71,89 @@ private:
     struct barrier_info {
         size_t global_size = 0;
         size_t local_size = 0;
+        /* number of registered clients which are waiting in the barrier */
+        size_t arrived_count = 0;
         std::list<std::shared_ptr<clients_info>> clients;
+        std::unordered_map<int, std::shared_ptr<clients_info>> clients_by_socket;
     };
-    enum fd_indexes { FDI_LISTENER = 0, FDI_CONTROL = 1, FDI_LAST = 2 };
 
     kvs_request_t request{};
     size_t count{};
     size_t client_count = 0;
     const size_t max_client_queue_size = 300;
-    const size_t client_count_increase = 300;
+    static constexpr int max_epoll_events = 256;
     std::map<std::string, barrier_info> barriers;
     std::map<std::string, comm_info> communicators;
     std::mutex server_memory_mutex;
     std::map<std::string, std::map<std::string, std::string>> requests;
     const int free_socket = -1;
-    std::vector<struct pollfd> poll_fds;
+    int epoll_fd = -1;
+    int listener_fd = -1;
+    int control_fd = -1;
+    std::set<int> client_sockets;
 
     sa_family_t address_family{ AF_UNSPEC };
     std::unique_ptr<server_args_t> args;
 };
 
 kvs_status_t server::try_to_connect_new() {
-    if (poll_fds[FDI_LISTENER].revents != 0) {
-        std::shared_ptr<isockaddr> addr;
+    std::shared_ptr<isockaddr> addr;
 
-        if (address_family == AF_INET) {
-            addr = std::shared_ptr<isockaddr>(new sockaddr_v4());
-        }
-        else {
-            addr = std::shared_ptr<isockaddr>(new sockaddr_v6());
-        }
+    if (address_family == AF_INET) {
+        addr = std::shared_ptr<isockaddr>(new sockaddr_v4());
+    }
+    else {
+        addr = std::shared_ptr<isockaddr>(new sockaddr_v6());
+    }
 
-        int new_socket;
-        bool socket_found = false;
-        socklen_t peer_addr_size = addr->size();
-        if ((new_socket = accept(poll_fds[FDI_LISTENER].fd,
-                                 addr->get_sock_addr_ptr(),
-                                 (socklen_t*)&peer_addr_size)) < 0) {
-            LOG_ERROR("server_listen_sock accept:", strerror(errno));
-            return KVS_STATUS_FAILURE;
-        }
-        for (size_t i = FDI_LAST; i < poll_fds.size(); i++) {
-            if (poll_fds[i].fd == free_socket) {
-                poll_fds[i].fd = new_socket;
-                socket_found = true;
-                break;
-            }
-        }
-        if (!socket_found) {
-            // the code is written in a way that there should always be a free socket available
-            // if no socket is found, this means that there is an error in the code
-            // or that out of memory exception occurred while resizing the poll_fds vector
-            // and it was not properly handled in the layers above internal_kvs_server
-            LOG_ERROR("free socket not found; this indicates programmer's error");
-            if (close(new_socket)) {
-                // we are already returning failure, there is not much we can do
-                // except for logging the exact error that occurred
-                LOG_ERROR("error closing a socket: ", strerror(errno));
-            }
-            return KVS_STATUS_FAILURE;
+    int new_socket;
+    socklen_t peer_addr_size = addr->size();
+    if ((new_socket = accept(
+             listener_fd, addr->get_sock_addr_ptr(), (socklen_t*)&peer_addr_size)) < 0) {
+        LOG_ERROR("server_listen_sock accept:", strerror(errno));
+        return KVS_STATUS_FAILURE;
+    }
+
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = new_socket;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, new_socket, &event) < 0) {
+        LOG_ERROR("epoll_ctl add client: ", strerror(errno));
+        if (close(new_socket)) {
+            // we are already returning failure, there is not much we can do
+            // except for logging the exact error that occurred
+            LOG_ERROR("error closing a socket: ", strerror(errno));
         }
-        client_count++;
-        if (poll_fds.size() - FDI_LAST == client_count) {
-            size_t old_size = poll_fds.size();
-            poll_fds.resize(old_size + client_count_increase);
-            for (size_t i = old_size; i < poll_fds.size(); i++) {
-                poll_fds[i].fd = free_socket;
-                poll_fds[i].events = POLLIN;
+        return KVS_STATUS_FAILURE;
+    }
+    client_sockets.insert(new_socket);
+    client_count++;
+
+    return KVS_STATUS_SUCCESS;
+}
+
+kvs_status_t server::get_batch(int socket) {
+    std::vector<char> payload;
+    std::vector<std::string> keys;
+    KVS_CHECK_STATUS(request.get(socket, server_memory_mutex, payload),
+                     "server: get batch payload");
+    KVS_CHECK_STATUS(kvs_batch_decode(payload, keys), "server: decode batch keys");
+
+    /* missing keys are answered with empty values, client retries them */
+    std::vector<std::string> vals(keys.size());
+    auto it_name = requests.find(request.name);
+    if (it_name != requests.end()) {
+        for (size_t idx = 0; idx < keys.size(); idx++) {
+            auto it_key = it_name->second.find(keys[idx]);
+            if (it_key != it_name->second.end()) {
+                vals[idx] = it_key->second;
             }
         }
     }
+
+    KVS_CHECK_STATUS(kvs_batch_encode(vals, payload), "server: encode batch values");
+    KVS_CHECK_STATUS(request.put(socket, server_memory_mutex, payload),
+                     "server: put batch values");
     return KVS_STATUS_SUCCESS;
 }
 
@@ -140,6 +162,7 @@ kvs_status_t server::make_client_request(int& socket) {
 
     switch (request.mode) {
         case AM_CLOSE: {
+            client_sockets.erase(socket);
             close(socket);
             socket = free_socket;
             client_count--;
@@ -209,37 +232,34 @@ kvs_status_t server::make_client_request(int& socket) {
                              "server: put keys_values write data");
             break;
         }
+        case AM_GET_BATCH: {
+            KVS_CHECK_STATUS(get_batch(socket), "server: get batch");
+            break;
+        }
         case AM_BARRIER: {
             auto& barrier_list = barriers[request.name];
             auto& clients = barrier_list.clients;
-            auto client_it = std::find_if(std::begin(clients),
-                                          std::end(clients),
-                                          [&](std::shared_ptr<server::clients_info> v) {
-                                              return v->socket == socket;
-                                          });
-            if (client_it == clients.end()) {
+            auto client_it = barrier_list.clients_by_socket.find(socket);
+            if (client_it == barrier_list.clients_by_socket.end()) {
                 // TODO: Look deeper to fix this error
                 LOG_ERROR("Server error: Unregister Barrier request!");
                 return KVS_STATUS_FAILURE;
             }
-            auto client_inf = client_it->get();
-            client_inf->in_barrier = true;
+            auto client_inf = client_it->second.get();
+            if (!client_inf->in_barrier) {
+                client_inf->in_barrier = true;
+                barrier_list.arrived_count++;
+            }
 
-            if (barrier_list.global_size == barrier_list.local_size) {
-                bool is_barrier_stop = true;
+            /* arrivals are counted, so every request is O(1) until the barrier is released */
+            if (barrier_list.global_size == barrier_list.local_size &&
+                barrier_list.arrived_count == clients.size()) {
+                size_t is_done = 1;
+                barrier_list.arrived_count = 0;
                 for (const auto& client : clients) {
-                    if (!client->in_barrier) {
-                        is_barrier_stop = false;
-                        break;
-                    }
-                }
-                if (is_barrier_stop) {
-                    size_t is_done = 1;
-                    for (const auto& client : clients) {
-                        client->in_barrier = false;
-                        KVS_CHECK_STATUS(request.put(client->socket, server_memory_mutex, is_done),
-                                         "server: barrier");
-                    }
+                    client->in_barrier = false;
+                    KVS_CHECK_STATUS(request.put(client->socket, server_memory_mutex, is_done),
+                                     "server: barrier");
                 }
             }
             break;
@@ -263,8 +283,9 @@ kvs_status_t server::make_client_request(int& socket) {
             KVS_CHECK_STATUS(safe_strtol(glob_size, barrier.global_size),
                              "failed to convert global_size");
 
-            barrier.clients.push_back(
-                std::shared_ptr<clients_info>(new clients_info(socket, false)));
+            auto client = std::shared_ptr<clients_info>(new clients_info(socket, false));
+            barrier.clients.push_back(client);
+            barrier.clients_by_socket[socket] = client;
             break;
         }
         case AM_SET_SIZE: {
@@ -339,15 +360,13 @@ kvs_status_t server::make_client_request(int& socket) {
 
 kvs_status_t server::check_finalize(size_t& to_finalize) {
     to_finalize = false;
-    if (poll_fds[FDI_CONTROL].revents != 0) {
-        KVS_CHECK_STATUS(request.get(poll_fds[FDI_CONTROL].fd, server_memory_mutex),
-                         "server: get control msg from client");
-        if (request.mode != AM_FINALIZE) {
-            LOG_ERROR("invalid access mode for local socket\n");
-            return KVS_STATUS_FAILURE;
-        }
-        to_finalize = true;
+    KVS_CHECK_STATUS(request.get(control_fd, server_memory_mutex),
+                     "server: get control msg from client");
+    if (request.mode != AM_FINALIZE) {
+        LOG_ERROR("invalid access mode for local socket\n");
+        return KVS_STATUS_FAILURE;
     }
+    to_finalize = true;
     return KVS_STATUS_SUCCESS;
 }
 
@@ -361,73 +380,97 @@ kvs_status_t server::run() {
     int reuse_optname = SO_REUSEADDR;
 #endif
 
-    poll_fds.resize(client_count_increase);
-    for (auto& it : poll_fds) {
-        it.fd = free_socket;
-        it.events = POLLIN;
-    }
-    poll_fds[FDI_LISTENER].fd = args->sock_listener;
+    listener_fd = args->sock_listener;
     address_family = args->args->sin_family();
 
-    if (setsockopt(
-            poll_fds[FDI_LISTENER].fd, SOL_SOCKET, reuse_optname, &so_reuse, sizeof(so_reuse))) {
+    if (setsockopt(listener_fd, SOL_SOCKET, reuse_optname, &so_reuse, sizeof(so_reuse))) {
         LOG_ERROR("server_listen_sock setsockopt(%s)", strerror(errno));
         return KVS_STATUS_FAILURE;
     }
 
-    if (listen(poll_fds[FDI_LISTENER].fd, max_client_queue_size) < 0) {
+    if (listen(listener_fd, max_client_queue_size) < 0) {
         LOG_ERROR("server_listen_sock listen(%s)", strerror(errno));
         return KVS_STATUS_FAILURE;
     }
 
-    if ((poll_fds[FDI_CONTROL].fd = socket(address_family, SOCK_STREAM, 0)) < 0) {
+    if ((control_fd = socket(address_family, SOCK_STREAM, 0)) < 0) {
         LOG_ERROR("server_control_sock init(%s)", strerror(errno));
         return KVS_STATUS_FAILURE;
     }
 
-    while (connect(poll_fds[FDI_CONTROL].fd, args->args->get_sock_addr_ptr(), args->args->size()) <
-           0) {
+    while (connect(control_fd, args->args->get_sock_addr_ptr(), args->args->size()) < 0) {
+    }
+
+    /* readiness is reported per socket, so the cost of a wakeup does not depend on client count */
+    if ((epoll_fd = epoll_create1(0)) < 0) {
+        LOG_ERROR("epoll_create1(%s)", strerror(errno));
+        return KVS_STATUS_FAILURE;
     }
+
+    for (int fd : { listener_fd, control_fd }) {
+        struct epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            LOG_ERROR("epoll_ctl(%s)", strerror(errno));
+            return KVS_STATUS_FAILURE;
+        }
+    }
+
+    std::vector<struct epoll_event> events(max_epoll_events);
+
     while (!should_stop || client_count > 0) {
-        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+        int event_count = epoll_wait(epoll_fd, events.data(), max_epoll_events, -1);
+        if (event_count < 0) {
             if (errno != EINTR) {
-                LOG_ERROR("poll(%s)", strerror(errno));
+                LOG_ERROR("epoll_wait(%s)", strerror(errno));
                 return KVS_STATUS_FAILURE;
             }
             else {
-                /* restart select */
+                /* restart wait */
                 continue;
             }
         }
 
-        for (size_t i = FDI_LAST; i < poll_fds.size(); i++) {
-            if (poll_fds[i].fd != free_socket && poll_fds[i].revents != 0) {
-                KVS_CHECK_STATUS(make_client_request(poll_fds[i].fd), "failed to make request");
+        for (int idx = 0; idx < event_count; idx++) {
+            int fd = events[idx].data.fd;
+            if (fd == listener_fd) {
+                KVS_CHECK_STATUS(try_to_connect_new(), "failed to connect new");
+            }
+            else if (fd == control_fd) {
+                if (!should_stop) {
+                    KVS_CHECK_STATUS(check_finalize(should_stop), "failed to check finalize");
+                }
+                if (should_stop) {
+                    /* no more control messages are expected */
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, control_fd, nullptr);
+                }
+            }
+            else {
+                /* closed sockets leave epoll set on close */
+                KVS_CHECK_STATUS(make_client_request(fd), "failed to make request");
             }
-        }
-        KVS_CHECK_STATUS(try_to_connect_new(), "failed to connect new");
-        if (!should_stop) {
-            KVS_CHECK_STATUS(check_finalize(should_stop), "failed to check finalize");
         }
     }
 
-    if (poll_fds[FDI_CONTROL].fd != free_socket) {
-        KVS_CHECK_STATUS(request.put(poll_fds[FDI_CONTROL].fd, server_memory_mutex, should_stop),
+    if (control_fd != free_socket) {
+        KVS_CHECK_STATUS(request.put(control_fd, server_memory_mutex, should_stop),
                          "server: put control msg to client");
     }
 
-    close(poll_fds[FDI_CONTROL].fd);
-    poll_fds[FDI_CONTROL].fd = free_socket;
+    close(control_fd);
+    control_fd = free_socket;
 
-    for (size_t i = FDI_LAST; i < poll_fds.size(); i++) {
-        if (poll_fds[i].fd != free_socket) {
-            close(poll_fds[i].fd);
-            poll_fds[i].fd = free_socket;
-        }
+    for (int fd : client_sockets) {
+        close(fd);
     }
+    client_sockets.clear();
+
+    close(epoll_fd);
+    epoll_fd = free_socket;
 
-    close(poll_fds[FDI_LISTENER].fd);
-    poll_fds[FDI_LISTENER].fd = free_socket;
+    close(listener_fd);
+    listener_fd = free_socket;
     return KVS_STATUS_SUCCESS;
 }
 
@@ -37,8 +37,68 @@ enum kvs_access_mode_t : uint32_t {
     AM_BARRIER_REGISTER = 10,
     AM_INTERNAL_REGISTER = 11,
     AM_SET_SIZE = 12,
+    AM_GET_BATCH = 13,
 };
 
+/*
+   batched requests carry a compact payload after the fixed-size request:
+   size_t payload length, then uint32_t item count followed by items,
+   each item is uint32_t length followed by its bytes, integers are little endian
+*/
+inline void kvs_batch_append(std::vector<char>& buf, uint32_t value) {
+    for (size_t i = 0; i < sizeof(value); i++) {
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void kvs_batch_append(std::vector<char>& buf, const std::string& str) {
+    kvs_batch_append(buf, static_cast<uint32_t>(str.size()));
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+inline kvs_status_t kvs_batch_parse(const std::vector<char>& buf, size_t& offset, uint32_t& value) {
+    KVS_ERROR_IF_NOT(offset + sizeof(value) <= buf.size());
+    value = 0;
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(buf[offset + i])) << (8 * i);
+    }
+    offset += sizeof(value);
+    return KVS_STATUS_SUCCESS;
+}
+
+inline kvs_status_t kvs_batch_parse(const std::vector<char>& buf,
+                                    size_t& offset,
+                                    std::string& str) {
+    uint32_t len = 0;
+    KVS_CHECK_STATUS(kvs_batch_parse(buf, offset, len), "failed to parse batch item length");
+    KVS_ERROR_IF_NOT(offset + len <= buf.size());
+    str.assign(buf.begin() + offset, buf.begin() + offset + len);
+    offset += len;
+    return KVS_STATUS_SUCCESS;
+}
+
+inline kvs_status_t kvs_batch_encode(const std::vector<std::string>& items, std::vector<char>& buf) {
+    buf.clear();
+    kvs_batch_append(buf, static_cast<uint32_t>(items.size()));
+    for (const auto& item : items) {
+        kvs_batch_append(buf, item);
+    }
+    return KVS_STATUS_SUCCESS;
+}
+
+inline kvs_status_t kvs_batch_decode(const std::vector<char>& buf,
+                                     std::vector<std::string>& items) {
+    size_t offset = 0;
+    uint32_t count = 0;
+    KVS_CHECK_STATUS(kvs_batch_parse(buf, offset, count), "failed to parse batch count");
+    items.resize(count);
+    for (auto& item : items) {
+        KVS_CHECK_STATUS(kvs_batch_parse(buf, offset, item), "failed to parse batch item");
+    }
+    KVS_ERROR_IF_NOT(offset == buf.size());
+    return KVS_STATUS_SUCCESS;
+}
+
 class kvs_request_t {
 public:
     kvs_status_t put(int sock,
@@ -119,6 +179,22 @@ public:
         DO_RW_OP(write, sock, tmp_val.data(), tmp_val.size(), memory_mutex);
         return KVS_STATUS_SUCCESS;
     }
+    kvs_status_t put(int sock, std::mutex& memory_mutex, const std::vector<char>& payload) {
+        KVS_CHECK_STATUS(put(sock, memory_mutex, payload.size()), "put payload size");
+        if (!payload.empty()) {
+            DO_RW_OP(write, sock, payload.data(), payload.size(), memory_mutex);
+        }
+        return KVS_STATUS_SUCCESS;
+    }
+    kvs_status_t get(int sock, std::mutex& memory_mutex, std::vector<char>& payload) {
+        size_t payload_size = 0;
+        KVS_CHECK_STATUS(get(sock, memory_mutex, payload_size), "get payload size");
+        payload.resize(payload_size);
+        if (!payload.empty()) {
+            DO_RW_OP(read, sock, payload.data(), payload.size(), memory_mutex);
+        }
+        return KVS_STATUS_SUCCESS;
+    }
     kvs_status_t get(int sock, std::mutex& memory_mutex, size_t& get_buf) {
         const size_t sizeof_get_buf = sizeof(get_buf);
         DO_RW_OP(read, sock, &get_buf, sizeof_get_buf, memory_mutex);
@@ -0,0 +1,211 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <algorithm>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "kvs_tree.hpp"
+#include "internal_kvs_server.hpp"
+#include "common/global/global.hpp"
+#include "common/log/log.hpp"
+
+#define KVS_TREE_ADDR_DELIM '_'
+
+static std::shared_ptr<isockaddr> kvs_tree_create_addr(sa_family_t family) {
+    if (family == AF_INET) {
+        return std::shared_ptr<isockaddr>(new sockaddr_v4());
+    }
+    return std::shared_ptr<isockaddr>(new sockaddr_v6());
+}
+
+kvs_tree::kvs_tree(std::shared_ptr<internal_kvs> k, int rank, int size, size_t radix)
+        : k(std::move(k)),
+          rank(rank),
+          size(size),
+          radix(radix) {
+    CCL_THROW_IF_NOT(radix >= 2, "unexpected kvs tree radix ", radix);
+}
+
+kvs_tree::~kvs_tree() {
+    close_sockets();
+}
+
+void kvs_tree::close_sockets() {
+    for (auto& sock : child_socks) {
+        if (sock != INVALID_SOCKET) {
+            close(sock);
+            sock = INVALID_SOCKET;
+        }
+    }
+    if (parent_sock != INVALID_SOCKET) {
+        close(parent_sock);
+        parent_sock = INVALID_SOCKET;
+    }
+    if (listen_sock != INVALID_SOCKET) {
+        close(listen_sock);
+        listen_sock = INVALID_SOCKET;
+    }
+}
+
+kvs_status_t kvs_tree::listen(std::string& addr) {
+    sa_family_t family = k->get_address_family();
+    auto listen_addr = kvs_tree_create_addr(family);
+    KVS_CHECK_STATUS(listen_addr->set_sin_addr(k->get_local_host_ip()),
+                     "failed to set kvs tree address");
+    /* any free port */
+    listen_addr->set_sin_port(0);
+
+    KVS_ERROR_IF_NOT((listen_sock = socket(family, SOCK_STREAM, 0)) >= 0,
+                     "kvs tree listen socket: ",
+                     strerror(errno));
+    KVS_ERROR_IF_NOT(bind(listen_sock, listen_addr->get_sock_addr_ptr(), listen_addr->size()) == 0,
+                     "kvs tree bind: ",
+                     strerror(errno));
+    KVS_ERROR_IF_NOT(::listen(listen_sock, static_cast<int>(radix)) == 0,
+                     "kvs tree listen: ",
+                     strerror(errno));
+
+    socklen_t len = listen_addr->size();
+    KVS_ERROR_IF_NOT(getsockname(listen_sock, listen_addr->get_sock_addr_ptr(), &len) == 0,
+                     "kvs tree getsockname: ",
+                     strerror(errno));
+
+    addr = std::string(k->get_local_host_ip()) + KVS_TREE_ADDR_DELIM +
+           std::to_string(listen_addr->get_sin_port());
+    LOG_DEBUG("kvs tree: rank ", rank, ", listen on ", addr);
+
+    return KVS_STATUS_SUCCESS;
+}
+
+kvs_status_t kvs_tree::connect(const std::string& parent_addr) {
+    if (rank != 0) {
+        size_t pos = parent_addr.rfind(KVS_TREE_ADDR_DELIM);
+        KVS_ERROR_IF_NOT(pos != std::string::npos, "unexpected kvs tree address ", parent_addr);
+
+        sa_family_t family = k->get_address_family();
+        auto addr = kvs_tree_create_addr(family);
+        KVS_CHECK_STATUS(addr->set_sin_addr(parent_addr.substr(0, pos).c_str()),
+                         "failed to set kvs tree parent address");
+        addr->set_sin_port(std::stoi(parent_addr.substr(pos + 1)));
+
+        KVS_ERROR_IF_NOT((parent_sock = socket(family, SOCK_STREAM, 0)) >= 0,
+                         "kvs tree parent socket: ",
+                         strerror(errno));
+
+        int timeout = ccl::global_data::env().kvs_connection_timeout;
+        time_t start_time = time(nullptr);
+        int err = 0;
+        do {
+            err = ::connect(parent_sock, addr->get_sock_addr_ptr(), addr->size());
+        } while ((err < 0) && (time(nullptr) - start_time < timeout));
+        KVS_ERROR_IF_NOT(err == 0, "kvs tree connection to ", parent_addr, " timed out");
+
+        kvs_request_t request;
+        KVS_CHECK_STATUS(request.put(parent_sock, memory_mutex, static_cast<size_t>(rank)),
+                         "kvs tree: send rank");
+    }
+
+    /* children connect in any order, their sockets are placed by rank */
+    size_t first_child = rank * radix + 1;
+    size_t child_count = 0;
+    if (first_child < static_cast<size_t>(size)) {
+        child_count = std::min(radix, size - first_child);
+    }
+    child_socks.assign(child_count, INVALID_SOCKET);
+
+    for (size_t idx = 0; idx < child_count; idx++) {
+        int sock = accept(listen_sock, nullptr, nullptr);
+        KVS_ERROR_IF_NOT(sock >= 0, "kvs tree accept: ", strerror(errno));
+
+        size_t child_rank = 0;
+        kvs_request_t request;
+        KVS_CHECK_STATUS(request.get(sock, memory_mutex, child_rank), "kvs tree: recv rank");
+        KVS_ERROR_IF_NOT(child_rank >= first_child && child_rank < first_child + child_count &&
+                             child_socks[child_rank - first_child] == INVALID_SOCKET,
+                         "unexpected kvs tree child ",
+                         child_rank);
+        child_socks[child_rank - first_child] = sock;
+    }
+
+    close(listen_sock);
+    listen_sock = INVALID_SOCKET;
+
+    LOG_DEBUG("kvs tree: rank ", rank, ", parent ", get_parent(), ", children ", child_count);
+
+    return KVS_STATUS_SUCCESS;
+}
+
+kvs_status_t kvs_tree::barrier() {
+    kvs_request_t request;
+    size_t token = 0;
+
+    for (auto sock : child_socks) {
+        KVS_CHECK_STATUS(request.get(sock, memory_mutex, token), "kvs tree barrier: gather");
+    }
+    if (parent_sock != INVALID_SOCKET) {
+        KVS_CHECK_STATUS(request.put(parent_sock, memory_mutex, token), "kvs tree barrier: up");
+        KVS_CHECK_STATUS(request.get(parent_sock, memory_mutex, token),
+                         "kvs tree barrier: release");
+    }
+    for (auto sock : child_socks) {
+        KVS_CHECK_STATUS(request.put(sock, memory_mutex, token), "kvs tree barrier: down");
+    }
+
+    return KVS_STATUS_SUCCESS;
+}
+
+kvs_status_t kvs_tree::allgather(const std::string& val, std::vector<std::string>& vals) {
+    kvs_request_t request;
+    std::vector<char> payload;
+
+    /* gather (rank, value) pairs of the subtree */
+    std::vector<std::string> items{ std::to_string(rank), val };
+    std::vector<std::string> child_items;
+    for (auto sock : child_socks) {
+        KVS_CHECK_STATUS(request.get(sock, memory_mutex, payload), "kvs tree allgather: gather");
+        KVS_CHECK_STATUS(kvs_batch_decode(payload, child_items), "kvs tree allgather: decode");
+        items.insert(items.end(), child_items.begin(), child_items.end());
+    }
+
+    if (parent_sock != INVALID_SOCKET) {
+        KVS_CHECK_STATUS(kvs_batch_encode(items, payload), "kvs tree allgather: encode");
+        KVS_CHECK_STATUS(request.put(parent_sock, memory_mutex, payload),
+                         "kvs tree allgather: up");
+        KVS_CHECK_STATUS(request.get(parent_sock, memory_mutex, payload),
+                         "kvs tree allgather: release");
+        KVS_CHECK_STATUS(kvs_batch_decode(payload, vals), "kvs tree allgather: decode");
+        KVS_ERROR_IF_NOT(vals.size() == static_cast<size_t>(size));
+    }
+    else {
+        KVS_ERROR_IF_NOT(items.size() == 2 * static_cast<size_t>(size));
+        vals.assign(size, std::string());
+        for (size_t idx = 0; idx < items.size(); idx += 2) {
+            int item_rank = std::stoi(items[idx]);
+            KVS_ERROR_IF_NOT(item_rank >= 0 && item_rank < size);
+            vals[item_rank] = std::move(items[idx + 1]);
+        }
+        KVS_CHECK_STATUS(kvs_batch_encode(vals, payload), "kvs tree allgather: encode");
+    }
+
+    /* payload holds values of all ranks in rank order */
+    for (auto sock : child_socks) {
+        KVS_CHECK_STATUS(request.put(sock, memory_mutex, payload), "kvs tree allgather: down");
+    }
+
+    return KVS_STATUS_SUCCESS;
+}
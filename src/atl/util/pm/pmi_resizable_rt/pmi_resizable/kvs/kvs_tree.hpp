@@ -0,0 +1,74 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "util/pm/pmi_resizable_rt/pmi_resizable/def.h"
+#include "internal_kvs.h"
+
+/*
+   rank-to-rank tree over tcp for bootstrap barrier and allgather
+
+   every rank listens on the kvs interface and publishes its address in the kvs,
+   a rank fetches only the address of its parent, so setup costs one put and one get
+   per rank on the kvs server instead of a get per peer,
+   barrier and allgather take O(log P) round trips with radix children per rank,
+   allgather moves O(P) bytes through every level instead of P^2 through the server
+*/
+class kvs_tree {
+public:
+    kvs_tree(std::shared_ptr<internal_kvs> k, int rank, int size, size_t radix);
+    ~kvs_tree();
+
+    kvs_tree(const kvs_tree&) = delete;
+    kvs_tree& operator=(const kvs_tree&) = delete;
+
+    /* opens the listening socket, addr has to be published for the children */
+    kvs_status_t listen(std::string& addr);
+
+    /* connects to the parent and accepts all children, parent_addr is ignored on the root */
+    kvs_status_t connect(const std::string& parent_addr);
+
+    kvs_status_t barrier();
+
+    /* vals[r] is set to val of rank r */
+    kvs_status_t allgather(const std::string& val, std::vector<std::string>& vals);
+
+    int get_parent() const {
+        return (rank == 0) ? -1 : (rank - 1) / static_cast<int>(radix);
+    }
+
+    void close_sockets();
+
+private:
+    static constexpr int INVALID_SOCKET = -1;
+
+    std::shared_ptr<internal_kvs> k;
+    int rank;
+    int size;
+    size_t radix;
+
+    int listen_sock = INVALID_SOCKET;
+    int parent_sock = INVALID_SOCKET;
+    /* ordered by child rank */
+    std::vector<int> child_socks;
+
+    std::mutex memory_mutex;
+};
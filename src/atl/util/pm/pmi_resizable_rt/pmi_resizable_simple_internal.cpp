@@ -13,10 +13,13 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include <numeric>
 #include <unistd.h>
 
 #include "util/pm/pmi_resizable_rt/pmi_resizable/def.h"
 #include "util/pm/pmi_resizable_rt/pmi_resizable/kvs_keeper.hpp"
+#include "util/pm/pmi_resizable_rt/pmi_resizable/kvs/internal_kvs_server.hpp"
+#include "common/global/global.hpp"
 #include "pmi_resizable_simple_internal.h"
 #include "util/pm/codec/pm_rt_codec.h"
 
@@ -28,6 +31,7 @@
 #define GLOBAL_NAME_TO_RANK    "GLOBAL_NAME_TO_RANK"
 #define GLOBAL_RANK_TO_NAME    "GLOBAL_RANK_TO_NAME"
 #define LOCAL_KVS_ID           "LOCAL_KVS_ID"
+#define KVS_TREE_ADDR          "KVS_TREE_ADDR"
 
 #define INTERNAL_REGISTRATION                 "INTERNAL_REGISTRATION"
 #define RANKCOUNT_RANK_PROCID_THREADID_FORMAT "%zu_%d_%d-%s_%ld"
@@ -86,6 +90,57 @@ atl_status_t pmi_resizable_simple_internal::pmrt_init() {
         if (thread_num == 0) {
             ATL_CHECK_STATUS(barrier_reg(), "failed to barrier info register");
         }
+        if (ccl::global_data::env().kvs_tree_radix && threads_count == 1 &&
+            proc_rank_count == 1 && proc_count > 1) {
+            ATL_CHECK_STATUS(tree_init(), "failed to init kvs tree");
+        }
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t pmi_resizable_simple_internal::tree_init() {
+    std::string addr;
+    std::string parent_addr;
+
+    tree = std::unique_ptr<kvs_tree>(
+        new kvs_tree(k, rank, proc_count, ccl::global_data::env().kvs_tree_radix));
+
+    KVS_2_ATL_CHECK_STATUS(tree->listen(addr), "failed to listen on kvs tree");
+    ATL_CHECK_STATUS(kvs_set_value(KVS_TREE_ADDR, std::to_string(rank), addr),
+                     "failed to set kvs tree address");
+
+    int parent = tree->get_parent();
+    if (parent >= 0) {
+        ATL_CHECK_STATUS(kvs_get_value(KVS_TREE_ADDR, std::to_string(parent), parent_addr),
+                         "failed to get kvs tree address");
+        /* kvs values are zero padded */
+        parent_addr = parent_addr.c_str();
+    }
+
+    KVS_2_ATL_CHECK_STATUS(tree->connect(parent_addr), "failed to connect kvs tree");
+
+    return ATL_STATUS_SUCCESS;
+}
+
+atl_status_t pmi_resizable_simple_internal::tree_barrier() {
+    std::vector<char> payload;
+    std::vector<std::string> vals;
+    std::vector<std::string> items;
+
+    KVS_2_ATL_CHECK_STATUS(kvs_batch_encode(tree_pending_puts, payload),
+                           "failed to encode kvs tree puts");
+    tree_pending_puts.clear();
+
+    KVS_2_ATL_CHECK_STATUS(tree->allgather(std::string(payload.begin(), payload.end()), vals),
+                           "kvs tree barrier failed");
+
+    for (const auto& val : vals) {
+        payload.assign(val.begin(), val.end());
+        KVS_2_ATL_CHECK_STATUS(kvs_batch_decode(payload, items), "failed to decode kvs tree puts");
+        for (size_t idx = 0; idx + 1 < items.size(); idx += 2) {
+            tree_vals[items[idx]] = std::move(items[idx + 1]);
+        }
     }
 
     return ATL_STATUS_SUCCESS;
@@ -198,6 +253,8 @@ atl_status_t pmi_resizable_simple_internal::pmrt_wait_notification() {
 atl_status_t pmi_resizable_simple_internal::pmrt_finalize() {
     is_finalized = true;
     free(val_storage);
+    tree.reset();
+    tree_vals.clear();
 
     if (getenv("CCL_PMI_FORCE_FINALIZE")) {
         LOG_WARN("skip pmi_resizable_simple::pmrt_finalize\n");
@@ -215,6 +272,10 @@ atl_status_t pmi_resizable_simple_internal::pmrt_finalize() {
 }
 
 atl_status_t pmi_resizable_simple_internal::pmrt_barrier() {
+    if (tree) {
+        return tree_barrier();
+    }
+
     std::string empty_line("");
     std::string result_kvs_name = std::string(KVS_BARRIER) + std::to_string(local_id);
 
@@ -258,6 +319,11 @@ atl_status_t pmi_resizable_simple_internal::pmrt_kvs_put(char* kvs_key,
 
     ATL_CHECK_STATUS(kvs_set_value(KVS_NAME, key_storage.data(), val_storage), "failed to set val");
 
+    if (tree) {
+        tree_pending_puts.push_back(key_storage.data());
+        tree_pending_puts.push_back(val_storage);
+    }
+
     return ATL_STATUS_SUCCESS;
 }
 
@@ -286,8 +352,14 @@ atl_status_t pmi_resizable_simple_internal::pmrt_kvs_get(char* kvs_key,
         return ATL_STATUS_FAILURE;
     }
 
-    ATL_CHECK_STATUS(kvs_get_value(KVS_NAME, key_storage.data(), val_storage_str),
-                     "failed to get val");
+    auto it = tree_vals.find(key_storage.data());
+    if (it != tree_vals.end()) {
+        val_storage_str = it->second;
+    }
+    else {
+        ATL_CHECK_STATUS(kvs_get_value(KVS_NAME, key_storage.data(), val_storage_str),
+                         "failed to get val");
+    }
 
     ret = decode(val_storage_str.c_str(), kvs_val, kvs_val_len);
     if (ret) {
@@ -298,6 +370,60 @@ atl_status_t pmi_resizable_simple_internal::pmrt_kvs_get(char* kvs_key,
     return ATL_STATUS_SUCCESS;
 }
 
+atl_status_t pmi_resizable_simple_internal::pmrt_kvs_get_batch(char* kvs_key,
+                                                               const std::vector<int>& proc_idxs,
+                                                               void* kvs_vals,
+                                                               size_t kvs_val_len) {
+    if (strcmp(kvs_key, ATL_MPI_ROOT_RANK_KEY) == 0) {
+        return ipmi::pmrt_kvs_get_batch(kvs_key, proc_idxs, kvs_vals, kvs_val_len);
+    }
+
+    if (kvs_val_len > max_vallen) {
+        LOG_ERROR("asked len > max len");
+        return ATL_STATUS_FAILURE;
+    }
+
+    int ret;
+    std::vector<char> key_storage(max_keylen);
+    std::vector<std::string> keys(proc_idxs.size());
+    std::vector<std::string> vals;
+    bool all_cached = !tree_vals.empty();
+
+    for (size_t idx = 0; idx < proc_idxs.size(); idx++) {
+        ret = snprintf(key_storage.data(),
+                       max_keylen - 1,
+                       RESIZABLE_PMI_RT_KEY_FORMAT,
+                       kvs_key,
+                       proc_idxs[idx]);
+        if (ret < 0) {
+            LOG_ERROR("snprintf failed");
+            return ATL_STATUS_FAILURE;
+        }
+        keys[idx] = key_storage.data();
+        all_cached = all_cached && tree_vals.count(keys[idx]);
+    }
+
+    if (all_cached) {
+        vals.resize(keys.size());
+        for (size_t idx = 0; idx < keys.size(); idx++) {
+            vals[idx] = tree_vals[keys[idx]];
+        }
+    }
+    else {
+        ATL_CHECK_STATUS(kvs_get_values(KVS_NAME, keys, vals), "failed to get vals");
+    }
+
+    for (size_t idx = 0; idx < proc_idxs.size(); idx++) {
+        ret = decode(vals[idx].c_str(), (char*)kvs_vals + idx * kvs_val_len, kvs_val_len);
+        if (ret) {
+            LOG_ERROR("decode failed");
+            return ATL_STATUS_FAILURE;
+        }
+    }
+
+    return ATL_STATUS_SUCCESS;
+}
+
 int pmi_resizable_simple_internal::get_size() {
     return proc_count;
 }
@@ -355,6 +481,62 @@ atl_status_t pmi_resizable_simple_internal::kvs_get_value(const std::string& kvs
     return ATL_STATUS_SUCCESS;
 }
 
+atl_status_t pmi_resizable_simple_internal::kvs_get_values(const std::string& kvs_name,
+                                                           const std::vector<std::string>& keys,
+                                                           std::vector<std::string>& values) {
+    std::string result_kvs_name = kvs_name + std::to_string(local_id);
+
+    time_t start_time = time(NULL);
+    size_t kvs_get_time = 0;
+
+    /* only keys which are not published yet are requested again */
+    std::vector<size_t> missing_idxs(keys.size());
+    std::iota(missing_idxs.begin(), missing_idxs.end(), 0);
+    values.assign(keys.size(), std::string());
+
+    std::vector<std::string> missing_keys;
+    std::vector<std::string> missing_vals;
+
+    do {
+        missing_keys.clear();
+        for (auto idx : missing_idxs) {
+            missing_keys.push_back(keys[idx]);
+        }
+
+        KVS_2_ATL_CHECK_STATUS(
+            k->kvs_get_values_by_name_keys(result_kvs_name, missing_keys, missing_vals),
+            "failed to get values");
+
+        std::vector<size_t> still_missing_idxs;
+        for (size_t idx = 0; idx < missing_idxs.size(); idx++) {
+            if (missing_vals[idx].empty()) {
+                still_missing_idxs.push_back(missing_idxs[idx]);
+            }
+            else {
+                values[missing_idxs[idx]] = std::move(missing_vals[idx]);
+            }
+        }
+        missing_idxs.swap(still_missing_idxs);
+
+        kvs_get_time = time(NULL) - start_time;
+    } while (!missing_idxs.empty() && kvs_get_time < kvs_get_timeout);
+
+    if (!missing_idxs.empty()) {
+        LOG_ERROR("KVS get error: timeout limit: ",
+                  kvs_get_time,
+                  " > ",
+                  kvs_get_timeout,
+                  ", prefix: ",
+                  result_kvs_name.c_str(),
+                  ", missing keys: ",
+                  missing_idxs.size(),
+                  ", first key: ",
+                  keys[missing_idxs.front()]);
+        return ATL_STATUS_FAILURE;
+    }
+    return ATL_STATUS_SUCCESS;
+}
+
 atl_status_t pmi_resizable_simple_internal::get_local_kvs_id(size_t& res) {
     std::string local_kvs_id;
     res = 0;
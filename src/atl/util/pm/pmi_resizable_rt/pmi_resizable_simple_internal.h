@@ -21,6 +21,7 @@
 #include "atl/atl_def.h"
 #include "atl/mpi/atl_mpi.hpp"
 #include "atl/util/pm/pmi_resizable_rt/pmi_resizable/kvs/internal_kvs.h"
+#include "atl/util/pm/pmi_resizable_rt/pmi_resizable/kvs/kvs_tree.hpp"
 #include "util/pm/pmi_resizable_rt/pmi_resizable/helper.hpp"
 #include "atl/util/pm/pm_rt.h"
 
@@ -76,6 +77,11 @@ public:
                               void* kvs_val,
                               size_t kvs_val_len) override;
 
+    atl_status_t pmrt_kvs_get_batch(char* kvs_key,
+                                    const std::vector<int>& proc_idxs,
+                                    void* kvs_vals,
+                                    size_t kvs_val_len) override;
+
     int get_size() override;
 
     int get_rank() override;
@@ -103,11 +109,16 @@ private:
     atl_status_t kvs_get_value(const std::string& kvs_name,
                                const std::string& key,
                                std::string& value);
+    atl_status_t kvs_get_values(const std::string& kvs_name,
+                                const std::vector<std::string>& keys,
+                                std::vector<std::string>& values);
 
     atl_status_t pmrt_barrier_full();
     atl_status_t barrier_full_reg();
     atl_status_t barrier_reg();
     atl_status_t registration();
+    atl_status_t tree_init();
+    atl_status_t tree_barrier();
 
     int proc_count = 0;
     int rank = 0;
@@ -125,4 +136,11 @@ private:
     char* val_storage = nullptr;
     size_t local_id;
     size_t kvs_get_timeout = 60; /* in seconds */
+
+    /* rank-to-rank tree, replaces the kvs server barrier when CCL_KVS_TREE_RADIX is set */
+    std::unique_ptr<kvs_tree> tree;
+    /* key and encoded value of puts since the last barrier */
+    std::vector<std::string> tree_pending_puts;
+    /* puts of all ranks allgathered by tree barriers */
+    std::map<std::string, std::string> tree_vals;
 };
@@ -91,6 +91,20 @@ void ccl_get_segment_sizes(size_t dtype_size,
     }
 }
 
+void ccl_add_avg_scale(ccl_sched* sched,
+                       ccl_buffer buf,
+                       size_t count,
+                       const ccl_datatype& dtype,
+                       ccl::reduction reduction,
+                       ccl_comm* comm) {
+    if (reduction != ccl::reduction::avg || count == 0 || comm->size() == 1) {
+        return;
+    }
+
+    entry_factory::create<scale_entry>(sched, buf, count, dtype, comm->size());
+    sched->add_barrier();
+}
+
 bool ccl_is_ptr_aligned(uintptr_t ptr, size_t alignment) {
     CCL_THROW_IF_NOT(alignment != 0, "memory alignment cannot be 0 by definition");
     return (ptr % alignment) == 0;
@@ -98,7 +112,7 @@ bool ccl_is_ptr_aligned(uintptr_t ptr, size_t alignment) {
 
 #if defined(CCL_ENABLE_ZE) && defined(CCL_ENABLE_SYCL)
 
-using entry_iterator = std::deque<std::unique_ptr<sched_entry>>::iterator;
+using entry_iterator = std::deque<ccl_sched::sched_entry_ptr>::iterator;
 
 static bool is_reorderable_algo(const char* algo_name) {
     const char* reordable_algo_prefixes[] = {
@@ -58,9 +58,11 @@ enum ccl_coll_allreduce_algo {
     ccl_coll_allreduce_nreduce,
     ccl_coll_allreduce_ring,
     ccl_coll_allreduce_ring_rma,
+    ccl_coll_allreduce_ring_pipelined,
     ccl_coll_allreduce_double_tree,
     ccl_coll_allreduce_recursive_doubling,
     ccl_coll_allreduce_2d,
+    ccl_coll_allreduce_hier,
     ccl_coll_allreduce_topo
 };
 
@@ -86,7 +88,9 @@ enum ccl_coll_barrier_algo {
     ccl_coll_barrier_undefined = 0,
 
     ccl_coll_barrier_direct,
-    ccl_coll_barrier_ring
+    ccl_coll_barrier_ring,
+    ccl_coll_barrier_tree,
+    ccl_coll_barrier_shm
 };
 
 enum ccl_coll_bcast_algo {
@@ -214,9 +218,22 @@ void ccl_get_segment_sizes(size_t dtype_size,
                            std::vector<size_t>& seg_sizes);
 
 class ccl_sched;
+class ccl_comm;
+class ccl_datatype;
+
+/*
+   partial results of average reduction are accumulated as sum,
+   adds division by comm size of the final result followed by barrier,
+   does nothing for other reductions
+*/
+void ccl_add_avg_scale(ccl_sched* sched,
+                       ccl_buffer buf,
+                       size_t count,
+                       const ccl_datatype& dtype,
+                       ccl::reduction reduction,
+                       ccl_comm* comm);
 
 #if defined(CCL_ENABLE_ZE) && defined(CCL_ENABLE_SYCL)
-class ccl_comm;
 
 std::optional<size_t> ccl_get_pipe_size(const size_t buf_size,
                                         const size_t dtype_size,
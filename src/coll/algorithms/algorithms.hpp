@@ -105,6 +105,19 @@ ccl::status ccl_coll_build_ring_allreduce(ccl_sched* sched,
                                           const ccl_datatype& dtype,
                                           ccl::reduction reduction,
                                           ccl_comm* comm);
+ccl::status ccl_coll_build_ring_allreduce_segments(ccl_sched* sched,
+                                                   const std::vector<ccl_buffer>& bufs,
+                                                   const std::vector<size_t>& counts,
+                                                   const ccl_datatype& dtype,
+                                                   ccl::reduction reduction,
+                                                   ccl_comm* comm);
+ccl::status ccl_coll_build_ring_pipelined_allreduce(ccl_sched* sched,
+                                                    ccl_buffer send_buf,
+                                                    ccl_buffer recv_buf,
+                                                    size_t count,
+                                                    const ccl_datatype& dtype,
+                                                    ccl::reduction reduction,
+                                                    ccl_comm* comm);
 ccl::status ccl_coll_build_ring_rma_allreduce(ccl_sched* sched,
                                               ccl_buffer send_buf,
                                               ccl_buffer recv_buf,
@@ -126,6 +139,13 @@ ccl::status ccl_coll_build_2d_allreduce(ccl_sched* sched,
                                         const ccl_datatype& dtype,
                                         ccl::reduction reduction,
                                         ccl_comm* comm);
+ccl::status ccl_coll_build_hier_allreduce(ccl_sched* sched,
+                                          ccl_buffer send_buf,
+                                          ccl_buffer recv_buf,
+                                          size_t count,
+                                          const ccl_datatype& dtype,
+                                          ccl::reduction reduction,
+                                          ccl_comm* comm);
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
 ccl::status ccl_coll_build_topo_allreduce(ccl_sched* sched,
                                           ccl_buffer send_buf,
@@ -166,6 +186,8 @@ ccl::status ccl_coll_build_topo_alltoallv(ccl_sched* main_sched,
 // barrier
 ccl::status ccl_coll_build_direct_barrier(ccl_sched* sched, ccl_comm* comm);
 ccl::status ccl_coll_build_dissemination_barrier(ccl_sched* sched, ccl_comm* comm);
+ccl::status ccl_coll_build_tree_barrier(ccl_sched* sched, ccl_comm* comm);
+ccl::status ccl_coll_build_shm_barrier(ccl_sched* sched, ccl_comm* comm);
 
 // bcast
 ccl::status ccl_coll_build_direct_bcast(ccl_sched* sched,
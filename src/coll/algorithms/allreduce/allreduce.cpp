@@ -49,7 +49,13 @@ ccl::status ccl_coll_build_direct_allreduce(ccl_sched* sched,
         return ccl::status::success;
     }
 
-    entry_factory::create<allreduce_entry>(sched, send_buf, recv_buf, count, dtype, op, comm);
+    // transport has no average operation, the sum is scaled locally
+    ccl::reduction entry_op = (op == ccl::reduction::avg) ? ccl::reduction::sum : op;
+    entry_factory::create<allreduce_entry>(sched, send_buf, recv_buf, count, dtype, entry_op, comm);
+    if (op == ccl::reduction::avg) {
+        sched->add_barrier();
+        ccl_add_avg_scale(sched, recv_buf, count, dtype, op, comm);
+    }
     return ccl::status::success;
 }
 
@@ -229,6 +235,10 @@ ccl::status ccl_coll_build_rabenseifner_allreduce(ccl_sched* sched,
                 last_idx = recv_idx + pof2 / mask;
         }
 
+        /* own block is fully reduced, scale it before it is distributed */
+        ccl_add_avg_scale(
+            sched, recv_buf + disps[send_idx] * dtype_size, cnts[send_idx], dtype, op, comm);
+
         /* now do the allgather */
 
         mask >>= 1;
@@ -393,6 +403,8 @@ ccl::status ccl_coll_build_nreduce_allreduce(ccl_sched* sched,
 
         sched->add_barrier();
 
+        ccl_add_avg_scale(sched, reduce_buf, elem_count, dtype, op, comm);
+
         // allgatherv
         if (use_buffering) {
             copy_attr attr;
@@ -479,6 +491,14 @@ ccl::status ccl_coll_build_ring_allreduce(ccl_sched* sched,
         recv_counts[comm_size - 1] = last_block_count;
     }
 
+    // own block is fully reduced, scale it before allgatherv
+    ccl_add_avg_scale(sched,
+                      recv_buf + comm->rank() * main_block_count * dtype.size(),
+                      recv_counts[comm->rank()],
+                      dtype,
+                      op,
+                      comm);
+
     // Due to the allreduce and allgatherv API differences, we have to
     // prepare device buffers for copy overlapping.
     // Transform single buffer to the array of buffers with offsets.
@@ -537,6 +557,318 @@ ccl::status ccl_coll_build_ring_allreduce(ccl_sched* sched,
     return status;
 }
 
+/* calls fn for parts of user buffers which form [offset, offset + count) of the fused vector */
+static void ccl_allreduce_segments_for_range(
+    const std::vector<ccl_buffer>& bufs,
+    const std::vector<size_t>& counts,
+    size_t offset,
+    size_t count,
+    size_t dtype_size,
+    const std::function<void(ccl_buffer buf, size_t count, size_t range_offset)>& fn) {
+    size_t seg_start = 0;
+    size_t range_end = offset + count;
+    for (size_t idx = 0; idx < bufs.size() && seg_start < range_end; idx++) {
+        size_t seg_end = seg_start + counts[idx];
+        size_t part_start = std::max(seg_start, offset);
+        size_t part_end = std::min(seg_end, range_end);
+        if (part_start < part_end) {
+            ccl_buffer buf = bufs[idx];
+            fn(buf + (part_start - seg_start) * dtype_size,
+               part_end - part_start,
+               part_start - offset);
+        }
+        seg_start = seg_end;
+    }
+}
+
+/*
+   ring allreduce over the vector formed by concatenation of in-place buffers,
+   blocks are sent and reduced directly from/to the buffers, without packing,
+   peers split blocks identically, so per-part messages are matched in order
+*/
+ccl::status ccl_coll_build_ring_allreduce_segments(ccl_sched* sched,
+                                                   const std::vector<ccl_buffer>& bufs,
+                                                   const std::vector<size_t>& counts,
+                                                   const ccl_datatype& dtype,
+                                                   ccl::reduction op,
+                                                   ccl_comm* comm) {
+    CCL_THROW_IF_NOT(sched && !bufs.empty() && bufs.size() == counts.size(),
+                     "incorrect values, sched ",
+                     sched,
+                     ", bufs ",
+                     bufs.size(),
+                     ", counts ",
+                     counts.size());
+
+    size_t count = std::accumulate(counts.begin(), counts.end(), size_t(0));
+    int comm_size = comm->size();
+    int rank = comm->rank();
+
+    LOG_DEBUG("build ring allreduce over ", bufs.size(), " segments, count ", count);
+
+    if (count == 0 || comm_size == 1) {
+        return ccl::status::success;
+    }
+
+    size_t dtype_size = dtype.size();
+    size_t main_block_count = count / comm_size;
+    size_t last_block_count = main_block_count + count % comm_size;
+
+    auto block_count = [&](int block) {
+        return (block == comm_size - 1) ? last_block_count : main_block_count;
+    };
+
+    ccl_buffer tmp_buf = sched->alloc_buffer({ last_block_count * dtype_size, bufs[0] });
+
+    int src = (rank - 1 + comm_size) % comm_size;
+    int dst = (rank + 1) % comm_size;
+
+    /* reduce-scatter: after the last step rank owns reduced block (rank + 1) */
+    for (int step = 0; step < comm_size - 1; step++) {
+        int send_block = (rank - step + comm_size) % comm_size;
+        int recv_block = (rank - step - 1 + comm_size) % comm_size;
+
+        ccl_allreduce_segments_for_range(
+            bufs,
+            counts,
+            send_block * main_block_count,
+            block_count(send_block),
+            dtype_size,
+            [&](ccl_buffer buf, size_t part_count, size_t range_offset) {
+                entry_factory::create<send_entry>(sched, buf, part_count, dtype, dst, comm);
+            });
+
+        ccl_allreduce_segments_for_range(
+            bufs,
+            counts,
+            recv_block * main_block_count,
+            block_count(recv_block),
+            dtype_size,
+            [&](ccl_buffer buf, size_t part_count, size_t range_offset) {
+                entry_factory::create<recv_reduce_entry>(sched,
+                                                         buf,
+                                                         part_count,
+                                                         dtype,
+                                                         op,
+                                                         src,
+                                                         comm,
+                                                         tmp_buf + range_offset * dtype_size);
+            });
+
+        sched->add_barrier();
+    }
+
+    int own_block = (rank + 1) % comm_size;
+    ccl_allreduce_segments_for_range(
+        bufs,
+        counts,
+        own_block * main_block_count,
+        block_count(own_block),
+        dtype_size,
+        [&](ccl_buffer buf, size_t part_count, size_t range_offset) {
+            ccl_add_avg_scale(sched, buf, part_count, dtype, op, comm);
+        });
+
+    /* allgather of reduced blocks */
+    for (int step = 0; step < comm_size - 1; step++) {
+        int send_block = (rank + 1 - step + comm_size) % comm_size;
+        int recv_block = (rank - step + comm_size) % comm_size;
+
+        ccl_allreduce_segments_for_range(
+            bufs,
+            counts,
+            send_block * main_block_count,
+            block_count(send_block),
+            dtype_size,
+            [&](ccl_buffer buf, size_t part_count, size_t range_offset) {
+                entry_factory::create<send_entry>(sched, buf, part_count, dtype, dst, comm);
+            });
+
+        ccl_allreduce_segments_for_range(
+            bufs,
+            counts,
+            recv_block * main_block_count,
+            block_count(recv_block),
+            dtype_size,
+            [&](ccl_buffer buf, size_t part_count, size_t range_offset) {
+                entry_factory::create<recv_entry>(sched, buf, part_count, dtype, src, comm);
+            });
+
+        sched->add_barrier();
+    }
+
+    return ccl::status::success;
+}
+
+/*
+   ring allreduce over segments of the buffer, the segments are processed as a wavefront:
+   on global step t segment k runs ring step (t - k), so allgather of earlier segments
+   overlaps with reduce-scatter of later ones and the ring pipeline stays busy
+*/
+ccl::status ccl_coll_build_ring_pipelined_allreduce(ccl_sched* sched,
+                                                    ccl_buffer send_buf,
+                                                    ccl_buffer recv_buf,
+                                                    size_t count,
+                                                    const ccl_datatype& dtype,
+                                                    ccl::reduction op,
+                                                    ccl_comm* comm) {
+    CCL_THROW_IF_NOT(sched && send_buf && recv_buf,
+                     "incorrect values, sched ",
+                     sched,
+                     ", send ",
+                     send_buf,
+                     " recv ",
+                     recv_buf);
+
+    ccl::status status = ccl::status::success;
+
+    if (count == 0) {
+        return status;
+    }
+
+    int comm_size = comm->size();
+    int rank = comm->rank();
+    size_t dtype_size = dtype.size();
+    bool is_inplace = (send_buf == recv_buf);
+
+    if (comm_size == 1) {
+        if (!is_inplace) {
+            entry_factory::create<copy_entry>(sched, send_buf, recv_buf, count, dtype);
+        }
+        return status;
+    }
+
+    size_t seg_count =
+        std::max(ccl::global_data::env().allreduce_ring_segment_size / dtype_size,
+                 static_cast<size_t>(comm_size));
+    size_t seg_num = (count + seg_count - 1) / seg_count;
+    int step_count = 2 * (comm_size - 1);
+
+    LOG_DEBUG("build ring_pipelined allreduce, count ",
+              count,
+              ", seg_count ",
+              seg_count,
+              ", seg_num ",
+              seg_num);
+
+    auto get_seg_count = [&](size_t seg_idx) {
+        return (seg_idx == seg_num - 1) ? count - seg_idx * seg_count : seg_count;
+    };
+    auto get_block_count = [&](size_t seg_idx, int block) {
+        size_t cnt = get_seg_count(seg_idx);
+        return cnt / comm_size + ((block == comm_size - 1) ? cnt % comm_size : 0);
+    };
+    auto get_block_buf = [&](ccl_buffer buf, size_t seg_idx, int block) {
+        return buf + (seg_idx * seg_count + block * (get_seg_count(seg_idx) / comm_size)) *
+                         dtype_size;
+    };
+    auto add_seg_copy = [&](size_t seg_idx) {
+        entry_factory::create<copy_entry>(sched,
+                                          send_buf + seg_idx * seg_count * dtype_size,
+                                          recv_buf + seg_idx * seg_count * dtype_size,
+                                          get_seg_count(seg_idx),
+                                          dtype);
+    };
+
+    /* at most (comm_size - 1) segments are in reduce-scatter phase at the same time */
+    size_t slot_count = std::min(seg_num, static_cast<size_t>(comm_size - 1));
+    size_t slot_size = std::max(get_block_count(0, comm_size - 1),
+                                get_block_count(seg_num - 1, comm_size - 1)) *
+                       dtype_size;
+    ccl_buffer tmp_buf = sched->alloc_buffer({ slot_count * slot_size, send_buf });
+
+    int src = (rank - 1 + comm_size) % comm_size;
+    int dst = (rank + 1) % comm_size;
+
+    if (!is_inplace) {
+        add_seg_copy(0);
+        sched->add_barrier();
+    }
+
+    size_t global_step_count = seg_num + step_count - 1;
+    for (size_t global_step = 0; global_step < global_step_count; global_step++) {
+        size_t first_seg = (global_step >= static_cast<size_t>(step_count))
+                               ? global_step - step_count + 1
+                               : 0;
+        size_t last_seg = std::min(global_step, seg_num - 1);
+
+        /* segment which completes reduce-scatter owns reduced block (rank + 1) */
+        if (global_step >= static_cast<size_t>(comm_size - 1)) {
+            size_t seg_idx = global_step - (comm_size - 1);
+            int own_block = (rank + 1) % comm_size;
+            if (seg_idx < seg_num) {
+                ccl_add_avg_scale(sched,
+                                  get_block_buf(recv_buf, seg_idx, own_block),
+                                  get_block_count(seg_idx, own_block),
+                                  dtype,
+                                  op,
+                                  comm);
+            }
+        }
+
+        /* all ranks create entries in the same segment order, so messages are matched in order */
+        for (size_t seg_idx = first_seg; seg_idx <= last_seg; seg_idx++) {
+            int step = static_cast<int>(global_step - seg_idx);
+            int send_block, recv_block;
+
+            if (step < comm_size - 1) {
+                send_block = (rank - step + comm_size) % comm_size;
+                recv_block = (rank - step - 1 + comm_size) % comm_size;
+            }
+            else {
+                int ag_step = step - (comm_size - 1);
+                send_block = (rank + 1 - ag_step + comm_size) % comm_size;
+                recv_block = (rank - ag_step + comm_size) % comm_size;
+            }
+
+            size_t send_count = get_block_count(seg_idx, send_block);
+            size_t recv_count = get_block_count(seg_idx, recv_block);
+
+            if (send_count) {
+                entry_factory::create<send_entry>(sched,
+                                                  get_block_buf(recv_buf, seg_idx, send_block),
+                                                  send_count,
+                                                  dtype,
+                                                  dst,
+                                                  comm);
+            }
+
+            if (!recv_count) {
+                continue;
+            }
+
+            if (step < comm_size - 1) {
+                entry_factory::create<recv_reduce_entry>(
+                    sched,
+                    get_block_buf(recv_buf, seg_idx, recv_block),
+                    recv_count,
+                    dtype,
+                    op,
+                    src,
+                    comm,
+                    tmp_buf + (seg_idx % slot_count) * slot_size);
+            }
+            else {
+                entry_factory::create<recv_entry>(sched,
+                                                  get_block_buf(recv_buf, seg_idx, recv_block),
+                                                  recv_count,
+                                                  dtype,
+                                                  src,
+                                                  comm);
+            }
+        }
+
+        /* segment which joins the wavefront on the next step is copied in the shadow of comms */
+        if (!is_inplace && global_step + 1 < seg_num) {
+            add_seg_copy(global_step + 1);
+        }
+
+        sched->add_barrier();
+    }
+
+    return status;
+}
+
 ccl::status ccl_coll_build_recursive_doubling_allreduce(ccl_sched* sched,
                                                         ccl_buffer send_buf,
                                                         ccl_buffer recv_buf,
@@ -614,27 +946,55 @@ ccl::status ccl_coll_build_recursive_doubling_allreduce(ccl_sched* sched,
         newrank = rank - rem;
 
     if (newrank != -1) {
+        /* steps are ordered through entry dependencies instead of barriers:
+         * receive of the next step is posted in advance into the second tmp buffer,
+         * send waits only for the reduction of the previous step */
+        ccl_buffer step_tmp_bufs[2] = { tmp_buf, tmp_buf };
+        if (pof2 > 2) {
+            step_tmp_bufs[1] = sched->alloc_buffer({ count * dtype_size, send_buf });
+        }
+
+        sched_entry* prev_reduce = nullptr;
+        sched_entry* prev_prev_reduce = nullptr;
+        size_t step = 0;
+
         mask = 0x1;
         while (mask < pof2) {
             newdst = newrank ^ mask;
             /* find real rank of dest */
             dst = (newdst < rem) ? newdst * 2 + 1 : newdst + rem;
 
+            ccl_buffer step_tmp_buf = step_tmp_bufs[step % 2];
+
             /* Send the most current data, which is in recv_buf. Recv
              * into tmp_buf */
-            entry_factory::create<recv_entry>(sched, tmp_buf, count, dtype, dst, comm);
-            /* sendrecv, no barrier here */
-            entry_factory::create<send_entry>(sched, recv_buf, count, dtype, dst, comm);
-            sched->add_barrier();
+            auto recv = entry_factory::create<recv_entry>(
+                sched, step_tmp_buf, count, dtype, dst, comm);
+            auto send = entry_factory::create<send_entry>(sched, recv_buf, count, dtype, dst, comm);
 
             /* tmp_buf contains data received in this step.
              * recv_buf contains data accumulated so far */
-            entry_factory::create<reduce_local_entry>(
-                sched, tmp_buf, count, recv_buf, nullptr, dtype, op);
-            sched->add_barrier();
+            auto reduce = entry_factory::create<reduce_local_entry>(
+                sched, step_tmp_buf, count, recv_buf, nullptr, dtype, op);
 
+            /* tmp buffer is reused after two steps */
+            if (prev_prev_reduce) {
+                sched->add_dependency(recv, prev_prev_reduce);
+            }
+            if (prev_reduce) {
+                sched->add_dependency(send, prev_reduce);
+            }
+            sched->add_dependency(reduce, recv);
+            sched->add_dependency(reduce, send);
+
+            prev_prev_reduce = prev_reduce;
+            prev_reduce = reduce;
+            step++;
             mask <<= 1;
         }
+        sched->add_barrier();
+
+        ccl_add_avg_scale(sched, recv_buf, count, dtype, op, comm);
     }
 
     /* In the non-power-of-two case, all odd-numbered
@@ -674,13 +1034,17 @@ static void ccl_allreduce_2d_add_allreduce_allgather(ccl_sched* sched,
     size_t last_block_count = main_block_count + cnt % first_dim_comm->size();
     size_t ar_count = (first_dim_comm->rank() == (first_dim_comm->size() - 1)) ? last_block_count
                                                                                : main_block_count;
+    ccl::reduction sum_op = (op == ccl::reduction::avg) ? ccl::reduction::sum : op;
 
     if (ar_count) {
         // TODO: add second level selection to distinguish high and low level algorithms
         ccl_buffer ar_buf = rbuf + first_dim_comm->rank() * main_block_count * dtype_size;
         ccl_coll_build_nreduce_allreduce(
-            sched, ar_buf, ar_buf, ar_count, dtype, op, second_dim_comm);
+            sched, ar_buf, ar_buf, ar_count, dtype, sum_op, second_dim_comm);
         sched->add_barrier();
+
+        // sub-collectives accumulate sum, the result is scaled by the full comm size
+        ccl_add_avg_scale(sched, ar_buf, ar_count, dtype, op, comm);
     }
 
     std::vector<size_t> ag_recv_counts(first_dim_comm->size(), main_block_count);
@@ -719,7 +1083,9 @@ static void ccl_allreduce_2d_add_reduce_scatter_allreduce_allgather(ccl_sched* s
     ccl_buffer sbuf = send_buf + chunk_idx * main_chunk_size * dtype_size;
     ccl_buffer rbuf = recv_buf + chunk_idx * main_chunk_size * dtype_size;
 
-    ccl_coll_build_reduce_scatter(sched, sbuf, rbuf, cnt, dtype, op, first_dim_comm, false, true);
+    ccl::reduction sum_op = (op == ccl::reduction::avg) ? ccl::reduction::sum : op;
+    ccl_coll_build_reduce_scatter(
+        sched, sbuf, rbuf, cnt, dtype, sum_op, first_dim_comm, false, true);
     sched->add_barrier();
 
     if (chunk_idx == (chunk_count - 1) || (chunk_count == 1)) {
@@ -842,6 +1208,95 @@ ccl::status ccl_coll_build_2d_allreduce(ccl_sched* sched,
     return status;
 }
 
+ccl::status ccl_coll_build_hier_allreduce(ccl_sched* sched,
+                                          ccl_buffer send_buf,
+                                          ccl_buffer recv_buf,
+                                          size_t count,
+                                          const ccl_datatype& dtype,
+                                          ccl::reduction op,
+                                          ccl_comm* comm) {
+    ccl::status status = ccl::status::success;
+
+    if (count == 0) {
+        return status;
+    }
+
+    ccl_comm* socket_comm = comm->get_socket_comm().get();
+    ccl_comm* socket_leaders_comm = comm->get_socket_leaders_comm().get();
+    ccl_comm* node_leaders_comm = comm->get_node_leaders_comm().get();
+
+    bool is_socket_leader = (socket_comm->rank() == 0);
+    bool is_node_leader = is_socket_leader && (socket_leaders_comm->rank() == 0);
+
+    LOG_DEBUG("build hier allreduce: comm: ",
+              comm->to_string(),
+              ", socket comm: ",
+              socket_comm->to_string(),
+              ", socket leaders comm: ",
+              socket_leaders_comm->to_string(),
+              ", node leaders comm: ",
+              node_leaders_comm->to_string(),
+              ", socket leader: ",
+              is_socket_leader,
+              ", node leader: ",
+              is_node_leader);
+
+    // sub-collectives accumulate sum, the result is scaled by the full comm size
+    ccl::reduction sum_op = (op == ccl::reduction::avg) ? ccl::reduction::sum : op;
+
+    // hint of the allreduce must not be interpreted by sub-collectives
+    ccl_coll_algo hint_algo = sched->hint_algo;
+    sched->hint_algo = {};
+
+    // 1. reduce inside of the socket to the socket leader
+    if (socket_comm->size() > 1) {
+        CCL_CALL(ccl_coll_build_reduce(
+            sched, send_buf, recv_buf, count, dtype, sum_op, 0, socket_comm, false));
+        sched->add_barrier();
+    }
+    else if (send_buf != recv_buf) {
+        entry_factory::create<copy_entry>(sched, send_buf, recv_buf, count, dtype);
+        sched->add_barrier();
+    }
+
+    // 2. reduce across sockets of the node to the node leader, crosses the socket interconnect
+    if (is_socket_leader && socket_leaders_comm->size() > 1) {
+        CCL_CALL(ccl_coll_build_reduce(
+            sched, recv_buf, recv_buf, count, dtype, sum_op, 0, socket_leaders_comm, false));
+        sched->add_barrier();
+    }
+
+    // 3. allreduce between node leaders, only one rank per node uses the network
+    if (is_node_leader) {
+        if (node_leaders_comm->size() > 1) {
+            CCL_CALL(ccl_coll_build_ring_allreduce(sched,
+                                                   recv_buf,
+                                                   recv_buf,
+                                                   count,
+                                                   std::vector<ccl_buffer>{},
+                                                   dtype,
+                                                   sum_op,
+                                                   node_leaders_comm));
+            sched->add_barrier();
+        }
+        ccl_add_avg_scale(sched, recv_buf, count, dtype, op, comm);
+    }
+
+    // 4. broadcast back along the same tree
+    if (is_socket_leader && socket_leaders_comm->size() > 1) {
+        CCL_CALL(ccl_coll_build_bcast(sched, recv_buf, count, dtype, 0, socket_leaders_comm));
+        sched->add_barrier();
+    }
+
+    if (socket_comm->size() > 1) {
+        CCL_CALL(ccl_coll_build_bcast(sched, recv_buf, count, dtype, 0, socket_comm));
+    }
+
+    sched->hint_algo = hint_algo;
+
+    return status;
+}
+
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
 
 ccl::status ccl_coll_build_topo_allreduce_fill(ccl_sched* sched,
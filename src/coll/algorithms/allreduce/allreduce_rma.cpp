@@ -388,6 +388,14 @@ ccl::status ccl_coll_build_ring_rma_allreduce(ccl_sched* sched,
                                                   op);
     }
 
+    /* the last reduced block is owned by this rank, scale it before allgather */
+    if (op == ccl::reduction::avg) {
+        size_t own_block_count =
+            main_block_count + ((block_idx == (comm_size - 1)) ? count % comm_size : 0);
+        sched->add_barrier();
+        ccl_add_avg_scale(sched, recv_buf + buf_offset, own_block_count, dtype, op, comm);
+    }
+
     /* allgather */
     size_t flag_idx_offset = (comm_size - 1);
     for (idx = 0; idx < (comm_size - 1); idx++) {
@@ -29,25 +29,141 @@ ccl::status ccl_coll_build_direct_barrier(ccl_sched* sched, ccl_comm* comm) {
     return ccl::status::success;
 }
 
+static size_t ccl_coll_get_barrier_radix(int size) {
+    return std::min(ccl::global_data::env().barrier_radix, static_cast<size_t>(size));
+}
+
 ccl::status ccl_coll_build_dissemination_barrier(ccl_sched* sched, ccl_comm* comm) {
     LOG_DEBUG("build dissemination barrier");
 
     ccl::status status = ccl::status::success;
-    int size, rank, src, dst, mask;
+    int size, rank, src, dst;
     size = comm->size();
     rank = comm->rank();
 
     if (size == 1)
         return status;
 
-    mask = 0x1;
-    while (mask < size) {
-        dst = (rank + mask) % size;
-        src = (rank - mask + size) % size;
-        entry_factory::create<send_entry>(sched, ccl_buffer(), 0, ccl_datatype_int8, dst, comm);
-        entry_factory::create<recv_entry>(sched, ccl_buffer(), 0, ccl_datatype_int8, src, comm);
+    /*
+       k-ary dissemination: in every round the rank notifies radix - 1 peers
+       at distance idx * dist and after ceil(log_radix(size)) rounds
+       it has heard from every rank transitively
+    */
+    size_t radix = ccl_coll_get_barrier_radix(size);
+    for (size_t dist = 1; dist < static_cast<size_t>(size); dist *= radix) {
+        for (size_t idx = 1; idx < radix && idx * dist < static_cast<size_t>(size); idx++) {
+            int offset = static_cast<int>(idx * dist);
+            dst = (rank + offset) % size;
+            src = (rank - offset + size) % size;
+            entry_factory::create<send_entry>(
+                sched, ccl_buffer(), 0, ccl_datatype_int8, dst, comm);
+            entry_factory::create<recv_entry>(
+                sched, ccl_buffer(), 0, ccl_datatype_int8, src, comm);
+        }
+        sched->add_barrier();
+    }
+
+    return status;
+}
+
+/* k-ary tree rooted at rank 0, children of rank r are r * radix + 1 ... r * radix + radix */
+static void ccl_coll_add_tree_barrier_gather(ccl_sched* sched, ccl_comm* comm) {
+    int size = comm->size();
+    int rank = comm->rank();
+
+    if (size == 1)
+        return;
+
+    size_t radix = ccl_coll_get_barrier_radix(size);
+    for (size_t child = rank * radix + 1; child <= rank * radix + radix; child++) {
+        if (child >= static_cast<size_t>(size))
+            break;
+        entry_factory::create<recv_entry>(
+            sched, ccl_buffer(), 0, ccl_datatype_int8, static_cast<int>(child), comm);
+    }
+    sched->add_barrier();
+
+    if (rank != 0) {
+        int parent = static_cast<int>((rank - 1) / radix);
+        entry_factory::create<send_entry>(sched, ccl_buffer(), 0, ccl_datatype_int8, parent, comm);
+        sched->add_barrier();
+    }
+}
+
+static void ccl_coll_add_tree_barrier_release(ccl_sched* sched, ccl_comm* comm) {
+    int size = comm->size();
+    int rank = comm->rank();
+
+    if (size == 1)
+        return;
+
+    size_t radix = ccl_coll_get_barrier_radix(size);
+    if (rank != 0) {
+        int parent = static_cast<int>((rank - 1) / radix);
+        entry_factory::create<recv_entry>(sched, ccl_buffer(), 0, ccl_datatype_int8, parent, comm);
         sched->add_barrier();
-        mask <<= 1;
+    }
+
+    for (size_t child = rank * radix + 1; child <= rank * radix + radix; child++) {
+        if (child >= static_cast<size_t>(size))
+            break;
+        entry_factory::create<send_entry>(
+            sched, ccl_buffer(), 0, ccl_datatype_int8, static_cast<int>(child), comm);
+    }
+    sched->add_barrier();
+}
+
+ccl::status ccl_coll_build_tree_barrier(ccl_sched* sched, ccl_comm* comm) {
+    LOG_DEBUG("build tree barrier");
+
+    ccl_coll_add_tree_barrier_gather(sched, comm);
+    ccl_coll_add_tree_barrier_release(sched, comm);
+
+    return ccl::status::success;
+}
+
+/*
+   hierarchical barrier:
+   1. gather on the node leader over shared memory flags
+      (tree over node_comm if shared memory is not available)
+   2. dissemination barrier among node leaders
+   3. release from the node leader
+*/
+ccl::status ccl_coll_build_shm_barrier(ccl_sched* sched, ccl_comm* comm) {
+    LOG_DEBUG("build shm barrier");
+
+    ccl::status status = ccl::status::success;
+
+    if (comm->size() == 1)
+        return status;
+
+    CCL_THROW_IF_NOT(comm->has_hier_subcomms(), "shm barrier requires node subcomms");
+
+    ccl_comm* node_comm = comm->get_node_comm().get();
+    ccl_comm* node_leaders_comm = comm->get_node_leaders_comm().get();
+    std::shared_ptr<ccl_shm_barrier> shm_barrier = comm->get_shm_barrier();
+
+    shm_barrier_entry* gather_entry = nullptr;
+    if (shm_barrier) {
+        gather_entry = entry_factory::create<shm_barrier_entry>(
+            sched, shm_barrier, shm_barrier_phase::gather);
+        sched->add_barrier();
+    }
+    else {
+        ccl_coll_add_tree_barrier_gather(sched, node_comm);
+    }
+
+    if (node_comm->rank() == 0) {
+        CCL_CALL(ccl_coll_build_dissemination_barrier(sched, node_leaders_comm));
+    }
+
+    if (shm_barrier) {
+        entry_factory::create<shm_barrier_entry>(
+            sched, shm_barrier, shm_barrier_phase::release, gather_entry);
+        sched->add_barrier();
+    }
+    else {
+        ccl_coll_add_tree_barrier_release(sched, node_comm);
     }
 
     return status;
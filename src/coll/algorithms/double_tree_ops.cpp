@@ -13,6 +13,7 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include "coll/algorithms/algorithm_utils.hpp"
 #include "common/utils/tree.hpp"
 #include "sched/entry/factory/entry_factory.hpp"
 #include "sched/sched.hpp"
@@ -75,43 +76,59 @@ static void reduce_bcast_tree(const ccl_bin_tree& tree,
                               const ccl_datatype& dtype,
                               ccl::reduction reduction,
                               ccl_comm* comm) {
+    /* reduce and bcast phases are ordered through entry dependencies, not barriers */
+    std::vector<sched_entry*> reduce_entries;
     if (tree.left() != -1) {
         LOG_DEBUG("recv_reduce left ", tree.left());
-        entry_factory::create<recv_reduce_entry>(
-            sched, buffer, count, dtype, reduction, static_cast<size_t>(tree.left()), comm);
+        reduce_entries.push_back(entry_factory::create<recv_reduce_entry>(
+            sched, buffer, count, dtype, reduction, static_cast<size_t>(tree.left()), comm));
     }
     if (tree.right() != -1) {
         LOG_DEBUG("recv_reduce right ", tree.right());
-        entry_factory::create<recv_reduce_entry>(
-            sched, buffer, count, dtype, reduction, static_cast<size_t>(tree.right()), comm);
+        reduce_entries.push_back(entry_factory::create<recv_reduce_entry>(
+            sched, buffer, count, dtype, reduction, static_cast<size_t>(tree.right()), comm));
     }
-    if (tree.parent() != -1) {
-        if (tree.left() != -1 || tree.right() != -1) {
-            sched->add_barrier();
-        }
 
+    /* entries which have to be completed before the result is sent to children */
+    std::vector<sched_entry*> bcast_deps;
+    if (tree.parent() != -1) {
         LOG_DEBUG("send to parent ", tree.parent());
-        entry_factory::create<send_entry>(
+        auto send = entry_factory::create<send_entry>(
             sched, buffer, count, dtype, static_cast<size_t>(tree.parent()), comm);
+        for (auto reduce : reduce_entries) {
+            sched->add_dependency(send, reduce);
+        }
 
+        /* parent replies only after our send, so the receive is posted in advance */
         LOG_DEBUG("recv from parent ", tree.parent());
-        entry_factory::create<recv_entry>(
-            sched, buffer, count, dtype, static_cast<size_t>(tree.parent()), comm);
+        bcast_deps.push_back(entry_factory::create<recv_entry>(
+            sched, buffer, count, dtype, static_cast<size_t>(tree.parent()), comm));
     }
+    else {
+        bcast_deps = reduce_entries;
 
-    if (tree.left() != -1 || tree.right() != -1) {
-        sched->add_barrier();
+        /* root has the final result, children receive it already scaled */
+        if (reduction == ccl::reduction::avg) {
+            sched->add_barrier();
+            ccl_add_avg_scale(sched, buffer, count, dtype, reduction, comm);
+        }
     }
 
     if (tree.left() != -1) {
         LOG_DEBUG("send to left ", tree.left());
-        entry_factory::create<send_entry>(
+        auto send = entry_factory::create<send_entry>(
             sched, buffer, count, dtype, static_cast<size_t>(tree.left()), comm);
+        for (auto dep : bcast_deps) {
+            sched->add_dependency(send, dep);
+        }
     }
     if (tree.right() != -1) {
         LOG_DEBUG("send to right ", tree.right());
-        entry_factory::create<send_entry>(
+        auto send = entry_factory::create<send_entry>(
             sched, buffer, count, dtype, static_cast<size_t>(tree.right()), comm);
+        for (auto dep : bcast_deps) {
+            sched->add_dependency(send, dep);
+        }
     }
 }
 
@@ -114,6 +114,42 @@ ccl::status ccl_coll_build_naive_reduce_scatter(ccl_sched* sched,
             sched, send_buf + rank * recv_count * dtype_size, recv_buf, recv_count, dtype);
     }
 
+    /*
+       half precision inputs are received into separate slots and reduced in a single pass
+       with fp32 accumulation, so the result is rounded once instead of once per peer,
+       this trades per-peer overlap and O(comm_size) temporary memory for accuracy
+    */
+    const bool use_batch_reduce =
+        ccl::global_data::env().reduce_scatter_batch_reduce &&
+        (dtype.idx() == ccl::datatype::bfloat16 || dtype.idx() == ccl::datatype::float16) &&
+        op != ccl::reduction::custom && comm_size > 2 &&
+        !(sched->coll_param.stream && sched->coll_param.stream->is_gpu());
+
+    if (use_batch_reduce) {
+        ccl_buffer tmp_buf =
+            sched->alloc_buffer({ (comm_size - 1) * recv_count * dtype_size, recv_buf });
+        /* offsets[0] stands for recv_buf which is passed separately */
+        std::vector<size_t> offsets(comm_size, 0);
+
+        for (int idx = 1; idx < comm_size; idx++) {
+            int src = (comm_size + rank - idx) % comm_size;
+            int dst = (rank + idx) % comm_size;
+            offsets[idx] = (idx - 1) * recv_count;
+
+            entry_factory::create<send_entry>(
+                sched, send_buf + dst * recv_count * dtype_size, recv_count, dtype, dst, comm);
+            entry_factory::create<recv_entry>(
+                sched, tmp_buf + offsets[idx] * dtype_size, recv_count, dtype, src, comm);
+        }
+
+        sched->add_barrier();
+
+        entry_factory::create<batch_reduce_local_entry>(
+            sched, tmp_buf, offsets, recv_count, recv_buf, dtype, op);
+
+        return status;
+    }
+
     /* allocate temporary buffer to store incoming data */
     ccl_buffer tmp_buf = sched->alloc_buffer({ recv_count * dtype_size, recv_buf });
     int idx, src, dst;
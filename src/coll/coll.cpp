@@ -656,6 +656,10 @@ ccl::status ccl_coll_build_allreduce(ccl_sched* sched,
             CCL_CALL(ccl_coll_build_ring_rma_allreduce(
                 sched, send_buf, recv_buf, count, dtype, reduction, comm));
             break;
+        case ccl_coll_allreduce_ring_pipelined:
+            CCL_CALL(ccl_coll_build_ring_pipelined_allreduce(
+                sched, send_buf, recv_buf, count, dtype, reduction, comm));
+            break;
         case ccl_coll_allreduce_double_tree:
             CCL_CALL(ccl_coll_build_double_tree_op(sched,
                                                    ccl_coll_allreduce,
@@ -675,6 +679,10 @@ ccl::status ccl_coll_build_allreduce(ccl_sched* sched,
             CCL_CALL(ccl_coll_build_2d_allreduce(
                 sched, send_buf, recv_buf, count, dtype, reduction, comm));
             break;
+        case ccl_coll_allreduce_hier:
+            CCL_CALL(ccl_coll_build_hier_allreduce(
+                sched, send_buf, recv_buf, count, dtype, reduction, comm));
+            break;
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
         case ccl_coll_allreduce_topo:
             CCL_CALL(ccl_coll_build_topo_allreduce(
@@ -777,6 +785,8 @@ ccl::status ccl_coll_build_barrier(ccl_sched* sched, ccl_comm* comm) {
         case ccl_coll_barrier_ring:
             CCL_CALL(ccl_coll_build_dissemination_barrier(sched, comm));
             break;
+        case ccl_coll_barrier_tree: CCL_CALL(ccl_coll_build_tree_barrier(sched, comm)); break;
+        case ccl_coll_barrier_shm: CCL_CALL(ccl_coll_build_shm_barrier(sched, comm)); break;
         default:
             CCL_FATAL("unexpected barrier_algo ", ccl_coll_algorithm_to_str(algo));
             return ccl::status::invalid_arguments;
@@ -930,22 +940,26 @@ ccl::status ccl_coll_build_reduce(ccl_sched* sched,
 
     auto algo = ccl::global_data::get().algorithm_selector->get<ccl_coll_reduce>(param);
 
+    // average is accumulated as sum, the result is scaled on root only
+    ccl::reduction algo_reduction =
+        (reduction == ccl::reduction::avg) ? ccl::reduction::sum : reduction;
+
     switch (algo) {
         case ccl_coll_reduce_direct:
             CCL_CALL(ccl_coll_build_direct_reduce(
-                sched, send_buf, recv_buf, count, dtype, reduction, root, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, root, comm));
             break;
         case ccl_coll_reduce_rabenseifner:
             CCL_CALL(ccl_coll_build_rabenseifner_reduce(
-                sched, send_buf, recv_buf, count, dtype, reduction, root, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, root, comm));
             break;
         case ccl_coll_reduce_ring:
             CCL_CALL(ccl_coll_build_ring_reduce(
-                sched, send_buf, recv_buf, count, dtype, reduction, root, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, root, comm));
             break;
         case ccl_coll_reduce_tree:
             CCL_CALL(ccl_coll_build_binomial_reduce(
-                sched, send_buf, recv_buf, count, dtype, reduction, root, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, root, comm));
             break;
         case ccl_coll_reduce_double_tree:
             CCL_CALL(ccl_coll_build_double_tree_op(
@@ -955,14 +969,14 @@ ccl::status ccl_coll_build_reduce(ccl_sched* sched,
                 recv_buf,
                 count,
                 dtype,
-                reduction,
+                algo_reduction,
                 root == 0 ? comm->dtree() : comm->dtree().copy_with_new_root(root),
                 comm));
             break;
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
         case ccl_coll_reduce_topo:
             CCL_CALL(ccl_coll_build_topo_reduce(
-                sched, send_buf, recv_buf, count, dtype, reduction, root, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, root, comm));
             break;
 #endif // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
         default:
@@ -970,6 +984,11 @@ ccl::status ccl_coll_build_reduce(ccl_sched* sched,
             return ccl::status::invalid_arguments;
     }
 
+    if (reduction == ccl::reduction::avg && comm->rank() == root) {
+        sched->add_barrier();
+        ccl_add_avg_scale(sched, recv_buf, count, dtype, reduction, comm);
+    }
+
     return status;
 }
 
@@ -999,33 +1018,37 @@ ccl::status ccl_coll_build_reduce_scatter(ccl_sched* sched,
 
     auto algo = ccl::global_data::get().algorithm_selector->get<ccl_coll_reduce_scatter>(param);
 
+    // average is accumulated as sum, only the received block is scaled
+    ccl::reduction algo_reduction =
+        (reduction == ccl::reduction::avg) ? ccl::reduction::sum : reduction;
+
     switch (algo) {
         case ccl_coll_reduce_scatter_direct:
             if (!from_allreduce) {
                 CCL_CALL(ccl_coll_build_direct_reduce_scatter(
-                    sched, send_buf, recv_buf, count, dtype, reduction, comm));
+                    sched, send_buf, recv_buf, count, dtype, algo_reduction, comm));
                 break;
             }
         case ccl_coll_reduce_scatter_naive:
             if (!from_allreduce) {
                 CCL_CALL(ccl_coll_build_naive_reduce_scatter(
-                    sched, send_buf, recv_buf, count, dtype, reduction, comm));
+                    sched, send_buf, recv_buf, count, dtype, algo_reduction, comm));
                 break;
             }
         case ccl_coll_reduce_scatter_ring:
             if (from_allreduce) {
                 CCL_CALL(ccl_coll_build_reduce_scatter_block(
-                    sched, send_buf, recv_buf, count, dtype, reduction, comm));
+                    sched, send_buf, recv_buf, count, dtype, algo_reduction, comm));
             }
             else {
                 CCL_CALL(ccl_coll_build_ring_reduce_scatter(
-                    sched, send_buf, recv_buf, count, dtype, reduction, comm));
+                    sched, send_buf, recv_buf, count, dtype, algo_reduction, comm));
             }
             break;
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
         case ccl_coll_reduce_scatter_topo:
             CCL_CALL(ccl_coll_build_topo_reduce_scatter(
-                sched, send_buf, recv_buf, count, dtype, reduction, comm));
+                sched, send_buf, recv_buf, count, dtype, algo_reduction, comm));
             break;
 #endif // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
         default:
@@ -1033,6 +1056,11 @@ ccl::status ccl_coll_build_reduce_scatter(ccl_sched* sched,
             return ccl::status::invalid_arguments;
     }
 
+    if (reduction == ccl::reduction::avg) {
+        sched->add_barrier();
+        ccl_add_avg_scale(sched, recv_buf, count, dtype, reduction, comm);
+    }
+
     return status;
 }
 
@@ -1438,13 +1466,28 @@ ccl_request* ccl_allreduce_impl(const void* send_buf,
                                 const ccl_coll_attr& attr,
                                 ccl_comm* comm,
                                 const ccl_stream* stream,
-                                const std::vector<ccl::event>& deps) {
+                                const std::vector<ccl::event>& deps,
+                                ccl_coll_algo hint_algo) {
     CCL_THROW_RECORDING(stream,
                         "|CCL_SYCL| sched algorithms do not support sycl_graph recording, "
                         "please use sycl_algorithms");
     ccl_coll_param param = ccl_coll_param::create_allreduce_param(
         send_buf, recv_buf, count, dtype, reduction, attr, comm, stream, deps);
 
+    auto& tuner = ccl::global_data::get().algorithm_tuner;
+    if (hint_algo.has_value()) {
+        param.hint_algo = hint_algo;
+    }
+    else if (tuner && !group_impl::is_group_active
+#ifdef CCL_ENABLE_SYCL
+             && !attr.is_sycl_buf
+#endif // CCL_ENABLE_SYCL
+    ) {
+        /* the comm is tuned at creation, here is only a lookup */
+        param.hint_algo.allreduce = static_cast<ccl_coll_allreduce_algo>(
+            tuner->get_allreduce_algo(comm, count * param.dtype.size()));
+    }
+
     auto req = ccl_coll_create(param, attr);
     LOG_DEBUG("coll ", ccl_coll_type_to_str(param.ctype), " created, req ", req, " count ", count);
     return req;
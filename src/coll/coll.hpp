@@ -193,7 +193,8 @@ ccl_request* ccl_allreduce_impl(const void* send_buf,
                                 const ccl_coll_attr& attr,
                                 ccl_comm* comm,
                                 const ccl_stream* stream,
-                                const std::vector<ccl::event>& deps);
+                                const std::vector<ccl::event>& deps,
+                                ccl_coll_algo hint_algo = {});
 
 ccl::event ccl_alltoall(const void* send_buf,
                         void* recv_buf,
@@ -464,10 +464,12 @@ void ccl_coll_param::validate() const {
 
             if (ctype == ccl_coll_allreduce || ctype == ccl_coll_reduce_scatter ||
                 ctype == ccl_coll_reduce) {
-                if (reduction == ccl::reduction::avg) {
+                // average is finalized by host side scaling, device buffers are not supported
+                if (reduction == ccl::reduction::avg && stream && stream->is_sycl_device_stream()) {
                     // CCL_THROW_IF_NOT produce and error message which CI interprets as a failed test,
                     // however in some cases we want to throw exception, catch it and skip the average test.
-                    CCL_THROW("average operation is not supported for the scheduler path");
+                    CCL_THROW("average operation is not supported for the scheduler path "
+                              "with device buffers");
                 }
             }
 
@@ -34,7 +34,7 @@ ccl_algorithm_selector<ccl_coll_allgather>::ccl_algorithm_selector() {
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
     insert(main_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_allgather_topo);
 #else // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
-    if (ccl::global_data::env().atl_transport == ccl_atl_ofi) {
+    if (ccl::global_data::env().atl_transport != ccl_atl_mpi) {
         insert(main_table, 0, CCL_ALLGATHER_SHORT_MSG_SIZE, ccl_coll_allgather_naive);
         insert(main_table,
                CCL_ALLGATHER_SHORT_MSG_SIZE + 1,
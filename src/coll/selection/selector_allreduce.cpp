@@ -23,9 +23,11 @@ std::map<ccl_coll_allreduce_algo, std::string>
         std::make_pair(ccl_coll_allreduce_nreduce, "nreduce"),
         std::make_pair(ccl_coll_allreduce_ring, "ring"),
         std::make_pair(ccl_coll_allreduce_ring_rma, "ring_rma"),
+        std::make_pair(ccl_coll_allreduce_ring_pipelined, "ring_pipelined"),
         std::make_pair(ccl_coll_allreduce_double_tree, "double_tree"),
         std::make_pair(ccl_coll_allreduce_recursive_doubling, "recursive_doubling"),
         std::make_pair(ccl_coll_allreduce_2d, "2d"),
+        std::make_pair(ccl_coll_allreduce_hier, "hier"),
 #ifdef CCL_ENABLE_SYCL
         std::make_pair(ccl_coll_allreduce_topo, "topo"),
 #endif // CCL_ENABLE_SYCL
@@ -34,7 +36,7 @@ std::map<ccl_coll_allreduce_algo, std::string>
 ccl_algorithm_selector<ccl_coll_allreduce>::ccl_algorithm_selector() {
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
     insert(main_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_allreduce_topo);
-    if (ccl::global_data::env().atl_transport == ccl_atl_ofi) {
+    if (ccl::global_data::env().atl_transport != ccl_atl_mpi) {
         insert(fallback_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_allreduce_ring);
         insert(
             fallback_table, 0, CCL_ALLREDUCE_SHORT_MSG_SIZE, ccl_coll_allreduce_recursive_doubling);
@@ -44,7 +46,7 @@ ccl_algorithm_selector<ccl_coll_allreduce>::ccl_algorithm_selector() {
         insert(fallback_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_allreduce_ring);
     }
 #else // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
-    if (ccl::global_data::env().atl_transport == ccl_atl_ofi) {
+    if (ccl::global_data::env().atl_transport != ccl_atl_mpi) {
         insert(main_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_allreduce_ring);
         insert(main_table, 0, CCL_ALLREDUCE_SHORT_MSG_SIZE, ccl_coll_allreduce_recursive_doubling);
         insert(main_table,
@@ -80,7 +82,7 @@ bool ccl_algorithm_selector_helper<ccl_coll_allreduce_algo>::can_use(
     else if (algo == ccl_coll_allreduce_nreduce && !(param.count / param.comm->size()))
         can_use = false;
     else if (algo == ccl_coll_allreduce_direct &&
-             (ccl::global_data::env().atl_transport == ccl_atl_ofi))
+             (ccl::global_data::env().atl_transport != ccl_atl_mpi))
         can_use = false;
     else if (algo == ccl_coll_allreduce_topo && !ccl_can_use_topo_algo(param))
         can_use = false;
@@ -88,6 +90,9 @@ bool ccl_algorithm_selector_helper<ccl_coll_allreduce_algo>::can_use(
         // MLSL-1762: scale-up topo + scale-out 2d combination fails.
         // Algorithms are not compatible.
         can_use = false;
+    else if (algo == ccl_coll_allreduce_hier &&
+             (param.is_scaleout || !param.comm->has_hier_subcomms()))
+        can_use = false;
     else if (algo == ccl_coll_allreduce_direct && param.is_scaleout &&
              ccl::global_data::env().worker_count > 1
 #ifdef CCL_ENABLE_SYCL
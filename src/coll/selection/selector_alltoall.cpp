@@ -54,7 +54,7 @@ bool ccl_algorithm_selector_helper<ccl_coll_alltoall_algo>::can_use(
         can_use = false;
     }
     else if (algo == ccl_coll_alltoall_direct &&
-             (ccl::global_data::env().atl_transport == ccl_atl_ofi)) {
+             (ccl::global_data::env().atl_transport != ccl_atl_mpi)) {
         can_use = false;
     }
     else if (algo == ccl_coll_alltoall_direct && param.is_scaleout) {
@@ -15,20 +15,33 @@
 */
 #include "coll/selection/selection.hpp"
 
+/* barrier tables are keyed by comm size instead of message size */
+#define CCL_BARRIER_TREE_MIN_COMM_SIZE (2048)
+
 template <>
 std::map<ccl_coll_barrier_algo, std::string>
     ccl_algorithm_selector_helper<ccl_coll_barrier_algo>::algo_names = {
         std::make_pair(ccl_coll_barrier_direct, "direct"),
-        std::make_pair(ccl_coll_barrier_ring, "ring")
+        std::make_pair(ccl_coll_barrier_ring, "ring"),
+        std::make_pair(ccl_coll_barrier_tree, "tree"),
+        std::make_pair(ccl_coll_barrier_shm, "shm")
     };
 
 ccl_algorithm_selector<ccl_coll_barrier>::ccl_algorithm_selector() {
     // TODO: make ring barrier default after MLSL-1915 is done
-    if (ccl::global_data::env().atl_transport == ccl_atl_ofi)
+    if (ccl::global_data::env().atl_transport != ccl_atl_mpi)
         insert(main_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_barrier_ring);
     else if (ccl::global_data::env().atl_transport == ccl_atl_mpi)
         insert(main_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_barrier_direct);
-    insert(fallback_table, 0, CCL_SELECTION_MAX_COLL_SIZE, ccl_coll_barrier_ring);
+
+    // shm barrier is used only if requested through CCL_BARRIER,
+    // subcomms and comms with single rank per node take flat algorithms,
+    // tree keeps less messages in flight than dissemination on large comms
+    insert(fallback_table, 0, CCL_BARRIER_TREE_MIN_COMM_SIZE - 1, ccl_coll_barrier_ring);
+    insert(fallback_table,
+           CCL_BARRIER_TREE_MIN_COMM_SIZE,
+           CCL_SELECTION_MAX_COLL_SIZE,
+           ccl_coll_barrier_tree);
 
     // barrier currently does not support scale-out selection, but the table
     // has to be defined, therefore duplicating main table
@@ -42,8 +55,17 @@ bool ccl_algorithm_selector_helper<ccl_coll_barrier_algo>::can_use(
     const ccl_selection_table_t<ccl_coll_barrier_algo>& table) {
     bool can_use = true;
 
-    if (algo == ccl_coll_barrier_direct && (ccl::global_data::env().atl_transport == ccl_atl_ofi))
+    if (algo == ccl_coll_barrier_direct && (ccl::global_data::env().atl_transport != ccl_atl_mpi))
         can_use = false;
+    else if (algo == ccl_coll_barrier_shm) {
+        // decision has to be the same on every rank, so ppn is taken into account
+        // only if it is the same on every node
+        if (!param.comm || !param.comm->has_hier_subcomms())
+            can_use = false;
+        else if (param.comm->get_topo_manager().has_same_ppn() &&
+                 param.comm->get_node_comm()->size() == 1)
+            can_use = false;
+    }
 
     return can_use;
 }
@@ -51,5 +73,5 @@ bool ccl_algorithm_selector_helper<ccl_coll_barrier_algo>::can_use(
 CCL_SELECTION_DEFINE_HELPER_METHODS(ccl_coll_barrier_algo,
                                     ccl_coll_barrier,
                                     ccl::global_data::env().barrier_algo_raw,
-                                    0,
+                                    (param.comm) ? param.comm->size() : 0,
                                     ccl::global_data::env().barrier_scaleout_algo_raw);
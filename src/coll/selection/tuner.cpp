@@ -0,0 +1,387 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include "coll/coll.hpp"
+#include "coll/selection/selection.hpp"
+#include "coll/selection/tuner.hpp"
+#include "exec/exec.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <sys/file.h>
+#include <unistd.h>
+
+#define CCL_TUNER_FILE_COLL_NAME "allreduce"
+
+namespace {
+
+/* ordered, so every rank builds the same list */
+const std::vector<ccl_coll_allreduce_algo> allreduce_candidates = {
+    ccl_coll_allreduce_direct,      ccl_coll_allreduce_ring,
+    ccl_coll_allreduce_rabenseifner, ccl_coll_allreduce_nreduce,
+    ccl_coll_allreduce_double_tree, ccl_coll_allreduce_recursive_doubling,
+    ccl_coll_allreduce_2d,          ccl_coll_allreduce_hier
+};
+
+void run_allreduce(const void* send_buf,
+                   void* recv_buf,
+                   size_t count,
+                   ccl::datatype dtype,
+                   ccl::reduction reduction,
+                   ccl_comm* comm,
+                   ccl_coll_algo hint_algo) {
+    ccl_coll_attr attr{};
+    ccl_request* req = ccl_allreduce_impl(
+        send_buf, recv_buf, count, dtype, reduction, attr, comm, nullptr, {}, hint_algo);
+    if (!req) {
+        return;
+    }
+    auto wait_result = ccl_wait_impl(ccl::global_data::get().executor.get(), req);
+    if (wait_result == ccl_wait_result_completed_not_released) {
+        ccl_release_request(req);
+    }
+}
+
+} // namespace
+
+ccl_algorithm_tuner::ccl_algorithm_tuner() : is_writer(false) {
+    const std::string& file_name = ccl::global_data::env().algo_autotune_file;
+    if (!file_name.empty()) {
+        load(file_name, results);
+    }
+}
+
+ccl_algorithm_tuner::~ccl_algorithm_tuner() {
+    try {
+        store();
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("failed to store tuning results: ", e.what());
+    }
+}
+
+size_t ccl_algorithm_tuner::get_size_class(size_t bytes) {
+    size_t size_class = CCL_TUNER_MIN_SIZE_CLASS;
+    while (size_class < CCL_TUNER_SIZE_CLASS_COUNT - 1 && (1UL << size_class) < bytes) {
+        size_class++;
+    }
+    return size_class;
+}
+
+std::string ccl_algorithm_tuner::get_shape_key(ccl_comm* comm) {
+    std::stringstream ss;
+    ss << comm->size() << ":" << comm->get_node_comm()->size() << ":"
+       << ccl::env_data::atl_transport_names.at(ccl::global_data::env().atl_transport);
+    return ss.str();
+}
+
+int ccl_algorithm_tuner::get_allreduce_algo(const ccl_comm* comm, size_t bytes) const {
+    if (!bytes || bytes > ccl::global_data::env().algo_autotune_max_size) {
+        return ccl_coll_allreduce_undefined;
+    }
+    int algo = comm->get_tuned_allreduce_algos().algos[get_size_class(bytes)].load(
+        std::memory_order_acquire);
+    return (algo == ccl_tuned_algos::not_tuned) ? ccl_coll_allreduce_undefined : algo;
+}
+
+void ccl_algorithm_tuner::tune_comm(ccl_comm* comm) {
+    size_t max_size = ccl::global_data::env().algo_autotune_max_size;
+    if (!max_size) {
+        return;
+    }
+
+    size_t max_size_class = get_size_class(max_size);
+    std::string shape_key = get_shape_key(comm);
+
+    std::vector<int> algos;
+    for (size_t size_class = CCL_TUNER_MIN_SIZE_CLASS; size_class <= max_size_class;
+         size_class++) {
+        algos.push_back(get_stored_algo(shape_key, size_class));
+    }
+    agree_on_stored_algos(comm, algos);
+
+    auto& tuned_algos = comm->get_tuned_allreduce_algos();
+    size_t measured_count = 0;
+    for (size_t idx = 0; idx < algos.size(); idx++) {
+        size_t size_class = CCL_TUNER_MIN_SIZE_CLASS + idx;
+        bool is_measured = (algos[idx] == ccl_coll_allreduce_undefined);
+        if (is_measured) {
+            algos[idx] = measure_allreduce(comm, size_class);
+            measured_count++;
+
+            std::lock_guard<std::mutex> lock(guard);
+            results[shape_key][size_class] = algos[idx];
+            measured_results[shape_key][size_class] = algos[idx];
+        }
+
+        LOG_DEBUG("autotune: comm ",
+                  comm->id(),
+                  ", size class ",
+                  (1UL << size_class),
+                  " bytes, allreduce algo ",
+                  ccl_coll_algorithm_to_str(static_cast<ccl_coll_allreduce_algo>(algos[idx])),
+                  is_measured ? " (measured)" : " (loaded)");
+
+        tuned_algos.algos[size_class].store(algos[idx], std::memory_order_release);
+    }
+
+    if (comm->rank() == 0) {
+        {
+            std::lock_guard<std::mutex> lock(guard);
+            is_writer = true;
+        }
+        LOG_INFO("autotune: comm ",
+                 comm->id(),
+                 ", shape ",
+                 shape_key,
+                 ", size classes up to ",
+                 (1UL << max_size_class),
+                 " bytes, measured ",
+                 measured_count,
+                 " of ",
+                 algos.size());
+    }
+}
+
+int ccl_algorithm_tuner::get_stored_algo(const std::string& shape_key, size_t size_class) {
+    std::lock_guard<std::mutex> lock(guard);
+    auto shape_it = results.find(shape_key);
+    if (shape_it == results.end()) {
+        return ccl_coll_allreduce_undefined;
+    }
+    auto class_it = shape_it->second.find(size_class);
+    return (class_it == shape_it->second.end()) ? ccl_coll_allreduce_undefined : class_it->second;
+}
+
+void ccl_algorithm_tuner::agree_on_stored_algos(ccl_comm* comm, std::vector<int>& stored_algos) {
+    /*
+       ranks may have loaded different files or no file at all,
+       stored value is used only if all ranks have the same one:
+       max(algo) == -max(-algo) == min(algo), undefined (0) on any rank breaks the equality
+    */
+    size_t count = stored_algos.size();
+    std::vector<int> send_buf(2 * count);
+    std::vector<int> recv_buf(2 * count, 0);
+    for (size_t idx = 0; idx < count; idx++) {
+        send_buf[idx] = stored_algos[idx];
+        send_buf[count + idx] = -stored_algos[idx];
+    }
+    run_allreduce(send_buf.data(),
+                  recv_buf.data(),
+                  send_buf.size(),
+                  ccl::datatype::int32,
+                  ccl::reduction::max,
+                  comm,
+                  {});
+
+    for (size_t idx = 0; idx < count; idx++) {
+        stored_algos[idx] = (recv_buf[idx] == -recv_buf[count + idx])
+                                ? recv_buf[idx]
+                                : static_cast<int>(ccl_coll_allreduce_undefined);
+    }
+}
+
+int ccl_algorithm_tuner::measure_allreduce(ccl_comm* comm, size_t size_class) {
+    const ccl::datatype dtype = ccl::datatype::float32;
+    const ccl_datatype& dtype_desc = ccl::global_data::get().dtypes->get(dtype);
+    size_t count = std::max((1UL << size_class) / dtype_desc.size(), 1UL);
+    size_t iters = ccl::global_data::env().algo_autotune_iters;
+
+    std::vector<float> send_buf(count, 1.0f);
+    std::vector<float> recv_buf(count, 0.0f);
+
+    ccl_selector_param param;
+    param.ctype = ccl_coll_allreduce;
+    param.count = count;
+    param.dtype = dtype_desc;
+    param.comm = comm;
+    param.buf = send_buf.data();
+    param.reduction = ccl::reduction::sum;
+
+    ccl_selection_table_t<ccl_coll_allreduce_algo> empty_table;
+    std::vector<double> times(allreduce_candidates.size(), std::numeric_limits<double>::max());
+
+    for (size_t idx = 0; idx < allreduce_candidates.size(); idx++) {
+        ccl_coll_allreduce_algo algo = allreduce_candidates[idx];
+        if (!ccl_algorithm_selector_helper<ccl_coll_allreduce_algo>::can_use(
+                algo, param, empty_table)) {
+            continue;
+        }
+
+        ccl_coll_algo hint_algo;
+        hint_algo.allreduce = algo;
+
+        /* the first iteration warms up connections and caches */
+        std::chrono::steady_clock::time_point start;
+        for (size_t iter = 0; iter <= iters; iter++) {
+            if (iter == 1) {
+                start = std::chrono::steady_clock::now();
+            }
+            run_allreduce(send_buf.data(),
+                          recv_buf.data(),
+                          count,
+                          dtype,
+                          ccl::reduction::sum,
+                          comm,
+                          hint_algo);
+        }
+        times[idx] =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                .count() /
+            iters;
+    }
+
+    /* the slowest rank defines the time of the collective */
+    std::vector<double> max_times(times.size());
+    run_allreduce(times.data(),
+                  max_times.data(),
+                  times.size(),
+                  ccl::datatype::float64,
+                  ccl::reduction::max,
+                  comm,
+                  {});
+
+    size_t best_idx = 0;
+    for (size_t idx = 1; idx < max_times.size(); idx++) {
+        if (max_times[idx] < max_times[best_idx]) {
+            best_idx = idx;
+        }
+    }
+
+    CCL_THROW_IF_NOT(max_times[best_idx] != std::numeric_limits<double>::max(),
+                     "no allreduce algorithm can be tuned for size class ",
+                     (1UL << size_class));
+
+    LOG_DEBUG("autotune: size class ",
+              (1UL << size_class),
+              ", best algo ",
+              ccl_coll_algorithm_to_str(allreduce_candidates[best_idx]),
+              ", time ",
+              max_times[best_idx],
+              " usec");
+
+    return allreduce_candidates[best_idx];
+}
+
+void ccl_algorithm_tuner::load(const std::string& file_name, results_t& file_results) {
+    std::ifstream file(file_name);
+    if (!file.is_open()) {
+        LOG_DEBUG("autotune: no tuning file ", file_name, ", start from scratch");
+        return;
+    }
+
+    /* format: allreduce <comm_size>:<ppn>:<transport> <size_class_bytes> <algo> */
+    std::string line;
+    size_t line_idx = 0;
+    while (std::getline(file, line)) {
+        line_idx++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::stringstream ss(line);
+        std::string coll_name, shape_key, algo_name;
+        size_t size_class_bytes = 0;
+        if (!(ss >> coll_name >> shape_key >> size_class_bytes >> algo_name) ||
+            coll_name != CCL_TUNER_FILE_COLL_NAME || !size_class_bytes) {
+            LOG_WARN("autotune: skip malformed line ", line_idx, " of ", file_name);
+            continue;
+        }
+
+        try {
+            file_results[shape_key][get_size_class(size_class_bytes)] =
+                ccl_algorithm_selector_helper<ccl_coll_allreduce_algo>::algo_from_str(algo_name);
+        }
+        catch (const ccl::exception& e) {
+            LOG_WARN("autotune: skip line ", line_idx, " of ", file_name, ": ", e.what());
+        }
+    }
+
+    LOG_DEBUG("autotune: loaded ", file_results.size(), " shapes from ", file_name);
+}
+
+void ccl_algorithm_tuner::store() {
+    const std::string& file_name = ccl::global_data::env().algo_autotune_file;
+    if (file_name.empty() || measured_results.empty() || !is_writer) {
+        return;
+    }
+
+    /*
+       several processes (rank 0 of different comms or jobs) may store to the same file,
+       so the file is re-read and merged with own measurements under an exclusive lock
+    */
+    std::string lock_file_name = file_name + ".lock";
+    int lock_fd = open(lock_file_name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    if (lock_fd < 0) {
+        LOG_WARN("autotune: can not open ", lock_file_name, ", errno: ", strerror(errno));
+        return;
+    }
+    if (flock(lock_fd, LOCK_EX)) {
+        LOG_WARN("autotune: can not lock ", lock_file_name, ", errno: ", strerror(errno));
+        close(lock_fd);
+        return;
+    }
+
+    results_t file_results;
+    load(file_name, file_results);
+    for (const auto& shape : measured_results) {
+        for (const auto& size_class : shape.second) {
+            file_results[shape.first][size_class.first] = size_class.second;
+        }
+    }
+
+    /* write to a temporary file first, so readers never see a partial file */
+    std::string tmp_file_name = file_name + ".tmp." + std::to_string(getpid());
+    bool is_written = false;
+    {
+        std::ofstream file(tmp_file_name, std::ios::trunc);
+        if (file.is_open()) {
+            file << "# " << CCL_TUNER_FILE_COLL_NAME
+                 << " <comm_size>:<ppn>:<transport> <size_class_bytes> <algo>\n";
+            for (const auto& shape : file_results) {
+                for (const auto& size_class : shape.second) {
+                    file << CCL_TUNER_FILE_COLL_NAME << " " << shape.first << " "
+                         << (1UL << size_class.first) << " "
+                         << ccl_coll_algorithm_to_str(
+                                static_cast<ccl_coll_allreduce_algo>(size_class.second))
+                         << "\n";
+                }
+            }
+            is_written = true;
+        }
+        else {
+            LOG_WARN("autotune: can not open ", tmp_file_name, " for writing");
+        }
+    }
+
+    if (is_written && rename(tmp_file_name.c_str(), file_name.c_str())) {
+        LOG_WARN("autotune: can not rename ", tmp_file_name, " to ", file_name);
+        unlink(tmp_file_name.c_str());
+        is_written = false;
+    }
+
+    flock(lock_fd, LOCK_UN);
+    close(lock_fd);
+
+    if (is_written) {
+        LOG_INFO("autotune: stored tuning results to ", file_name);
+    }
+}
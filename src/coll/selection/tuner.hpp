@@ -0,0 +1,88 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ccl_comm;
+
+/* size class k covers message sizes (2^(k-1), 2^k] bytes */
+#define CCL_TUNER_SIZE_CLASS_COUNT 64
+#define CCL_TUNER_MIN_SIZE_CLASS   6
+
+/* algorithms agreed by all ranks of the comm, indexed by size class */
+struct ccl_tuned_algos {
+    static constexpr int not_tuned = -1;
+
+    ccl_tuned_algos() {
+        for (auto& algo : algos) {
+            algo.store(not_tuned, std::memory_order_relaxed);
+        }
+    }
+
+    ccl_tuned_algos(const ccl_tuned_algos&) = delete;
+    ccl_tuned_algos& operator=(const ccl_tuned_algos&) = delete;
+
+    std::atomic<int> algos[CCL_TUNER_SIZE_CLASS_COUNT];
+};
+
+/*
+   online allreduce tuning:
+   when a comm is created it times candidate algorithms for every size class,
+   ranks agree on the slowest rank's time and the fastest algorithm is used as hint
+   for allreduce calls of this size class, so user collectives never wait for tuning.
+   results are keyed by comm size, ppn and transport and can be persisted to a file
+*/
+class ccl_algorithm_tuner {
+public:
+    ccl_algorithm_tuner();
+    ~ccl_algorithm_tuner();
+
+    ccl_algorithm_tuner(const ccl_algorithm_tuner&) = delete;
+    ccl_algorithm_tuner& operator=(const ccl_algorithm_tuner&) = delete;
+
+    /* collective over comm, tunes all size classes up to CCL_ALGO_AUTOTUNE_MAX_SIZE */
+    void tune_comm(ccl_comm* comm);
+
+    /* returns ccl_coll_allreduce_undefined if the size class is not tuned */
+    int get_allreduce_algo(const ccl_comm* comm, size_t bytes) const;
+
+    static size_t get_size_class(size_t bytes);
+
+private:
+    static std::string get_shape_key(ccl_comm* comm);
+
+    /* shape key -> size class -> algo */
+    using results_t = std::map<std::string, std::map<size_t, int>>;
+
+    int get_stored_algo(const std::string& shape_key, size_t size_class);
+    void agree_on_stored_algos(ccl_comm* comm, std::vector<int>& stored_algos);
+    int measure_allreduce(ccl_comm* comm, size_t size_class);
+
+    static void load(const std::string& file_name, results_t& file_results);
+    void store();
+
+    std::mutex guard;
+    results_t results;
+    /* measured by this process, merged into the file at finalization */
+    results_t measured_results;
+    /* set if the process was rank 0 of a tuned comm, only such processes write the file */
+    bool is_writer;
+};
@@ -157,6 +157,10 @@ void ccl_comm::init(int comm_id,
 
     env = std::make_shared<ccl_comm_env>(device_ptr);
 
+    if (!is_sub_communicator) {
+        tune_algorithms();
+    }
+
     if (comm_rank == 0) {
         LOG_DEBUG(to_string_ext());
     }
@@ -222,6 +226,9 @@ ccl_comm::ccl_comm(const ccl_comm& src, int comm_id)
     node_comm = src.node_comm;
     even_comm = src.even_comm;
     pair_comm = src.pair_comm;
+    // shm barrier generations are per comm, so the copy neither shares the source segment
+    // nor creates its own, see get_shm_barrier
+    is_copy = true;
 }
 
 std::shared_ptr<ikvs_wrapper> ccl_comm::get_kvs_wrapper(std::shared_ptr<ccl::kvs_interface> kvs) {
@@ -271,6 +278,54 @@ void ccl_comm::create_topo_subcomms(std::shared_ptr<atl_base_comm> atl_comm) {
         topo_manager.get_inter_card_color(atl_comm->get_rank()) % topo_manager.max_ranks_per_card));
 }
 
+// splits are collective, they are done on the first build of the algorithm which needs
+// the subcomm, it happens for the same collective on every rank.
+// fusion may build in the worker thread, so the creation is serialized
+void ccl_comm::create_socket_subcomms() {
+    CCL_THROW_IF_NOT(has_hier_subcomms(), "no hierarchical subcomms for comm ", id());
+
+    std::lock_guard<std::mutex> lock(hier_subcomms_guard);
+    if (is_socket_subcomms_created) {
+        return;
+    }
+
+    // comm_split is collective, so every rank has to take part
+    // even if hwloc is not available or its package can not be detected
+    int package_idx = CCL_HWLOC_INVALID_PACKAGE;
+    auto& hwloc_wrapper = ccl::global_data::get().hwloc_wrapper;
+    if (hwloc_wrapper && hwloc_wrapper->is_initialized()) {
+        package_idx = hwloc_wrapper->get_package_idx();
+    }
+    if (package_idx == CCL_HWLOC_INVALID_PACKAGE) {
+        package_idx = 0;
+    }
+
+    socket_comm = std::shared_ptr<ccl_comm>(node_comm->create_subcomm(package_idx));
+    socket_leaders_comm = std::shared_ptr<ccl_comm>(
+        node_comm->create_subcomm((socket_comm->rank() == 0) ? 0 : 1));
+
+    is_socket_subcomms_created = true;
+}
+
+// the barrier needs only node leaders and the shm segment, socket subcomms are not split for it
+void ccl_comm::create_node_leaders_comm() {
+    CCL_THROW_IF_NOT(has_hier_subcomms(), "no hierarchical subcomms for comm ", id());
+
+    std::lock_guard<std::mutex> lock(hier_subcomms_guard);
+    if (is_node_leaders_comm_created) {
+        return;
+    }
+
+    node_leaders_comm =
+        std::shared_ptr<ccl_comm>(create_subcomm((node_comm->rank() == 0) ? 0 : 1));
+
+    if (ccl::global_data::env().enable_barrier_shm) {
+        shm_barrier = ccl_shm_barrier::create(node_comm->get_atl_comm());
+    }
+
+    is_node_leaders_comm_created = true;
+}
+
 ccl_comm* ccl_comm::create_subcomm(int color, int key) const {
     std::shared_ptr<atl_base_comm> new_atl_comm = get_atl_comm()->comm_split(color, key);
     ccl_comm* comm = new ccl_comm(
@@ -344,11 +399,24 @@ ccl::comm_interface_ptr ccl_comm::split(int color, int key, bool split_external_
     }
     else {
         new_comm = create_subcomm(color, key);
+        // subcomm does not inherit the device, so device comms are checked here
+        if (!device_ptr) {
+            new_comm->tune_algorithms();
+        }
     }
 
     return std::shared_ptr<ccl_comm>(new_comm);
 }
 
+void ccl_comm::tune_algorithms() {
+    // tuning runs blocking host allreduces over the comm,
+    // so it is done once at creation instead of inside the first user collective
+    auto& tuner = ccl::global_data::get().algorithm_tuner;
+    if (tuner && !device_ptr && !group_impl::is_group_active) {
+        tuner->tune_comm(this);
+    }
+}
+
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
 void ccl_comm::init_ipc_exchange_mode(std::shared_ptr<ccl_comm> comm) {
     if (device_ptr && context_ptr) {
@@ -402,6 +470,12 @@ std::string ccl_comm::to_string_ext() const {
     ss << "   node_comm: " << (node_comm ? node_comm->to_string() : "{}") << "\n";
     ss << "   even_comm: " << (even_comm ? even_comm->to_string() : "{}") << "\n";
     ss << "   pair_comm: " << (pair_comm ? pair_comm->to_string() : "{}") << "\n";
+    ss << "   socket_comm: " << (socket_comm ? socket_comm->to_string() : "{}") << "\n";
+    ss << "   socket_leaders_comm: "
+       << (socket_leaders_comm ? socket_leaders_comm->to_string() : "{}") << "\n";
+    ss << "   node_leaders_comm: "
+       << (node_leaders_comm ? node_leaders_comm->to_string() : "{}") << "\n";
+    ss << "   shm_barrier: " << (shm_barrier ? shm_barrier->to_string() : "{}") << "\n";
     ss << "   env: " << (env ? env->to_string() : "{}") << "\n";
     ss << "}";
 
@@ -432,17 +506,9 @@ int ccl_comm::get_rank_from_global(int global_rank) const {
         return global_rank;
     }
 
-    int rank = ccl_comm::invalid_rank;
-
-    // TODO: Add reverse map to speed this up
-    for (size_t i = 0; i < local2global_map.size(); ++i) {
-        if (local2global_map[i] == global_rank) {
-            rank = static_cast<int>(i);
-            break;
-        }
-    }
+    int rank = local2global_map.find(global_rank);
 
-    CCL_THROW_IF_NOT(rank != ccl_comm::invalid_rank, "can not find rank");
+    CCL_THROW_IF_NOT(rank != ccl_rank_map::invalid_idx, "can not find rank");
 
     return rank;
 }
@@ -454,13 +520,7 @@ bool ccl_comm::try_get_rank_from_global(int global_rank) const {
         return ret;
     }
 
-    for (size_t i = 0; i < local2global_map.size(); ++i) {
-        if (local2global_map[i] == global_rank) {
-            return true;
-        }
-    }
-
-    return ret;
+    return local2global_map.find(global_rank) != ccl_rank_map::invalid_idx;
 }
 
 int ccl_comm::get_node_rank(int rank) const {
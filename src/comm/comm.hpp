@@ -15,12 +15,15 @@
 */
 #pragma once
 #include <atomic>
+#include <mutex>
 #include <unordered_map>
 
 #include "atl/atl_base_comm.hpp"
 #include "comm/comm_common_attr.hpp"
 #include "comm/comm_interface.hpp"
+#include "coll/selection/tuner.hpp"
 #include "comm/atl_tag.hpp"
+#include "comm/shm_barrier.hpp"
 #include "common/log/log.hpp"
 #include "common/stream/stream.hpp"
 #include "common/utils/tree.hpp"
@@ -42,11 +45,12 @@
 #include "sched/entry/ze/ze_primitives.hpp"
 #endif // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
 #include "types_generator_defines.hpp"
+#include "common/utils/rank_map.hpp"
 #include "topology/topo_manager.hpp"
 #include "unordered_coll/unordered_coll.hpp"
 
 // index = local_rank, value = global_rank
-using ccl_rank2rank_map = std::vector<int>;
+using ccl_rank2rank_map = ccl_rank_map;
 
 class ikvs_wrapper;
 
@@ -57,7 +61,6 @@ inline ccl_stream* get_stream_ptr(const ccl::stream::impl_value_t& stream) {
         return nullptr;
 }
 
-using ccl_rank2rank_map = std::vector<int>;
 
 class ccl_comm;
 namespace ccl {
@@ -446,6 +449,7 @@ public:
 
     std::shared_ptr<atl_base_comm> atl_comm;
     std::unique_ptr<ccl_unordered_coll_manager> unordered_coll_manager;
+    ccl_tuned_algos tuned_allreduce_algos;
 
 private:
     int m_rank;
@@ -561,6 +565,9 @@ private:
     ccl_comm(const ccl_comm& src, int comm_id);
 
     void create_topo_subcomms(std::shared_ptr<atl_base_comm> atl_comm);
+    void create_socket_subcomms();
+    void create_node_leaders_comm();
+    void tune_algorithms();
     // needed for multithreading (single process multiple devices) approach:
     void create_topo_subcommsExt(int size, int rank);
 
@@ -658,6 +665,43 @@ public:
         return pair_comm;
     }
 
+    // the result is the same on every rank, so it can be used for algorithm selection.
+    // node subcomms are built for the parent and copies don't own them, so only
+    // the comm which owns node_comm can create the hierarchical subcomms
+    bool has_hier_subcomms() const {
+        return !parent_comm && !is_copy && node_comm;
+    }
+
+    // hierarchical subcomms are created on first use, see create_socket_subcomms
+    // and create_node_leaders_comm
+    std::shared_ptr<ccl_comm> get_socket_comm() {
+        create_socket_subcomms();
+        CCL_ASSERT(socket_comm, "no socket_comm");
+        return socket_comm;
+    }
+
+    std::shared_ptr<ccl_comm> get_socket_leaders_comm() {
+        create_socket_subcomms();
+        CCL_ASSERT(socket_leaders_comm, "no socket_leaders_comm");
+        return socket_leaders_comm;
+    }
+
+    std::shared_ptr<ccl_comm> get_node_leaders_comm() {
+        create_node_leaders_comm();
+        CCL_ASSERT(node_leaders_comm, "no node_leaders_comm");
+        return node_leaders_comm;
+    }
+
+    // may be empty if there is a single rank on the node or shared memory is not available,
+    // always empty for subcomms and copies, they must not share generations with the owner
+    std::shared_ptr<ccl_shm_barrier> get_shm_barrier() {
+        if (!has_hier_subcomms()) {
+            return nullptr;
+        }
+        create_node_leaders_comm();
+        return shm_barrier;
+    }
+
     const ccl_rank2rank_map& get_local2global_map() const {
         return local2global_map;
     }
@@ -690,6 +734,10 @@ public:
         return comm_impl->unordered_coll_manager;
     }
 
+    ccl_tuned_algos& get_tuned_allreduce_algos() const {
+        return comm_impl->tuned_allreduce_algos;
+    }
+
     int rank() const override {
         return comm_rank;
     }
@@ -830,6 +878,17 @@ private:
     std::shared_ptr<ccl_comm> node_comm;
     std::shared_ptr<ccl_comm> even_comm;
     std::shared_ptr<ccl_comm> pair_comm;
+    // ranks of the same cpu package, one leader per package and one leader per node
+    std::shared_ptr<ccl_comm> socket_comm;
+    std::shared_ptr<ccl_comm> socket_leaders_comm;
+    std::shared_ptr<ccl_comm> node_leaders_comm;
+    // flag barrier over shared memory for ranks of node_comm
+    std::shared_ptr<ccl_shm_barrier> shm_barrier;
+    std::mutex hier_subcomms_guard;
+    bool is_socket_subcomms_created = false;
+    bool is_node_leaders_comm_created = false;
+    // created by the copy-constructor, shares topo subcomms with the source comm
+    bool is_copy = false;
 
     // these fields are duplicate with the ones in ccl_internal_comm
     // but having them here allows to get them without going
@@ -181,13 +181,7 @@ void ccl_comm::initExt(int size,
         create_topo_subcommsExt(size, rank);
     }
 
-    std::vector<int> rank2rank_map;
-    rank2rank_map.resize(size);
-    for (int i = 0; i < size; i++) {
-        rank2rank_map[i] = i;
-    }
-
-    local2global_map = rank2rank_map;
+    local2global_map = ccl_rank_map::identity(size);
     pthread_barrier_wait(&ccl::global_data::get().shared_data->barrier_waits[global_current_id]);
 
     env = std::make_shared<ccl_comm_env>(device_ptr);
@@ -0,0 +1,165 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "atl/atl_base_comm.hpp"
+#include "comm/shm_barrier.hpp"
+#include "common/log/log.hpp"
+#include "common/utils/exchange_utils.hpp"
+
+/* flags are accessed by several processes */
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64-bit atomics must be lock-free");
+
+std::shared_ptr<ccl_shm_barrier> ccl_shm_barrier::create(
+    const std::shared_ptr<atl_base_comm>& node_comm) {
+    int rank = node_comm->get_rank();
+    int size = node_comm->get_size();
+
+    if (size <= 1) {
+        return nullptr;
+    }
+
+    size_t segment_size = get_segment_size(size);
+    char name[CCL_SHM_BARRIER_NAME_LEN] = { 0 };
+    int fd = -1;
+
+    if (rank == 0) {
+        static std::atomic<int> segment_counter{ 0 };
+        snprintf(name,
+                 sizeof(name),
+                 "/ccl-barrier-%d-%d-%d",
+                 static_cast<int>(getuid()),
+                 static_cast<int>(getpid()),
+                 segment_counter++);
+
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd >= 0 && ftruncate(fd, segment_size)) {
+            close(fd);
+            shm_unlink(name);
+            fd = -1;
+        }
+
+        if (fd < 0) {
+            LOG_WARN("can't create shm barrier segment ", name, ", errno: ", strerror(errno));
+            name[0] = '\0';
+        }
+    }
+
+    /* only the name of leader is used */
+    std::vector<char> names(size * sizeof(name));
+    ccl::utils::allgather(node_comm, name, names.data(), sizeof(name));
+    const char* segment_name = names.data();
+
+    void* segment = MAP_FAILED;
+    if (segment_name[0]) {
+        if (rank != 0) {
+            fd = shm_open(segment_name, O_RDWR, 0);
+        }
+
+        if (fd >= 0) {
+            segment = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+        }
+
+        if (segment == MAP_FAILED) {
+            LOG_WARN("can't map shm barrier segment ", segment_name, ", errno: ", strerror(errno));
+        }
+    }
+
+    /* after this exchange every rank has mapped the segment or failed, so name can be released */
+    int is_mapped = (segment != MAP_FAILED);
+    std::vector<int> all_mapped(size, 0);
+    ccl::utils::allgather(node_comm, &is_mapped, all_mapped.data(), sizeof(is_mapped));
+
+    if (rank == 0 && segment_name[0]) {
+        shm_unlink(segment_name);
+    }
+
+    if (std::any_of(all_mapped.begin(), all_mapped.end(), [](int value) {
+            return !value;
+        })) {
+        if (is_mapped) {
+            munmap(segment, segment_size);
+        }
+        LOG_DEBUG("shm barrier is not available for node comm of size ", size);
+        return nullptr;
+    }
+
+    return std::shared_ptr<ccl_shm_barrier>(
+        new ccl_shm_barrier(rank, size, segment, segment_size));
+}
+
+ccl_shm_barrier::ccl_shm_barrier(int local_rank,
+                                 int local_size,
+                                 void* segment,
+                                 size_t segment_size)
+        : local_rank(local_rank),
+          local_size(local_size),
+          segment(segment),
+          segment_size(segment_size) {
+    /* segment is zero-filled by ftruncate, that is generation 0 for every flag */
+    release_flag = static_cast<flag*>(segment);
+    arrive_flags = release_flag + 1;
+}
+
+ccl_shm_barrier::~ccl_shm_barrier() {
+    if (munmap(segment, segment_size)) {
+        LOG_ERROR("can't unmap shm barrier segment, errno: ", strerror(errno));
+    }
+}
+
+void ccl_shm_barrier::store_max(std::atomic<uint64_t>& value, uint64_t gen) {
+    uint64_t current = value.load(std::memory_order_relaxed);
+    while (current < gen &&
+           !value.compare_exchange_weak(current, gen, std::memory_order_release)) {
+    }
+}
+
+void ccl_shm_barrier::arrive(uint64_t gen) {
+    store_max(arrive_flags[local_rank].value, gen);
+}
+
+bool ccl_shm_barrier::is_arrived(uint64_t gen) const {
+    for (int idx = 1; idx < local_size; idx++) {
+        if (arrive_flags[idx].value.load(std::memory_order_acquire) < gen) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ccl_shm_barrier::release(uint64_t gen) {
+    store_max(release_flag->value, gen);
+}
+
+bool ccl_shm_barrier::is_released(uint64_t gen) const {
+    return release_flag->value.load(std::memory_order_acquire) >= gen;
+}
+
+std::string ccl_shm_barrier::to_string() const {
+    std::stringstream ss;
+    ss << "{ local_rank: " << local_rank << ", local_size: " << local_size
+       << ", generation: " << generation.load(std::memory_order_relaxed) << " }";
+    return ss.str();
+}
@@ -0,0 +1,98 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "common/utils/utils.hpp"
+
+#define CCL_SHM_BARRIER_NAME_LEN (64)
+
+class atl_base_comm;
+
+/*
+   flag barrier for the ranks of one node over a shared memory segment
+
+   - segment holds release flag of the leader (local rank 0)
+     and arrive flag of every local rank, each flag takes its own cache line
+   - flags keep generations which only grow, so the same segment can be used
+     by concurrent barriers of the comm (e.g. partial schedules):
+     the rank which has reached generation N has entered every barrier with lower generation
+*/
+class ccl_shm_barrier {
+public:
+    /*
+       collective over the node comm,
+       returns nullptr if there is a single local rank or segment can not be mapped by every rank
+    */
+    static std::shared_ptr<ccl_shm_barrier> create(const std::shared_ptr<atl_base_comm>& node_comm);
+
+    ccl_shm_barrier(const ccl_shm_barrier&) = delete;
+    ccl_shm_barrier& operator=(const ccl_shm_barrier&) = delete;
+    ~ccl_shm_barrier();
+
+    int get_local_rank() const {
+        return local_rank;
+    }
+
+    int get_local_size() const {
+        return local_size;
+    }
+
+    bool is_leader() const {
+        return local_rank == 0;
+    }
+
+    uint64_t next_generation() {
+        return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    void arrive(uint64_t gen);
+    /* checked by leader only */
+    bool is_arrived(uint64_t gen) const;
+
+    /* called by leader only */
+    void release(uint64_t gen);
+    bool is_released(uint64_t gen) const;
+
+    std::string to_string() const;
+
+private:
+    struct alignas(CACHELINE_SIZE) flag {
+        std::atomic<uint64_t> value;
+    };
+
+    ccl_shm_barrier(int local_rank, int local_size, void* segment, size_t segment_size);
+
+    static size_t get_segment_size(int local_size) {
+        return (local_size + 1) * sizeof(flag);
+    }
+
+    static void store_max(std::atomic<uint64_t>& value, uint64_t gen);
+
+    int local_rank;
+    int local_size;
+
+    void* segment;
+    size_t segment_size;
+
+    flag* release_flag;
+    flag* arrive_flags;
+
+    std::atomic<uint64_t> generation{ 0 };
+};
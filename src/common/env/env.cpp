@@ -25,6 +25,7 @@
 #include "common/global/global.hpp"
 #include "common/log/log.hpp"
 #include "exec/exec.hpp"
+#include "sched/cache/cache.hpp"
 #include "oneapi/ccl/environment.hpp"
 #include "common/utils/version.hpp"
 
@@ -42,7 +43,8 @@ std::map<ccl_priority_mode, std::string> env_data::priority_mode_names = {
 };
 
 std::map<ccl_atl_transport, std::string> env_data::atl_transport_names = {
-    std::make_pair(ccl_atl_ofi, "ofi")
+    std::make_pair(ccl_atl_ofi, "ofi"),
+    std::make_pair(ccl_atl_shm, "shm")
 #ifdef CCL_ENABLE_MPI
         ,
     std::make_pair(ccl_atl_mpi, "mpi")
@@ -86,13 +88,20 @@ env_data::env_data()
           queue_dump(false),
           sched_dump(false),
           sched_profile(false),
+          sched_dag(false),
           entry_max_update_time_sec(CCL_ENV_SIZET_NOT_SPECIFIED),
+          enable_trace(false),
+          trace_buffer_size(16384),
+          trace_file("ccl_trace"),
 
           fw_type(ccl_framework_none),
 
           worker_count(1),
           worker_offload(true),
           worker_wait(true),
+          worker_hybrid_wait(false),
+          worker_spin_time(CCL_ENV_SIZET_NOT_SPECIFIED),
+          worker_block_timeout(1),
           worker_affinity_set(0),
 #ifdef CCL_ENABLE_MPI
           atl_transport(ccl_atl_mpi),
@@ -101,13 +110,16 @@ env_data::env_data()
 #endif // CCL_ENABLE_MPI
           kvs_init_mode(kvs_mode::pmi),
           kvs_connection_timeout(120),
+          kvs_tree_radix(0),
           kvs_mpi_allgather(true),
           kvs_use_mpi_ranks(false),
           enable_shm(0),
           enable_rma(0),
+          atl_shm_ring_cells(4),
           enable_hmem(0),
           atl_send_proxy(ccl_atl_send_proxy_none),
           enable_atl_cache(1),
+          atl_cache_capacity(1024),
           enable_sync_coll(0),
           enable_extra_ep(0),
           enable_auto_cache(0),
@@ -122,6 +134,9 @@ env_data::env_data()
           mnic_offset(ATL_MNIC_OFFSET_NONE),
 
           enable_algo_fallback(1),
+          enable_algo_autotune(0),
+          algo_autotune_max_size(4 * 1024 * 1024),
+          algo_autotune_iters(8),
           enable_unordered_coll(0),
 
           enable_fusion(0),
@@ -129,18 +144,22 @@ env_data::env_data()
           fusion_count_threshold(256),
           fusion_check_urgent(1),
           fusion_cycle_ms(0.2),
+          fusion_zero_copy(0),
 
           priority_mode(ccl_priority_none),
           spin_count(100),
           yield_type(ccl_yield_pause),
           max_short_size(0),
           bcast_part_count(CCL_ENV_SIZET_NOT_SPECIFIED),
+          barrier_radix(4),
+          enable_barrier_shm(true),
           cache_key_type(ccl_cache_key_match_id),
 #ifdef CCL_ENABLE_SYCL
           enable_cache_flush(1),
 #else // CCL_ENABLE_SYCL
           enable_cache_flush(0),
 #endif // CCL_ENABLE_SYCL
+          sched_cache_pool_size(1),
           enable_buffer_cache(1),
           enable_strict_order(0),
           staging_buffer(ccl_staging_regular),
@@ -232,6 +251,7 @@ env_data::env_data()
 
           allreduce_nreduce_buffering(0),
           allreduce_nreduce_segment_size(CCL_ENV_SIZET_NOT_SPECIFIED),
+          allreduce_ring_segment_size(4 * 1024 * 1024),
 
           allreduce_2d_chunk_count(1),
           allreduce_2d_min_chunk_size(65536),
@@ -364,7 +384,13 @@ env_data::env_data()
           enable_profiling(0),
 
           bf16_impl_type(ccl_bf16_scalar),
-          fp16_impl_type(ccl_fp16_no_compiler_support) {
+          fp16_impl_type(ccl_fp16_no_compiler_support),
+          reduce_impl_type(ccl_reduce_scalar),
+          reduce_thread_count(0),
+          reduce_thread_threshold(4 * 1024 * 1024),
+          copy_nontemporal_threshold(0),
+          copy_thread_threshold(0),
+          reduce_scatter_batch_reduce(0) {
 }
 
 void env_data::parse() {
@@ -376,6 +402,7 @@ void env_data::parse() {
     p.env_2_type(CCL_QUEUE_DUMP, queue_dump);
     p.env_2_type(CCL_SCHED_DUMP, sched_dump);
     p.env_2_type(CCL_SCHED_PROFILE, sched_profile);
+    p.env_2_type(CCL_SCHED_DAG, sched_dag);
     p.env_2_type(CCL_ENTRY_MAX_UPDATE_TIME_SEC, entry_max_update_time_sec);
     CCL_THROW_IF_NOT(
         entry_max_update_time_sec == CCL_ENV_SIZET_NOT_SPECIFIED || entry_max_update_time_sec > 0,
@@ -383,6 +410,12 @@ void env_data::parse() {
         CCL_ENTRY_MAX_UPDATE_TIME_SEC,
         " ",
         entry_max_update_time_sec);
+    p.env_2_type(CCL_TRACE, enable_trace);
+    p.env_2_type(CCL_TRACE_BUFFER_SIZE, trace_buffer_size);
+    CCL_THROW_IF_NOT(
+        trace_buffer_size > 0, "incorrect ", CCL_TRACE_BUFFER_SIZE, " ", trace_buffer_size);
+    p.env_2_type(CCL_TRACE_FILE, trace_file);
+    CCL_THROW_IF_NOT(!trace_file.empty(), "incorrect ", CCL_TRACE_FILE, ": empty value");
 
     if (fw_type == ccl_framework_none) {
         /* try to automatically detect framework */
@@ -411,14 +444,35 @@ void env_data::parse() {
     CCL_THROW_IF_NOT(worker_count >= 1, "incorrect ", CCL_WORKER_COUNT, " ", worker_count);
     p.env_2_type(CCL_WORKER_OFFLOAD, worker_offload);
     p.env_2_type(CCL_WORKER_WAIT, worker_wait);
+    p.env_2_type(CCL_WORKER_HYBRID_WAIT, worker_hybrid_wait);
+    p.env_2_type(CCL_WORKER_SPIN_TIME, (size_t&)worker_spin_time);
+    p.env_2_type(CCL_WORKER_BLOCK_TIMEOUT, worker_block_timeout);
+    CCL_THROW_IF_NOT(worker_block_timeout >= 1,
+                     "incorrect ",
+                     CCL_WORKER_BLOCK_TIMEOUT,
+                     " ",
+                     worker_block_timeout);
 
     p.env_2_atl_transport(atl_transport_names, atl_transport);
     p.env_2_enum(CCL_KVS_MODE, kvs_mode_names, kvs_init_mode);
     p.env_2_type(CCL_KVS_CONNECTION_TIMEOUT, kvs_connection_timeout);
+    p.env_2_type(CCL_KVS_TREE_RADIX, kvs_tree_radix);
+    CCL_THROW_IF_NOT(kvs_tree_radix == 0 || kvs_tree_radix >= 2,
+                     "unexpected ",
+                     CCL_KVS_TREE_RADIX,
+                     " ",
+                     kvs_tree_radix,
+                     ", expected 0 or not less than 2");
     p.env_2_type(CCL_KVS_MPI_ALLGATHER, kvs_mpi_allgather);
     p.env_2_type(CCL_KVS_USE_MPI_RANKS, kvs_use_mpi_ranks);
     p.env_2_type(CCL_ATL_SHM, enable_shm);
     p.env_2_type(CCL_ATL_RMA, enable_rma);
+    p.env_2_type(CCL_ATL_SHM_RING_CELLS, atl_shm_ring_cells);
+    CCL_THROW_IF_NOT(atl_shm_ring_cells >= 1,
+                     "incorrect ",
+                     CCL_ATL_SHM_RING_CELLS,
+                     " ",
+                     atl_shm_ring_cells);
     p.env_2_type(CCL_ATL_HMEM, enable_hmem);
     if (atl_transport == ccl_atl_mpi && enable_hmem) {
         LOG_INFO("atl hmem requested, switch to single worker");
@@ -426,6 +480,7 @@ void env_data::parse() {
     }
     p.env_2_enum(CCL_ATL_SEND_PROXY, atl_send_proxy_names, atl_send_proxy);
     p.env_2_type(CCL_ATL_CACHE, enable_atl_cache);
+    p.env_2_type(CCL_ATL_CACHE_CAPACITY, atl_cache_capacity);
     p.env_2_type(CCL_ATL_SYNC_COLL, enable_sync_coll);
     p.env_2_type(CCL_ATL_EXTRA_EP, enable_extra_ep);
     p.env_2_type(CCL_ENABLE_AUTO_CACHE, enable_auto_cache);
@@ -444,6 +499,15 @@ void env_data::parse() {
     p.env_2_enum(CCL_MNIC_OFFSET, mnic_offset_names, mnic_offset);
 
     p.env_2_type(CCL_ALGO_FALLBACK, enable_algo_fallback);
+    p.env_2_type(CCL_ALGO_AUTOTUNE, enable_algo_autotune);
+    p.env_2_type(CCL_ALGO_AUTOTUNE_FILE, algo_autotune_file);
+    p.env_2_type(CCL_ALGO_AUTOTUNE_MAX_SIZE, algo_autotune_max_size);
+    p.env_2_type(CCL_ALGO_AUTOTUNE_ITERS, algo_autotune_iters);
+    CCL_THROW_IF_NOT(algo_autotune_iters >= 1,
+                     "incorrect ",
+                     CCL_ALGO_AUTOTUNE_ITERS,
+                     " ",
+                     algo_autotune_iters);
     // main algorithm selection
     p.env_2_type(CCL_ALLGATHER, allgather_algo_raw);
     p.env_2_type(CCL_ALLGATHERV, allgatherv_algo_raw);
@@ -476,6 +540,7 @@ void env_data::parse() {
     p.env_2_type(CCL_FUSION_COUNT_THRESHOLD, fusion_count_threshold);
     p.env_2_type(CCL_FUSION_CHECK_URGENT, fusion_check_urgent);
     p.env_2_type(CCL_FUSION_CYCLE_MS, fusion_cycle_ms);
+    p.env_2_type(CCL_FUSION_ZERO_COPY, fusion_zero_copy);
     if (enable_fusion) {
         CCL_THROW_IF_NOT(fusion_bytes_threshold >= 1,
                          "incorrect ",
@@ -500,8 +565,21 @@ void env_data::parse() {
     p.env_2_enum(CCL_YIELD, ccl_yield_type_names, yield_type);
     p.env_2_type(CCL_MAX_SHORT_SIZE, max_short_size);
     p.env_2_type(CCL_BCAST_PART_COUNT, (size_t&)bcast_part_count);
+    p.env_2_type(CCL_BARRIER_RADIX, barrier_radix);
+    CCL_THROW_IF_NOT(barrier_radix >= 2, "incorrect ", CCL_BARRIER_RADIX, " ", barrier_radix);
+    p.env_2_type(CCL_BARRIER_SHM, enable_barrier_shm);
     p.env_2_enum(CCL_CACHE_KEY, ccl_sched_key::key_type_names, cache_key_type);
     p.env_2_type(CCL_CACHE_FLUSH, enable_cache_flush);
+    p.env_2_type(CCL_SCHED_CACHE_POOL_SIZE, sched_cache_pool_size);
+    CCL_THROW_IF_NOT(sched_cache_pool_size >= 1 &&
+                         sched_cache_pool_size <= CCL_SCHED_CACHE_MAX_POOL_SIZE,
+                     "incorrect ",
+                     CCL_SCHED_CACHE_POOL_SIZE,
+                     " ",
+                     sched_cache_pool_size,
+                     ", expected [1, ",
+                     CCL_SCHED_CACHE_MAX_POOL_SIZE,
+                     "]");
     p.env_2_type(CCL_BUFFER_CACHE, enable_buffer_cache);
     p.env_2_type(CCL_STRICT_ORDER, enable_strict_order);
     if (enable_unordered_coll && enable_strict_order) {
@@ -599,6 +677,12 @@ void env_data::parse() {
 
     p.env_2_type(CCL_ALLREDUCE_NREDUCE_BUFFERING, allreduce_nreduce_buffering);
     p.env_2_type(CCL_ALLREDUCE_NREDUCE_SEGMENT_SIZE, (size_t&)allreduce_nreduce_segment_size);
+    p.env_2_type(CCL_ALLREDUCE_RING_SEGMENT_SIZE, allreduce_ring_segment_size);
+    CCL_THROW_IF_NOT(allreduce_ring_segment_size >= 1,
+                     "incorrect ",
+                     CCL_ALLREDUCE_RING_SEGMENT_SIZE,
+                     " ",
+                     allreduce_ring_segment_size);
 
     p.env_2_type(CCL_DTREE_PARTITION_COUNT, (size_t&)dtree_partition_count);
 
@@ -788,6 +872,18 @@ void env_data::parse() {
                      "unsupported FP16 impl type: ",
                      fp16_env_impl_names[fp16_impl_type]);
 
+    auto reduce_impl_types = ccl_reduce_get_impl_types();
+    reduce_impl_type = *reduce_impl_types.rbegin();
+    p.env_2_enum(CCL_REDUCE_IMPL, reduce_impl_names, reduce_impl_type);
+    CCL_THROW_IF_NOT(reduce_impl_types.find(reduce_impl_type) != reduce_impl_types.end(),
+                     "unsupported reduce impl type: ",
+                     reduce_impl_names[reduce_impl_type]);
+    p.env_2_type(CCL_REDUCE_THREAD_COUNT, reduce_thread_count);
+    p.env_2_type(CCL_REDUCE_THREAD_THRESHOLD, reduce_thread_threshold);
+    p.env_2_type(CCL_COPY_NONTEMPORAL_THRESHOLD, copy_nontemporal_threshold);
+    p.env_2_type(CCL_COPY_THREAD_THRESHOLD, copy_thread_threshold);
+    p.env_2_type(CCL_REDUCE_SCATTER_BATCH_REDUCE, reduce_scatter_batch_reduce);
+
     p.warn_about_unused_var();
 }
 
@@ -864,30 +960,48 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
     LOG_INFO_PROFILED(CCL_WORKER_COUNT, ": ", worker_count);
     LOG_INFO_PROFILED(CCL_WORKER_OFFLOAD, ": ", worker_offload);
     LOG_INFO_PROFILED(CCL_WORKER_WAIT, ": ", worker_wait);
+    LOG_INFO_PROFILED(CCL_WORKER_HYBRID_WAIT, ": ", worker_hybrid_wait);
+    LOG_INFO_PROFILED(CCL_WORKER_SPIN_TIME,
+                      ": ",
+                      (worker_spin_time != CCL_ENV_SIZET_NOT_SPECIFIED)
+                          ? std::to_string(worker_spin_time)
+                          : CCL_ENV_STR_NOT_SPECIFIED);
+    LOG_INFO_PROFILED(CCL_WORKER_BLOCK_TIMEOUT, ": ", worker_block_timeout);
 
     LOG_INFO_PROFILED(CCL_LOG_LEVEL, ": ", str_by_enum(ccl_logger::level_names, log_level));
     LOG_INFO_PROFILED(CCL_ABORT_ON_THROW, ": ", abort_on_throw);
     LOG_INFO_PROFILED(CCL_QUEUE_DUMP, ": ", queue_dump);
     LOG_INFO_PROFILED(CCL_SCHED_DUMP, ": ", sched_dump);
     LOG_INFO_PROFILED(CCL_SCHED_PROFILE, ": ", sched_profile);
+    LOG_INFO_PROFILED(CCL_SCHED_DAG, ": ", sched_dag);
     LOG_INFO_PROFILED(CCL_ENTRY_MAX_UPDATE_TIME_SEC,
                       ": ",
                       (entry_max_update_time_sec != CCL_ENV_SIZET_NOT_SPECIFIED)
                           ? std::to_string(entry_max_update_time_sec)
                           : CCL_ENV_STR_NOT_SPECIFIED);
+    LOG_INFO_PROFILED(CCL_TRACE, ": ", enable_trace);
+    if (enable_trace) {
+        LOG_INFO_PROFILED(CCL_TRACE_BUFFER_SIZE, ": ", trace_buffer_size);
+        LOG_INFO_PROFILED(CCL_TRACE_FILE, ": ", trace_file);
+    }
 
     LOG_INFO_PROFILED(CCL_FRAMEWORK, ": ", str_by_enum(ccl_framework_type_names, fw_type));
 
     LOG_INFO_PROFILED(CCL_ATL_TRANSPORT, ": ", str_by_enum(atl_transport_names, atl_transport));
     LOG_INFO_PROFILED(CCL_KVS_MODE, ": ", str_by_enum(kvs_mode_names, kvs_init_mode));
     LOG_INFO_PROFILED(CCL_KVS_CONNECTION_TIMEOUT, ": ", kvs_connection_timeout);
+    LOG_INFO_PROFILED(CCL_KVS_TREE_RADIX, ": ", kvs_tree_radix);
     LOG_INFO_PROFILED(CCL_KVS_MPI_ALLGATHER, ": ", kvs_mpi_allgather);
     LOG_INFO_PROFILED(CCL_KVS_USE_MPI_RANKS, ": ", kvs_use_mpi_ranks);
     LOG_INFO_PROFILED(CCL_ATL_SHM, ": ", enable_shm);
     LOG_INFO_PROFILED(CCL_ATL_RMA, ": ", enable_rma);
+    if (atl_transport == ccl_atl_shm) {
+        LOG_INFO_PROFILED(CCL_ATL_SHM_RING_CELLS, ": ", atl_shm_ring_cells);
+    }
     LOG_INFO_PROFILED(CCL_ATL_HMEM, ": ", enable_hmem);
     LOG_INFO_PROFILED(CCL_ATL_SEND_PROXY, ": ", str_by_enum(atl_send_proxy_names, atl_send_proxy));
     LOG_INFO_PROFILED(CCL_ATL_CACHE, ": ", enable_atl_cache);
+    LOG_INFO_PROFILED(CCL_ATL_CACHE_CAPACITY, ": ", atl_cache_capacity);
     LOG_DEBUG(CCL_ATL_SYNC_COLL, ": ", enable_sync_coll);
     LOG_DEBUG(CCL_ATL_EXTRA_EP, ": ", enable_extra_ep);
     LOG_DEBUG(CCL_ENABLE_AUTO_CACHE, ": ", enable_auto_cache);
@@ -904,6 +1018,13 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
     LOG_INFO_PROFILED(CCL_MNIC_OFFSET, ": ", str_by_enum(mnic_offset_names, mnic_offset));
 
     LOG_INFO_PROFILED(CCL_ALGO_FALLBACK, ": ", enable_algo_fallback);
+    LOG_INFO_PROFILED(CCL_ALGO_AUTOTUNE, ": ", enable_algo_autotune);
+    LOG_INFO_PROFILED(CCL_ALGO_AUTOTUNE_FILE,
+                      ": ",
+                      (algo_autotune_file.length()) ? algo_autotune_file
+                                                    : CCL_ENV_STR_NOT_SPECIFIED);
+    LOG_INFO_PROFILED(CCL_ALGO_AUTOTUNE_MAX_SIZE, ": ", algo_autotune_max_size);
+    LOG_INFO_PROFILED(CCL_ALGO_AUTOTUNE_ITERS, ": ", algo_autotune_iters);
     LOG_INFO_PROFILED(CCL_ALLGATHER,
                       ": ",
                       (allgather_algo_raw.length()) ? allgather_algo_raw : CCL_ENV_STR_NOT_SPECIFIED);
@@ -969,6 +1090,7 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
     LOG_INFO_PROFILED(CCL_FUSION_COUNT_THRESHOLD, ": ", fusion_count_threshold);
     LOG_INFO_PROFILED(CCL_FUSION_CHECK_URGENT, ": ", fusion_check_urgent);
     LOG_INFO_PROFILED(CCL_FUSION_CYCLE_MS, ": ", fusion_cycle_ms);
+    LOG_INFO_PROFILED(CCL_FUSION_ZERO_COPY, ": ", fusion_zero_copy);
 
     LOG_INFO_PROFILED(CCL_PRIORITY, ": ", str_by_enum(priority_mode_names, priority_mode));
     LOG_INFO_PROFILED(CCL_SPIN_COUNT, ": ", spin_count);
@@ -978,8 +1100,11 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
                       ": ",
                       (bcast_part_count != CCL_ENV_SIZET_NOT_SPECIFIED) ? std::to_string(bcast_part_count)
                                                                         : CCL_ENV_STR_NOT_SPECIFIED);
+    LOG_INFO_PROFILED(CCL_BARRIER_RADIX, ": ", barrier_radix);
+    LOG_INFO_PROFILED(CCL_BARRIER_SHM, ": ", enable_barrier_shm);
     LOG_INFO_PROFILED(CCL_CACHE_KEY, ": ", str_by_enum(ccl_sched_key::key_type_names, cache_key_type));
     LOG_INFO_PROFILED(CCL_CACHE_FLUSH, ": ", enable_cache_flush);
+    LOG_INFO_PROFILED(CCL_SCHED_CACHE_POOL_SIZE, ": ", sched_cache_pool_size);
     LOG_INFO_PROFILED(CCL_BUFFER_CACHE, ": ", enable_buffer_cache);
     LOG_INFO_PROFILED(CCL_STRICT_ORDER, ": ", enable_strict_order);
     LOG_INFO_PROFILED(CCL_STAGING_BUFFER, ": ", str_by_enum(staging_buffer_names, staging_buffer));
@@ -1070,6 +1195,7 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
                       (allreduce_nreduce_segment_size != CCL_ENV_SIZET_NOT_SPECIFIED)
                           ? std::to_string(allreduce_nreduce_segment_size)
                           : CCL_ENV_STR_NOT_SPECIFIED);
+    LOG_INFO_PROFILED(CCL_ALLREDUCE_RING_SEGMENT_SIZE, ": ", allreduce_ring_segment_size);
 
     LOG_INFO_PROFILED(CCL_DTREE_PARTITION_COUNT,
                       ": ",
@@ -1221,6 +1347,12 @@ void env_data::print(int rank, bool is_profile_mode, bool is_mt_enabled) {
 
     LOG_INFO_PROFILED(CCL_BF16, ": ", str_by_enum(bf16_impl_names, bf16_impl_type));
     LOG_INFO_PROFILED(CCL_FP16, ": ", str_by_enum(fp16_impl_names, fp16_impl_type));
+    LOG_INFO_PROFILED(CCL_REDUCE_IMPL, ": ", str_by_enum(reduce_impl_names, reduce_impl_type));
+    LOG_INFO_PROFILED(CCL_REDUCE_THREAD_COUNT, ": ", reduce_thread_count);
+    LOG_INFO_PROFILED(CCL_REDUCE_THREAD_THRESHOLD, ": ", reduce_thread_threshold);
+    LOG_INFO_PROFILED(CCL_COPY_NONTEMPORAL_THRESHOLD, ": ", copy_nontemporal_threshold);
+    LOG_INFO_PROFILED(CCL_COPY_THREAD_THRESHOLD, ": ", copy_thread_threshold);
+    LOG_INFO_PROFILED(CCL_REDUCE_SCATTER_BATCH_REDUCE, ": ", reduce_scatter_batch_reduce);
 
     char* ccl_root = getenv("CCL_ROOT");
     LOG_INFO_PROFILED("CCL_ROOT: ", (ccl_root) ? ccl_root : CCL_ENV_STR_NOT_SPECIFIED);
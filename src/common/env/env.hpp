@@ -29,6 +29,7 @@
 #include "common/utils/yield.hpp"
 #include "comp/bf16/bf16_utils.hpp"
 #include "comp/fp16/fp16_utils.hpp"
+#include "comp/reduce/reduce_utils.hpp"
 #include "sched/cache/cache.hpp"
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
 #include "common/global/ze/ze_fd_manager.hpp"
@@ -44,7 +45,8 @@ enum ccl_priority_mode { ccl_priority_none,
                          ccl_priority_lifo };
 
 enum ccl_atl_transport { ccl_atl_ofi,
-                         ccl_atl_mpi };
+                         ccl_atl_mpi,
+                         ccl_atl_shm };
 
 enum ccl_atl_send_proxy {
     ccl_atl_send_proxy_none,
@@ -114,13 +116,20 @@ public:
     bool queue_dump;
     bool sched_dump;
     bool sched_profile;
+    bool sched_dag;
     ssize_t entry_max_update_time_sec;
+    bool enable_trace;
+    size_t trace_buffer_size;
+    std::string trace_file;
 
     ccl_framework_type fw_type;
 
     size_t worker_count;
     bool worker_offload;
     bool worker_wait;
+    bool worker_hybrid_wait;
+    ssize_t worker_spin_time;
+    size_t worker_block_timeout;
     bool worker_affinity_set;
     std::vector<ssize_t> worker_affinity;
     std::vector<ssize_t> worker_mem_affinity;
@@ -128,13 +137,16 @@ public:
     ccl_atl_transport atl_transport;
     kvs_mode kvs_init_mode;
     int kvs_connection_timeout;
+    size_t kvs_tree_radix;
     bool kvs_mpi_allgather;
     bool kvs_use_mpi_ranks;
     bool enable_shm;
     bool enable_rma;
+    size_t atl_shm_ring_cells;
     bool enable_hmem;
     ccl_atl_send_proxy atl_send_proxy;
     bool enable_atl_cache;
+    size_t atl_cache_capacity;
     bool enable_sync_coll;
     bool enable_extra_ep;
     bool enable_auto_cache;
@@ -158,6 +170,10 @@ public:
     std::shared_ptr<ccl_selection_table_t<ccl_coll_recv_algo>> fallback_recv, store_fallback_recv;
     std::shared_ptr<ccl_selection_table_t<ccl_coll_send_algo>> fallback_send, store_fallback_send;
     bool enable_algo_fallback;
+    bool enable_algo_autotune;
+    std::string algo_autotune_file;
+    size_t algo_autotune_max_size;
+    size_t algo_autotune_iters;
     // main algorithm selection
     std::string allgather_algo_raw;
     std::string allgatherv_algo_raw;
@@ -191,14 +207,18 @@ public:
     int fusion_count_threshold;
     bool fusion_check_urgent;
     float fusion_cycle_ms;
+    bool fusion_zero_copy;
 
     ccl_priority_mode priority_mode;
     size_t spin_count;
     ccl_yield_type yield_type;
     size_t max_short_size;
     ssize_t bcast_part_count;
+    size_t barrier_radix;
+    bool enable_barrier_shm;
     ccl_cache_key_type cache_key_type;
     bool enable_cache_flush;
+    size_t sched_cache_pool_size;
     bool enable_buffer_cache;
     bool enable_strict_order;
     ccl_staging_buffer staging_buffer;
@@ -284,6 +304,7 @@ public:
 
     bool allreduce_nreduce_buffering;
     ssize_t allreduce_nreduce_segment_size;
+    size_t allreduce_ring_segment_size;
 
     size_t allreduce_2d_chunk_count;
     size_t allreduce_2d_min_chunk_size;
@@ -398,6 +419,12 @@ public:
 
     ccl_bf16_impl_type bf16_impl_type;
     ccl_fp16_impl_type fp16_impl_type;
+    ccl_reduce_impl_type reduce_impl_type;
+    size_t reduce_thread_count;
+    size_t reduce_thread_threshold;
+    size_t copy_nontemporal_threshold;
+    size_t copy_thread_threshold;
+    bool reduce_scatter_batch_reduce;
 
     template <class T>
     static std::string str_by_enum(const std::map<T, std::string>& values, const T& val) {
@@ -57,8 +57,16 @@ constexpr const char* CCL_ABORT_ON_THROW = "CCL_ABORT_ON_THROW";
 constexpr const char* CCL_QUEUE_DUMP = "CCL_QUEUE_DUMP";
 constexpr const char* CCL_SCHED_DUMP = "CCL_SCHED_DUMP";
 constexpr const char* CCL_SCHED_PROFILE = "CCL_SCHED_PROFILE";
+// progress all schedules through the graph of entries, not only ones with explicit deps
+constexpr const char* CCL_SCHED_DAG = "CCL_SCHED_DAG";
 // maximum amount of time in seconds an entry can spend in update. for debug purpose
 constexpr const char* CCL_ENTRY_MAX_UPDATE_TIME_SEC = "CCL_ENTRY_MAX_UPDATE_TIME_SEC";
+// record sched/entry/transport events into per-thread rings and dump them as Chrome trace
+constexpr const char* CCL_TRACE = "CCL_TRACE";
+// number of events in per-thread trace ring, rounded up to power of two
+constexpr const char* CCL_TRACE_BUFFER_SIZE = "CCL_TRACE_BUFFER_SIZE";
+// trace file prefix, pid and .json suffix are appended
+constexpr const char* CCL_TRACE_FILE = "CCL_TRACE_FILE";
 
 constexpr const char* CCL_FRAMEWORK = "CCL_FRAMEWORK";
 
@@ -79,6 +87,34 @@ constexpr const char* CCL_WORKER_COUNT = "CCL_WORKER_COUNT";
 
 constexpr const char* CCL_WORKER_OFFLOAD = "CCL_WORKER_OFFLOAD";
 constexpr const char* CCL_WORKER_WAIT = "CCL_WORKER_WAIT";
+/**
+ * @brief Set to make a worker with active operations block on transport completion events
+ *
+ * @details The worker spins for CCL_WORKER_SPIN_TIME microseconds without progress,
+ * then blocks on the wait object of the transport (OFI CQ wait fd)
+ * for up to CCL_WORKER_BLOCK_TIMEOUT milliseconds.
+ * Transports without wait objects keep polling.
+ * "0" - Busy polling while operations are in flight.
+ * "1" - Spin then block.
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_WORKER_HYBRID_WAIT = "CCL_WORKER_HYBRID_WAIT";
+/**
+ * @brief Set the spin time in microseconds before the worker blocks in hybrid wait mode
+ *
+ * @details If not set, the spin time is calibrated at worker start
+ * from the cost of a blocking wait and wake-up.
+ */
+constexpr const char* CCL_WORKER_SPIN_TIME = "CCL_WORKER_SPIN_TIME";
+/**
+ * @brief Set the maximum time in milliseconds the worker blocks in hybrid wait mode
+ *
+ * @details Bounds the delay of progress which is not signalled by the transport.
+ *
+ * By-default: "1"
+ */
+constexpr const char* CCL_WORKER_BLOCK_TIMEOUT = "CCL_WORKER_BLOCK_TIMEOUT";
 
 /**
  * @addtogroup OneCCLvars
@@ -145,6 +181,17 @@ constexpr const char* CCL_KVS_MODE = "CCL_KVS_MODE";
  * By-default: "120"
  */
 constexpr const char* CCL_KVS_CONNECTION_TIMEOUT = "CCL_KVS_CONNECTION_TIMEOUT";
+/**
+ * @brief Set the radix of the rank-to-rank tree used for barrier and allgather
+ * during communicator creation with the internal kvs
+ *
+ * @details "<value>" - Number of children per rank, barrier and allgather of
+ * endpoint names take O(log(ranks)) round trips instead of going through the kvs server \n
+ * "0" - Barrier and allgather go through the kvs server
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_KVS_TREE_RADIX = "CCL_KVS_TREE_RADIX";
 /**
  * @brief Set whether to use MPI_Allgather or custom implementation while creating a communicator.
  *
@@ -200,11 +247,24 @@ constexpr const char* CCL_ATL_TRANSPORT = "CCL_ATL_TRANSPORT";
 constexpr const char* CCL_ATL_SHM = "CCL_ATL_SHM";
 /**  @} */
 constexpr const char* CCL_ATL_RMA = "CCL_ATL_RMA";
+// number of 4KB cells in each point-to-point ring of the shm transport
+constexpr const char* CCL_ATL_SHM_RING_CELLS = "CCL_ATL_SHM_RING_CELLS";
 constexpr const char* CCL_ATL_HMEM = "CCL_ATL_HMEM";
 constexpr const char* CCL_ATL_SEND_PROXY = "CCL_ATL_SEND_PROXY";
 constexpr const char* CCL_ATL_SYNC_COLL = "CCL_ATL_SYNC_COLL";
 constexpr const char* CCL_ATL_EXTRA_EP = "CCL_ATL_EXTRA_EP";
 constexpr const char* CCL_ATL_CACHE = "CCL_ATL_CACHE";
+/**
+ * @brief Set the maximal number of memory registrations kept in ATL cache per endpoint
+ *
+ * @details "<value>" - When the cache is full, least recently used registrations
+ * which are not used by pending operations are released.
+ * The value is also limited by the provider's limit of memory registrations. \n
+ * "0" - No limit
+ *
+ * By-default: "1024"
+ */
+constexpr const char* CCL_ATL_CACHE_CAPACITY = "CCL_ATL_CACHE_CAPACITY";
 /**
  * @addtogroup OneCCLvars
  * @{
@@ -261,6 +321,12 @@ constexpr const char* CCL_MNIC_COUNT = "CCL_MNIC_COUNT";
 constexpr const char* CCL_MNIC_OFFSET = "CCL_MNIC_OFFSET";
 
 constexpr const char* CCL_ALGO_FALLBACK = "CCL_ALGO_FALLBACK";
+// time allreduce algorithms for each message size class at comm creation and keep the fastest one
+constexpr const char* CCL_ALGO_AUTOTUNE = "CCL_ALGO_AUTOTUNE";
+// file to load tuning results from and to store them to at finalization
+constexpr const char* CCL_ALGO_AUTOTUNE_FILE = "CCL_ALGO_AUTOTUNE_FILE";
+constexpr const char* CCL_ALGO_AUTOTUNE_MAX_SIZE = "CCL_ALGO_AUTOTUNE_MAX_SIZE";
+constexpr const char* CCL_ALGO_AUTOTUNE_ITERS = "CCL_ALGO_AUTOTUNE_ITERS";
 /**
  * @addtogroup OneCCLvars
  * @{
@@ -309,10 +375,16 @@ constexpr const char* CCL_ALLGATHERV = "CCL_ALLGATHERV";
  *  - nreduce       May be beneficial for imbalanced workloads
  *  - ring          Reduce_scatter + allgather ring. Use CCL_RS_CHUNK_COUNT
  *      and CCL_RS_MIN_CHUNK_SIZE to control pipelining on reduce_scatter phase.
+ *  - ring_pipelined  Ring over segments of the buffer, allgather of a segment
+ *      overlaps with reduce_scatter of the next ones.
+ *      Use CCL_ALLREDUCE_RING_SEGMENT_SIZE to control the segment size.
  *  - double_tree   Double-tree algorithm
  *  - recursive_doubling    Recursive doubling algorithm
  *  - 2d            Two-dimensional algorithm (reduce_scatter + allreduce + allgather).
  *                  Only available for Host (CPU) buffers.
+ *  - hier          Hierarchical algorithm, reduce inside of cpu package, then between
+ *                  packages of the node, allreduce between nodes and broadcast back.
+ *                  Only available for Host (CPU) buffers.
  *  - topo          Topo scaleup algorithm (available if sycl and l0 are enabled)
  *
  *
@@ -350,12 +422,16 @@ constexpr const char* CCL_ALLTOALLV = "CCL_ALLTOALLV";
  * @details
  * BARRIER algorithms
  *  - direct    Based on MPI_Ibarrier
- *  - ring      Ring-based algorithm
+ *  - ring      Dissemination algorithm with CCL_BARRIER_RADIX peers per round
+ *  - tree      Gather to rank 0 and release over tree with CCL_BARRIER_RADIX children
+ *  - shm       Shared memory flags on the node, dissemination among node leaders.
+ *              Internal subcommunicators fall back to ring or tree
  *
  * Note: BARRIER does not support the CCL_BARRIER_SCALEOUT environment
  * variable. To change the algorithm for scaleout, use CCL_BARRIER.
+ * Ranges in CCL_BARRIER refer to the communicator size instead of the message size.
  *
- * By-default: "direct"
+ * By-default: "direct" for MPI transport, otherwise "ring"
  */
 constexpr const char* CCL_BARRIER = "CCL_BARRIER";
 /**
@@ -596,14 +672,32 @@ constexpr const char* CCL_FUSION_BYTES_THRESHOLD = "CCL_FUSION_BYTES_THRESHOLD";
 constexpr const char* CCL_FUSION_COUNT_THRESHOLD = "CCL_FUSION_COUNT_THRESHOLD";
 constexpr const char* CCL_FUSION_CHECK_URGENT = "CCL_FUSION_CHECK_URGENT";
 constexpr const char* CCL_FUSION_CYCLE_MS = "CCL_FUSION_CYCLE_MS";
+/**
+ * @brief Enable zero-copy fusion of host allreduce operations
+ *
+ * @details The fused operation runs ring allreduce directly over the list
+ * of user buffers instead of packing them into the fusion buffer
+ * and unpacking the result. \n
+ * "0" - Pack into the fusion buffer \n
+ * "1" - Use user buffers as segments of the fused operation
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_FUSION_ZERO_COPY = "CCL_FUSION_ZERO_COPY";
 
 constexpr const char* CCL_PRIORITY = "CCL_PRIORITY";
 constexpr const char* CCL_SPIN_COUNT = "CCL_SPIN_COUNT";
 constexpr const char* CCL_YIELD = "CCL_YIELD";
 constexpr const char* CCL_MAX_SHORT_SIZE = "CCL_MAX_SHORT_SIZE";
 constexpr const char* CCL_BCAST_PART_COUNT = "CCL_BCAST_PART_COUNT";
+// number of peers per round in ring (dissemination) barrier and fan-in/fan-out of tree barrier
+constexpr const char* CCL_BARRIER_RADIX = "CCL_BARRIER_RADIX";
+// create shared memory flag barrier for ranks of the same host on first shm barrier
+constexpr const char* CCL_BARRIER_SHM = "CCL_BARRIER_SHM";
 constexpr const char* CCL_CACHE_KEY = "CCL_CACHE_KEY";
 constexpr const char* CCL_CACHE_FLUSH = "CCL_CACHE_FLUSH";
+// number of schedule instances per cache key, allows launches with the same key to overlap
+constexpr const char* CCL_SCHED_CACHE_POOL_SIZE = "CCL_SCHED_CACHE_POOL_SIZE";
 constexpr const char* CCL_BUFFER_CACHE = "CCL_BUFFER_CACHE";
 constexpr const char* CCL_STRICT_ORDER = "CCL_STRICT_ORDER";
 constexpr const char* CCL_STAGING_BUFFER = "CCL_STAGING_BUFFER";
@@ -927,6 +1021,17 @@ constexpr const char* CCL_REDUCE_PIPE_CHUNK_COUNT = "CCL_REDUCE_PIPE_CHUNK_COUNT
 constexpr const char* CCL_ALLREDUCE_NREDUCE_BUFFERING = "CCL_ALLREDUCE_NREDUCE_BUFFERING";
 constexpr const char* CCL_ALLREDUCE_NREDUCE_SEGMENT_SIZE = "CCL_ALLREDUCE_NREDUCE_SEGMENT_SIZE";
 
+/**
+ * @brief Set segment size in bytes for ring_pipelined allreduce algorithm
+ *
+ * @details
+ * Smaller segments start the allgather phase earlier,
+ * larger segments reduce the number of messages.
+ *
+ * By-default: "4194304"
+ */
+constexpr const char* CCL_ALLREDUCE_RING_SEGMENT_SIZE = "CCL_ALLREDUCE_RING_SEGMENT_SIZE";
+
 constexpr const char* CCL_ALLREDUCE_2D_CHUNK_COUNT = "CCL_ALLREDUCE_2D_CHUNK_COUNT";
 constexpr const char* CCL_ALLREDUCE_2D_MIN_CHUNK_SIZE = "CCL_ALLREDUCE_2D_MIN_CHUNK_SIZE";
 constexpr const char* CCL_ALLREDUCE_2D_SWITCH_DIMS = "CCL_ALLREDUCE_2D_SWITCH_DIMS";
@@ -1237,3 +1342,66 @@ constexpr const char* CCL_PROFILING_ENABLE = "CCL_PROFILING_ENABLE";
 
 constexpr const char* CCL_BF16 = "CCL_BF16";
 constexpr const char* CCL_FP16 = "CCL_FP16";
+/**
+ * @brief Set ISA of reduction kernels for integer, float32 and float64 datatypes
+ *
+ * @details
+ * - scalar     Plain C++ loops
+ * - avx2       AVX2 kernels
+ * - avx512f    AVX512F/AVX512BW kernels
+ *
+ * By-default: the widest ISA supported by CPU
+ */
+constexpr const char* CCL_REDUCE_IMPL = "CCL_REDUCE_IMPL";
+/**
+ * @brief Set the number of helper threads used to split large host reductions
+ *
+ * @details "<value>" - The number of helper threads per process.
+ * Helper threads are pinned to cores from the NUMA node of the first worker
+ * which are not used by workers (see CCL_WORKER_AFFINITY). \n
+ * "0" - Reductions are executed by worker threads only
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_REDUCE_THREAD_COUNT = "CCL_REDUCE_THREAD_COUNT";
+/**
+ * @brief Set the minimal reduction size in bytes to use helper threads
+ *
+ * @details "<value>" - Reductions with size less than the value are executed
+ * by the worker thread only
+ *
+ * By-default: "4194304"
+ */
+constexpr const char* CCL_REDUCE_THREAD_THRESHOLD = "CCL_REDUCE_THREAD_THRESHOLD";
+/**
+ * @brief Set the minimal host copy size in bytes to use non-temporal stores
+ *
+ * @details "<value>" - Copies with size not less than the value bypass the cache
+ * on stores, smaller copies use regular stores unless non-temporal stores
+ * are requested by the algorithm. \n
+ * "0" - Non-temporal stores are used only when requested by the algorithm
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_COPY_NONTEMPORAL_THRESHOLD = "CCL_COPY_NONTEMPORAL_THRESHOLD";
+/**
+ * @brief Set the minimal host copy size in bytes to use helper threads
+ *
+ * @details "<value>" - Copies with size not less than the value are split
+ * between the worker and reduction helper threads (see CCL_REDUCE_THREAD_COUNT) \n
+ * "0" - Copies are executed by the worker thread only
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_COPY_THREAD_THRESHOLD = "CCL_COPY_THREAD_THRESHOLD";
+/**
+ * @brief Enable single pass reduction in naive reduce_scatter for bf16 and fp16
+ *
+ * @details "1" - Inputs from all peers are received into a temporary buffer of
+ * (comm_size - 1) * recv_count elements and reduced at once with fp32 accumulation,
+ * so the result is rounded once. Receives are not overlapped with reductions. \n
+ * "0" - Inputs are reduced into the result buffer as they arrive from each peer
+ *
+ * By-default: "0"
+ */
+constexpr const char* CCL_REDUCE_SCATTER_BATCH_REDUCE = "CCL_REDUCE_SCATTER_BATCH_REDUCE";
@@ -14,10 +14,12 @@
  limitations under the License.
 */
 #include "coll/selection/selection.hpp"
+#include "coll/selection/tuner.hpp"
 #include "common/api_wrapper/api_wrapper.hpp"
 #include "common/api_wrapper/pmix_api_wrapper.hpp"
 #include "common/datatype/datatype.hpp"
 #include "common/global/global.hpp"
+#include "common/log/trace.hpp"
 #include "exec/exec.hpp"
 #include "fusion/fusion.hpp"
 #include "parallelizer/parallelizer.hpp"
@@ -81,6 +83,10 @@ ccl::status global_data::reset() {
         executor is responsible for resize logic and has own multi-step reset
      */
     executor.reset();
+
+    /* workers are stopped, rings are not updated anymore */
+    ccl::trace::finalize();
+
     reset_resize_dependent_objects();
     reset_resize_independent_objects();
 
@@ -114,6 +120,9 @@ ccl::status global_data::init() {
     recycle_storage.reset(new ccl::recycle_storage());
     shared_data.reset(new shared_resources());
 
+    ccl::trace::init(
+        env_object.enable_trace, env_object.trace_buffer_size, env_object.trace_file.c_str());
+
     init_resize_dependent_objects();
     init_resize_independent_objects();
 
@@ -140,6 +149,10 @@ void global_data::init_resize_independent_objects() {
     algorithm_selector.reset(new ccl_algorithm_selector_wrapper<CCL_COLL_LIST>());
     algorithm_selector->init();
 
+    if (env_object.enable_algo_autotune) {
+        algorithm_tuner.reset(new ccl_algorithm_tuner());
+    }
+
     hwloc_wrapper.reset(new ccl_hwloc_wrapper());
 
     metrics_profiler.reset(new profile::metrics_manager());
@@ -157,6 +170,7 @@ void global_data::reset_resize_dependent_objects() {
 void global_data::reset_resize_independent_objects() {
     parallelizer.reset();
     algorithm_selector.reset();
+    algorithm_tuner.reset();
     hwloc_wrapper.reset();
     metrics_profiler.reset();
 }
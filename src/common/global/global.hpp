@@ -42,6 +42,8 @@ class ccl_fusion_manager;
 template <ccl_coll_type... registered_types_id>
 class ccl_algorithm_selector_wrapper;
 
+class ccl_algorithm_tuner;
+
 namespace ccl {
 
 class buffer_cache;
@@ -87,6 +89,7 @@ public:
     std::unique_ptr<ccl_parallelizer> parallelizer;
     std::unique_ptr<ccl_fusion_manager> fusion_manager;
     std::unique_ptr<ccl_algorithm_selector_wrapper<CCL_COLL_LIST>> algorithm_selector;
+    std::unique_ptr<ccl_algorithm_tuner> algorithm_tuner;
     std::unique_ptr<ccl_hwloc_wrapper> hwloc_wrapper;
     std::unique_ptr<profile::metrics_manager> metrics_profiler;
     std::unique_ptr<profile::timestamp_manager> timestamp_manager;
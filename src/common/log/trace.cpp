@@ -0,0 +1,307 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common/log/log.hpp"
+#include "common/log/trace.hpp"
+
+namespace ccl {
+namespace trace {
+
+bool is_enabled = false;
+
+namespace {
+
+std::atomic<ring*> rings[CCL_TRACE_MAX_THREADS];
+std::atomic<size_t> ring_count{ 0 };
+size_t ring_capacity = 0;
+
+char file_path[CCL_TRACE_MAX_PATH_LEN];
+
+uint64_t start_tsc = 0;
+uint64_t start_time_ns = 0;
+
+std::atomic_flag is_dumping = ATOMIC_FLAG_INIT;
+
+struct sigaction prev_action;
+bool is_signal_set = false;
+
+uint64_t get_monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+const char* get_category(event_type type) {
+    switch (type) {
+        case event_type::entry_start:
+        case event_type::entry_complete: return "entry";
+        case event_type::sched_start:
+        case event_type::sched_complete: return "sched";
+        case event_type::atl_post:
+        case event_type::atl_complete: return "atl";
+        default: return "cache";
+    }
+}
+
+const char* get_phase(event_type type) {
+    switch (type) {
+        case event_type::entry_start:
+        case event_type::sched_start:
+        case event_type::atl_post: return "b";
+        case event_type::entry_complete:
+        case event_type::sched_complete:
+        case event_type::atl_complete: return "e";
+        default: return "i";
+    }
+}
+
+/* buffered writer over raw fd, no allocations to be usable from signal handler */
+class json_writer {
+public:
+    explicit json_writer(int fd) : fd(fd) {}
+
+    ~json_writer() {
+        flush();
+    }
+
+    void put(const char* str) {
+        while (*str) {
+            if (len == sizeof(buf)) {
+                flush();
+            }
+            buf[len++] = *str++;
+        }
+    }
+
+    void put_u64(uint64_t value, int min_digits = 1) {
+        char digits[24];
+        int count = 0;
+        do {
+            digits[count++] = '0' + value % 10;
+            value /= 10;
+        } while (value || count < min_digits);
+
+        char str[25];
+        for (int idx = 0; idx < count; idx++) {
+            str[idx] = digits[count - idx - 1];
+        }
+        str[count] = '\0';
+        put(str);
+    }
+
+    void put_hex(uint64_t value) {
+        static const char hex_digits[] = "0123456789abcdef";
+        char str[19] = "0x";
+        for (int idx = 0; idx < 16; idx++) {
+            str[2 + idx] = hex_digits[(value >> (60 - 4 * idx)) & 0xf];
+        }
+        str[18] = '\0';
+        put(str);
+    }
+
+    void flush() {
+        size_t offset = 0;
+        while (offset < len) {
+            ssize_t ret = write(fd, buf + offset, len - offset);
+            if (ret <= 0) {
+                break;
+            }
+            offset += ret;
+        }
+        len = 0;
+    }
+
+private:
+    int fd;
+    char buf[8192];
+    size_t len = 0;
+};
+
+void write_event(json_writer& writer, const event& e, long tid, int pid, double ns_per_tick) {
+    uint64_t ns =
+        (e.tsc > start_tsc) ? static_cast<uint64_t>((e.tsc - start_tsc) * ns_per_tick) : 0;
+
+    writer.put("{\"name\":\"");
+    writer.put((e.name) ? e.name : "unknown");
+    writer.put("\",\"cat\":\"");
+    writer.put(get_category(e.type));
+    writer.put("\",\"ph\":\"");
+    writer.put(get_phase(e.type));
+    writer.put("\",\"ts\":");
+    writer.put_u64(ns / 1000);
+    writer.put(".");
+    writer.put_u64(ns % 1000, 3);
+    writer.put(",\"pid\":");
+    writer.put_u64(pid);
+    writer.put(",\"tid\":");
+    writer.put_u64(tid);
+    if (get_phase(e.type)[0] == 'i') {
+        writer.put(",\"s\":\"t\"");
+    }
+    else {
+        writer.put(",\"id\":\"");
+        writer.put_hex(reinterpret_cast<uintptr_t>(e.id));
+        writer.put("\"");
+    }
+    writer.put(",\"args\":{\"arg\":");
+    writer.put_u64(e.arg);
+    writer.put("}}");
+}
+
+void signal_handler(int sig, siginfo_t* info, void* context) {
+    dump();
+
+    /* default action of the dump signal is termination, so only custom handlers are chained */
+    if ((prev_action.sa_flags & SA_SIGINFO) && prev_action.sa_sigaction) {
+        prev_action.sa_sigaction(sig, info, context);
+    }
+    else if (!(prev_action.sa_flags & SA_SIGINFO) && prev_action.sa_handler != SIG_DFL &&
+             prev_action.sa_handler != SIG_IGN) {
+        prev_action.sa_handler(sig);
+    }
+}
+
+} // namespace
+
+void init(bool enable, size_t ring_size, const char* file_prefix) {
+    if (!enable || is_enabled) {
+        return;
+    }
+
+    ring_capacity = 64;
+    while (ring_capacity < ring_size) {
+        ring_capacity *= 2;
+    }
+
+    snprintf(file_path, sizeof(file_path), "%s.%d.json", file_prefix, getpid());
+
+    start_tsc = get_tsc();
+    start_time_ns = get_monotonic_ns();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = signal_handler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(CCL_TRACE_DUMP_SIGNAL, &action, &prev_action) == 0) {
+        is_signal_set = true;
+    }
+    else {
+        LOG_WARN("can't set trace dump signal handler, errno ", errno);
+    }
+
+    is_enabled = true;
+
+    LOG_INFO("trace is enabled, ring size ",
+             ring_capacity,
+             " events per thread, file ",
+             file_path,
+             ", dump signal ",
+             CCL_TRACE_DUMP_SIGNAL);
+}
+
+void finalize() {
+    if (!is_enabled) {
+        return;
+    }
+
+    dump();
+
+    if (is_signal_set) {
+        sigaction(CCL_TRACE_DUMP_SIGNAL, &prev_action, nullptr);
+        is_signal_set = false;
+    }
+
+    LOG_INFO("trace is written to ", file_path);
+}
+
+ring* register_thread() {
+    if (ring_count.load(std::memory_order_relaxed) >= CCL_TRACE_MAX_THREADS) {
+        return nullptr;
+    }
+
+    size_t idx = ring_count.fetch_add(1);
+    if (idx >= CCL_TRACE_MAX_THREADS) {
+        return nullptr;
+    }
+
+    ring* r = new ring;
+    r->events = new event[ring_capacity]();
+    r->mask = ring_capacity - 1;
+    r->tid = syscall(SYS_gettid);
+    rings[idx].store(r, std::memory_order_release);
+
+    get_thread_ring() = r;
+    return r;
+}
+
+void dump() {
+    if (!ring_capacity || is_dumping.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+
+    uint64_t tsc_delta = get_tsc() - start_tsc;
+    uint64_t time_delta = get_monotonic_ns() - start_time_ns;
+    double ns_per_tick = (tsc_delta) ? static_cast<double>(time_delta) / tsc_delta : 1.0;
+
+    int fd = open(file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        int pid = getpid();
+        bool is_first = true;
+        json_writer writer(fd);
+
+        writer.put("{\"traceEvents\":[\n");
+
+        size_t count = ring_count.load(std::memory_order_acquire);
+        if (count > CCL_TRACE_MAX_THREADS) {
+            count = CCL_TRACE_MAX_THREADS;
+        }
+
+        for (size_t idx = 0; idx < count; idx++) {
+            /* ring may be not published yet */
+            ring* r = rings[idx].load(std::memory_order_acquire);
+            if (!r) {
+                continue;
+            }
+
+            uint64_t head = r->head.load(std::memory_order_acquire);
+            uint64_t first = (head > ring_capacity) ? head - ring_capacity : 0;
+            for (uint64_t pos = first; pos < head; pos++) {
+                if (!is_first) {
+                    writer.put(",\n");
+                }
+                write_event(writer, r->events[pos & r->mask], r->tid, pid, ns_per_tick);
+                is_first = false;
+            }
+        }
+
+        writer.put("\n]}\n");
+        writer.flush();
+        close(fd);
+    }
+
+    is_dumping.clear(std::memory_order_release);
+}
+
+} // namespace trace
+} // namespace ccl
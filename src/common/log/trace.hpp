@@ -0,0 +1,126 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+   flight recorder for hot path events
+
+   - every thread writes fixed-size binary events into its own ring,
+     ring is registered on the first event of the thread and is never freed,
+     so it survives thread exit and can be dumped at any time
+   - recording is a TSC read and a 32 bytes store, no locks or formatting,
+     old events are overwritten when the ring is full
+   - rings are dumped to Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+     on finalization and on CCL_TRACE_DUMP_SIGNAL, dump uses async-signal-safe calls only
+   - a ring may be dumped while its owner writes, such event can be torn
+*/
+
+#define CCL_TRACE_MAX_THREADS    (1024)
+#define CCL_TRACE_DUMP_SIGNAL    (SIGUSR2)
+#define CCL_TRACE_MAX_PATH_LEN   (4096)
+
+namespace ccl {
+namespace trace {
+
+enum class event_type : uint32_t {
+    entry_start,
+    entry_complete,
+    sched_start,
+    sched_complete,
+    atl_post,
+    atl_complete,
+    cache_hit,
+    cache_miss
+};
+
+struct event {
+    uint64_t tsc;
+    const void* id;
+    /* must point to static storage, it is read on dump */
+    const char* name;
+    uint32_t arg;
+    event_type type;
+};
+
+static_assert(sizeof(event) == 32, "unexpected trace event size");
+
+struct ring {
+    event* events;
+    uint64_t mask;
+    long tid;
+    std::atomic<uint64_t> head{ 0 };
+};
+
+extern bool is_enabled;
+
+void init(bool enable, size_t ring_size, const char* file_prefix);
+void finalize();
+void dump();
+
+ring* register_thread();
+
+inline uint64_t get_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+inline ring*& get_thread_ring() {
+    static thread_local ring* thread_ring = nullptr;
+    return thread_ring;
+}
+
+inline void record(event_type type, const void* id, const char* name, uint32_t arg = 0) {
+    ring* r = get_thread_ring();
+    if (__builtin_expect(!r, 0)) {
+        r = register_thread();
+        if (!r) {
+            return;
+        }
+    }
+
+    /* single writer, head is published for dump only */
+    uint64_t pos = r->head.load(std::memory_order_relaxed);
+    event& e = r->events[pos & r->mask];
+    e.tsc = get_tsc();
+    e.id = id;
+    e.name = name;
+    e.arg = arg;
+    e.type = type;
+    r->head.store(pos + 1, std::memory_order_release);
+}
+
+} // namespace trace
+} // namespace ccl
+
+/* arguments are evaluated only if tracing is enabled */
+#define CCL_TRACE(type, id, name, ...) \
+    do { \
+        if (__builtin_expect(ccl::trace::is_enabled, 0)) { \
+            ccl::trace::record(ccl::trace::event_type::type, id, name, ##__VA_ARGS__); \
+        } \
+    } while (0)
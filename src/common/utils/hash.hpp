@@ -15,6 +15,9 @@
 */
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <tuple>
 
 namespace ccl {
@@ -52,5 +55,87 @@ struct tuple_hash {
     }
 };
 
+struct hash128_value {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    bool operator==(const hash128_value& other) const {
+        return (lo == other.lo) && (hi == other.hi);
+    }
+    bool operator!=(const hash128_value& other) const {
+        return !(*this == other);
+    }
+};
+
+/* streaming 128-bit hash, two murmur3-like lanes over 64-bit words */
+class hash128 {
+public:
+    void update(uint64_t word) {
+        lo ^= mix_word(word, c1, c2, 31);
+        lo = rotl(lo, 27) + hi;
+        lo = lo * 5 + 0x52dce729;
+
+        hi ^= mix_word(word, c2, c1, 33);
+        hi = rotl(hi, 31) + lo;
+        hi = hi * 5 + 0x38495ab5;
+
+        length += sizeof(word);
+    }
+
+    void update(const void* data, size_t bytes) {
+        const char* ptr = static_cast<const char*>(data);
+        size_t word_count = bytes / sizeof(uint64_t);
+        for (size_t idx = 0; idx < word_count; idx++) {
+            uint64_t word;
+            memcpy(&word, ptr + idx * sizeof(word), sizeof(word));
+            update(word);
+        }
+
+        size_t tail_bytes = bytes % sizeof(uint64_t);
+        if (tail_bytes) {
+            uint64_t word = 0;
+            memcpy(&word, ptr + word_count * sizeof(word), tail_bytes);
+            update(word ^ (static_cast<uint64_t>(tail_bytes) << 56));
+        }
+    }
+
+    hash128_value digest() const {
+        uint64_t h1 = lo ^ length;
+        uint64_t h2 = hi ^ length;
+        h1 += h2;
+        h2 += h1;
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+        return { h1, h2 };
+    }
+
+private:
+    static constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+    static constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    static uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t mix_word(uint64_t word, uint64_t m1, uint64_t m2, int r) {
+        return rotl(word * m1, r) * m2;
+    }
+
+    static uint64_t fmix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    uint64_t lo = 0x9e3779b97f4a7c15ULL;
+    uint64_t hi = 0x6a09e667f3bcc909ULL;
+    uint64_t length = 0;
+};
+
 } // namespace utils
 } // namespace ccl
@@ -20,6 +20,9 @@
 #include <cstdint>
 #include <immintrin.h>
 
+/* distance in bytes for software prefetch of the source in NTS loops */
+#define CCL_MEMCPY_PREFETCH_DISTANCE (1024)
+
 namespace ccl {
 
 __attribute__((__always_inline__)) inline int is_nts_supported() {
@@ -42,34 +45,53 @@ __attribute__((__always_inline__)) inline int is_nts_supported() {
 #endif // CCL_AVX_COMPILER
 }
 
+__attribute__((__always_inline__)) inline int is_nts_avx512_supported() {
+#ifdef CCL_AVX_COMPILER
+    static int is_avx512f_enabled = -1;
+    if (is_avx512f_enabled == -1) {
+        uint32_t reg[4];
+        is_avx512f_enabled = 0;
+        /* CPUID.(EAX=01H):ECX.OSXSAVE [bit 27] */
+        __asm__ __volatile__("cpuid"
+                             : "=a"(reg[0]), "=b"(reg[1]), "=c"(reg[2]), "=d"(reg[3])
+                             : "a"(1));
+        if (reg[2] & (1u << 27)) {
+            uint32_t xcr0_lo, xcr0_hi;
+            __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            /* XCR0: SSE, AVX, opmask, ZMM_Hi256, Hi16_ZMM state */
+            int is_zmm_enabled = ((xcr0_lo & 0xE6) == 0xE6);
+            /* CPUID.(EAX=07H, ECX=0):EBX.AVX512F [bit 16] */
+            __asm__ __volatile__("cpuid"
+                                 : "=a"(reg[0]), "=b"(reg[1]), "=c"(reg[2]), "=d"(reg[3])
+                                 : "a"(7), "c"(0));
+            is_avx512f_enabled = is_zmm_enabled && ((reg[1] & (1u << 16)) >> 16);
+        }
+        LOG_DEBUG("AVX512F enabled: ", is_avx512f_enabled);
+    }
+    return is_avx512f_enabled;
+#else // CCL_AVX_COMPILER
+    return 0;
+#endif // CCL_AVX_COMPILER
+}
+
 void memcpy(void *dst, const void *src, size_t size) {
     std::copy((char *)(src), (char *)(src) + (size), (char *)(dst));
 }
 
-void memcpy_nontemporal(void *dst, const void *src, size_t size) {
-    char *d = (char *)dst;
-    const char *s = (const char *)src;
-    size_t n = size;
-
-    if (!is_nts_supported()) {
-        LOG_DEBUG("NTS-based memcpy is requested but not supported, use regular memcpy");
-    }
-
 #ifdef CCL_AVX_COMPILER
-    if ((n <= 256) || !is_nts_supported()) {
-        memcpy(d, s, n);
-        return;
-    }
 
-    if (((uintptr_t)d) & 63) {
-        const uintptr_t t = 64 - (((uintptr_t)d) & 63);
-        memcpy(d, s, t);
-        d += t;
-        s += t;
-        n -= t;
+__attribute__((__always_inline__)) inline void memcpy_prefetch(const char *s, size_t bytes) {
+    for (size_t offset = 0; offset < bytes; offset += 64) {
+        _mm_prefetch(s + CCL_MEMCPY_PREFETCH_DISTANCE + offset, _MM_HINT_NTA);
     }
+}
 
+/* expects 64-byte aligned destination */
+__attribute__((target("avx"))) static void memcpy_nontemporal_avx(char *d,
+                                                                  const char *s,
+                                                                  size_t n) {
     while (n >= 256) {
+        memcpy_prefetch(s, 256);
         __m256i ymm0 = _mm256_loadu_si256((__m256i const *)(s + (32 * 0)));
         __m256i ymm1 = _mm256_loadu_si256((__m256i const *)(s + (32 * 1)));
         __m256i ymm2 = _mm256_loadu_si256((__m256i const *)(s + (32 * 2)));
@@ -116,6 +138,100 @@ void memcpy_nontemporal(void *dst, const void *src, size_t size) {
     if (n & 63) {
         memcpy(d, s, (n & 63));
     }
+}
+
+/* expects 64-byte aligned destination */
+__attribute__((target("avx512f"))) static void memcpy_nontemporal_avx512(char *d,
+                                                                         const char *s,
+                                                                         size_t n) {
+    while (n >= 512) {
+        memcpy_prefetch(s, 512);
+        __m512i zmm0 = _mm512_loadu_si512((void const *)(s + (64 * 0)));
+        __m512i zmm1 = _mm512_loadu_si512((void const *)(s + (64 * 1)));
+        __m512i zmm2 = _mm512_loadu_si512((void const *)(s + (64 * 2)));
+        __m512i zmm3 = _mm512_loadu_si512((void const *)(s + (64 * 3)));
+        __m512i zmm4 = _mm512_loadu_si512((void const *)(s + (64 * 4)));
+        __m512i zmm5 = _mm512_loadu_si512((void const *)(s + (64 * 5)));
+        __m512i zmm6 = _mm512_loadu_si512((void const *)(s + (64 * 6)));
+        __m512i zmm7 = _mm512_loadu_si512((void const *)(s + (64 * 7)));
+        _mm512_stream_si512((__m512i *)(d + (64 * 0)), zmm0);
+        _mm512_stream_si512((__m512i *)(d + (64 * 1)), zmm1);
+        _mm512_stream_si512((__m512i *)(d + (64 * 2)), zmm2);
+        _mm512_stream_si512((__m512i *)(d + (64 * 3)), zmm3);
+        _mm512_stream_si512((__m512i *)(d + (64 * 4)), zmm4);
+        _mm512_stream_si512((__m512i *)(d + (64 * 5)), zmm5);
+        _mm512_stream_si512((__m512i *)(d + (64 * 6)), zmm6);
+        _mm512_stream_si512((__m512i *)(d + (64 * 7)), zmm7);
+        d += 512;
+        s += 512;
+        n -= 512;
+    }
+
+    if (n & 256) {
+        __m512i zmm0 = _mm512_loadu_si512((void const *)(s + (64 * 0)));
+        __m512i zmm1 = _mm512_loadu_si512((void const *)(s + (64 * 1)));
+        __m512i zmm2 = _mm512_loadu_si512((void const *)(s + (64 * 2)));
+        __m512i zmm3 = _mm512_loadu_si512((void const *)(s + (64 * 3)));
+        _mm512_stream_si512((__m512i *)(d + (64 * 0)), zmm0);
+        _mm512_stream_si512((__m512i *)(d + (64 * 1)), zmm1);
+        _mm512_stream_si512((__m512i *)(d + (64 * 2)), zmm2);
+        _mm512_stream_si512((__m512i *)(d + (64 * 3)), zmm3);
+        d += 256;
+        s += 256;
+    }
+
+    if (n & 128) {
+        __m512i zmm0 = _mm512_loadu_si512((void const *)(s + (64 * 0)));
+        __m512i zmm1 = _mm512_loadu_si512((void const *)(s + (64 * 1)));
+        _mm512_stream_si512((__m512i *)(d + (64 * 0)), zmm0);
+        _mm512_stream_si512((__m512i *)(d + (64 * 1)), zmm1);
+        d += 128;
+        s += 128;
+    }
+
+    if (n & 64) {
+        __m512i zmm0 = _mm512_loadu_si512((void const *)(s + (64 * 0)));
+        _mm512_stream_si512((__m512i *)(d + (64 * 0)), zmm0);
+        d += 64;
+        s += 64;
+    }
+
+    if (n & 63) {
+        memcpy(d, s, (n & 63));
+    }
+}
+
+#endif // CCL_AVX_COMPILER
+
+void memcpy_nontemporal(void *dst, const void *src, size_t size) {
+    char *d = (char *)dst;
+    const char *s = (const char *)src;
+    size_t n = size;
+
+    if (!is_nts_supported()) {
+        LOG_DEBUG("NTS-based memcpy is requested but not supported, use regular memcpy");
+    }
+
+#ifdef CCL_AVX_COMPILER
+    if ((n <= 256) || !is_nts_supported()) {
+        memcpy(d, s, n);
+        return;
+    }
+
+    if (((uintptr_t)d) & 63) {
+        const uintptr_t t = 64 - (((uintptr_t)d) & 63);
+        memcpy(d, s, t);
+        d += t;
+        s += t;
+        n -= t;
+    }
+
+    if (is_nts_avx512_supported()) {
+        memcpy_nontemporal_avx512(d, s, n);
+    }
+    else {
+        memcpy_nontemporal_avx(d, s, n);
+    }
 
     _mm_sfence();
 
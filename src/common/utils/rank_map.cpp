@@ -0,0 +1,145 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <sstream>
+
+#include "common/utils/rank_map.hpp"
+#include "common/utils/utils.hpp"
+
+ccl_rank_map::ccl_rank_map(const std::vector<int>& values) {
+    for (auto value : values) {
+        push_back(value);
+    }
+}
+
+ccl_rank_map ccl_rank_map::identity(int size) {
+    ccl_rank_map map;
+    map.count = size;
+    return map;
+}
+
+void ccl_rank_map::push_back(int value) {
+    if (type == map_type::explicit_table) {
+        values.push_back(value);
+        count++;
+        return;
+    }
+
+    if (count == 0) {
+        offset = value;
+        stride = 1;
+        count++;
+        return;
+    }
+
+    if (count == 1) {
+        if (value <= offset) {
+            make_explicit();
+            push_back(value);
+            return;
+        }
+        stride = value - offset;
+        count++;
+        return;
+    }
+
+    if (value == (*this)[count]) {
+        count++;
+        return;
+    }
+
+    // consecutive run is interrupted, try to continue it as the first block
+    if (type == map_type::strided && stride == 1 && value > offset + static_cast<int>(count)) {
+        type = map_type::block_cyclic;
+        block_size = count;
+        stride = value - offset;
+        count++;
+        return;
+    }
+
+    make_explicit();
+    push_back(value);
+}
+
+void ccl_rank_map::clear() {
+    *this = ccl_rank_map();
+}
+
+int ccl_rank_map::find(int value) const {
+    if (type == map_type::explicit_table) {
+        for (size_t idx = 0; idx < values.size(); idx++) {
+            if (values[idx] == value) {
+                return static_cast<int>(idx);
+            }
+        }
+        return invalid_idx;
+    }
+
+    if (count == 0 || value < offset) {
+        return invalid_idx;
+    }
+
+    size_t diff = static_cast<size_t>(value - offset);
+    size_t idx = 0;
+
+    if (type == map_type::strided) {
+        if (diff % stride) {
+            return invalid_idx;
+        }
+        idx = diff / stride;
+    }
+    else {
+        size_t pos = diff % stride;
+        if (pos >= block_size) {
+            return invalid_idx;
+        }
+        idx = (diff / stride) * block_size + pos;
+    }
+
+    return (idx < count) ? static_cast<int>(idx) : invalid_idx;
+}
+
+std::vector<int> ccl_rank_map::to_vector() const {
+    if (type == map_type::explicit_table) {
+        return values;
+    }
+
+    std::vector<int> result(count);
+    for (size_t idx = 0; idx < count; idx++) {
+        result[idx] = (*this)[idx];
+    }
+    return result;
+}
+
+std::string ccl_rank_map::to_string() const {
+    std::stringstream ss;
+    switch (type) {
+        case map_type::strided:
+            ss << "{ strided, size: " << count << ", offset: " << offset << ", stride: " << stride
+               << " }";
+            break;
+        case map_type::block_cyclic:
+            ss << "{ block_cyclic, size: " << count << ", offset: " << offset
+               << ", block: " << block_size << ", stride: " << stride << " }";
+            break;
+        default: ss << ccl::utils::vec_to_string(values); break;
+    }
+    return ss.str();
+}
+
+void ccl_rank_map::make_explicit() {
+    values = to_vector();
+    type = map_type::explicit_table;
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+   rank map (index -> value) which keeps regular patterns in O(1) space
+
+   - strided: value = offset + idx * stride, identity is offset 0 and stride 1
+   - block-cyclic: blocks of block_size consecutive values starting
+     every stride values: value = offset + (idx / block_size) * stride + idx % block_size
+   - explicit: table of values, used for any other pattern
+
+   compressed forms are used for increasing patterns only, so reverse lookup
+   is O(1) for them and linear for explicit table
+*/
+class ccl_rank_map {
+public:
+    static constexpr int invalid_idx = -1;
+
+    ccl_rank_map() = default;
+    explicit ccl_rank_map(const std::vector<int>& values);
+
+    static ccl_rank_map identity(int size);
+
+    void push_back(int value);
+    void clear();
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    int operator[](size_t idx) const {
+        switch (type) {
+            case map_type::strided: return offset + static_cast<int>(idx) * stride;
+            case map_type::block_cyclic:
+                return offset + static_cast<int>(idx / block_size) * stride +
+                       static_cast<int>(idx % block_size);
+            default: return values[idx];
+        }
+    }
+
+    // returns index of value or invalid_idx
+    int find(int value) const;
+
+    bool is_compressed() const {
+        return type != map_type::explicit_table;
+    }
+
+    std::vector<int> to_vector() const;
+    std::string to_string() const;
+
+private:
+    enum class map_type { strided, block_cyclic, explicit_table };
+
+    void make_explicit();
+
+    map_type type = map_type::strided;
+    size_t count = 0;
+    int offset = 0;
+    int stride = 1;
+    size_t block_size = 1;
+    std::vector<int> values;
+};
@@ -84,6 +84,32 @@ void ccl_bf16_reduce_scalar_impl(const void* in_buf,
     }
 }
 
+void ccl_bf16_batch_reduce_scalar_impl(const void* in_buf,
+                                       const std::vector<size_t>& offsets,
+                                       size_t in_count,
+                                       void* inout_buf,
+                                       ccl::reduction op) {
+    ccl_bf16_reduction_scalar_func_ptr func = nullptr;
+    switch (op) {
+        case ccl::reduction::sum: func = &bf16_sum_scalar; break;
+        case ccl::reduction::prod: func = &bf16_prod_scalar; break;
+        case ccl::reduction::min: func = &bf16_min_scalar; break;
+        case ccl::reduction::max: func = &bf16_max_scalar; break;
+        default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(op));
+    }
+
+    uint16_t* in_buf_int = (uint16_t*)in_buf;
+    uint16_t* inout_buf_int = (uint16_t*)inout_buf;
+
+    for (size_t i = 0; i < in_count; i++) {
+        float acc = ccl_convert_bf16_to_fp32_scalar(inout_buf_int[i]);
+        for (size_t k = 1; k < offsets.size(); k++) {
+            acc = func(ccl_convert_bf16_to_fp32_scalar(in_buf_int[offsets[k] + i]), acc);
+        }
+        inout_buf_int[i] = ccl_convert_fp32_to_bf16_scalar(acc);
+    }
+}
+
 void ccl_bf16_reduce(const void* in_buf,
                      size_t in_count,
                      void* inout_buf,
@@ -109,6 +135,41 @@ void ccl_bf16_reduce(const void* in_buf,
     }
 }
 
+void ccl_bf16_batch_reduce(const void* in_buf,
+                           const std::vector<size_t>& offsets,
+                           size_t in_count,
+                           void* inout_buf,
+                           size_t* out_count,
+                           ccl::reduction op) {
+    LOG_DEBUG("BF16 batch reduction for ", in_count, " elements, ", offsets.size(), " buffers");
+
+    if (out_count != nullptr) {
+        *out_count = in_count;
+    }
+
+    auto bf16_impl_type = ccl::global_data::env().bf16_impl_type;
+
+    if (bf16_impl_type == ccl_bf16_scalar) {
+        ccl_bf16_batch_reduce_scalar_impl(in_buf, offsets, in_count, inout_buf, op);
+    }
+    else {
+#ifdef CCL_BF16_COMPILER
+        ccl_bf16_batch_reduce_impl(in_buf, offsets, in_count, inout_buf, op);
+#else // CCL_BF16_COMPILER
+        CCL_THROW("unexpected bf16_impl_type: ", bf16_impl_type);
+#endif // CCL_BF16_COMPILER
+    }
+}
+
+void ccl_bf16_scale(void* buf, size_t count, float divisor) {
+    uint16_t* buf_int = (uint16_t*)buf;
+
+    for (size_t i = 0; i < count; i++) {
+        float value = ccl_convert_bf16_to_fp32_scalar(buf_int[i]) / divisor;
+        buf_int[i] = ccl_convert_fp32_to_bf16_scalar(value);
+    }
+}
+
 #ifdef CCL_BF16_COMPILER
 void ccl_convert_fp32_to_bf16(const void* src, void* dst) {
 #ifdef CCL_BF16_AVX512BF_COMPILER
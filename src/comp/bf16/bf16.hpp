@@ -15,6 +15,8 @@
 */
 #pragma once
 
+#include <vector>
+
 #include "oneapi/ccl/types.hpp"
 
 #ifdef CCL_BF16_TARGET_ATTRIBUTES
@@ -34,9 +36,34 @@ void ccl_bf16_reduce(const void* in_buf,
                      ccl::reduction reduction_op);
 #endif // CCL_BF16_TARGET_ATTRIBUTES
 
+/*
+   reduces inputs located at in_buf + offsets[1..n] into inout_buf in a single pass,
+   intermediate values are kept in fp32
+*/
+#ifdef CCL_BF16_TARGET_ATTRIBUTES
+#ifdef CCL_BF16_AVX512BF_COMPILER
+__attribute__((target("avx512bw,avx512vl,avx512bf16")))
+#else
+__attribute__((target("avx512bw,avx512vl")))
+#endif
+void ccl_bf16_batch_reduce(const void* in_buf, const std::vector<size_t>& offsets,
+                           size_t in_cnt, void* inout_buf, size_t* out_cnt,
+                           ccl::reduction reduction_op);
+#else // CCL_BF16_TARGET_ATTRIBUTES
+void ccl_bf16_batch_reduce(const void* in_buf,
+                           const std::vector<size_t>& offsets,
+                           size_t in_cnt,
+                           void* inout_buf,
+                           size_t* out_cnt,
+                           ccl::reduction reduction_op);
+#endif // CCL_BF16_TARGET_ATTRIBUTES
+
 void ccl_convert_fp32_to_bf16_arrays(void*, void*, size_t);
 void ccl_convert_bf16_to_fp32_arrays(void*, float*, size_t);
 
+/* divides values in place, intermediate values are kept in fp32 */
+void ccl_bf16_scale(void* buf, size_t count, float divisor);
+
 #ifdef CCL_BF16_COMPILER
 
 #ifdef CCL_BF16_TARGET_ATTRIBUTES
@@ -45,6 +45,7 @@
 
 #include <immintrin.h>
 #include <inttypes.h>
+#include <vector>
 
 #include "common/global/global.hpp"
 #include "comp/bf16/bf16_utils.hpp"
@@ -111,6 +112,43 @@ BF16_INLINE_TARGET_ATTRIBUTE void ccl_fp32_store_as_bf16_avx512bf(const void* sr
         } \
         ccl_bf16_reduce_tile_##impl_type( \
             (uint16_t*)in_buf + i, (uint16_t*)inout_buf + i, (uint8_t)(in_cnt - i), op); \
+    } \
+\
+    /* accumulates inout and all inputs in fp32 registers, stores bf16 once */ \
+    BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_batch_reduce_block_##impl_type( \
+        const void* in_buf, \
+        const std::vector<size_t>& offsets, \
+        size_t idx, \
+        uint16_t mask, \
+        void* inout_buf, \
+        ccl_bf16_reduction_func_ptr op) { \
+        __m256i vbf16 = _mm256_maskz_loadu_epi16(mask, (uint16_t*)inout_buf + idx); \
+        __m512 vfp32_acc, vfp32_in; \
+        ccl_bf16_load_as_fp32((const void*)&vbf16, (void*)&vfp32_acc); \
+        for (size_t k = 1; k < offsets.size(); k++) { \
+            vbf16 = _mm256_maskz_loadu_epi16(mask, (uint16_t*)in_buf + offsets[k] + idx); \
+            ccl_bf16_load_as_fp32((const void*)&vbf16, (void*)&vfp32_in); \
+            vfp32_acc = bf16_reduce(vfp32_in, vfp32_acc, op); \
+        } \
+        ccl_fp32_store_as_bf16_##impl_type((const void*)&vfp32_acc, (void*)&vbf16); \
+        _mm256_mask_storeu_epi16((uint16_t*)inout_buf + idx, (__mmask16)mask, vbf16); \
+    } \
+\
+    BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_batch_reduce_impl_##impl_type( \
+        const void* in_buf, \
+        const std::vector<size_t>& offsets, \
+        size_t in_cnt, \
+        void* inout_buf, \
+        ccl_bf16_reduction_func_ptr op) { \
+        size_t i = 0; \
+        for (i = 0; i + CCL_BF16_IN_M256 <= in_cnt; i += CCL_BF16_IN_M256) { \
+            ccl_bf16_batch_reduce_block_##impl_type( \
+                in_buf, offsets, i, (uint16_t)0xFFFF, inout_buf, op); \
+        } \
+        if (i < in_cnt) { \
+            uint16_t mask = ((uint16_t)0xFFFF) >> (CCL_BF16_IN_M256 - (in_cnt - i)); \
+            ccl_bf16_batch_reduce_block_##impl_type(in_buf, offsets, i, mask, inout_buf, op); \
+        } \
     }
 
 CCL_BF16_DEFINE_REDUCE_FUNC(avx512f);
@@ -118,10 +156,7 @@ CCL_BF16_DEFINE_REDUCE_FUNC(avx512f);
 CCL_BF16_DEFINE_REDUCE_FUNC(avx512bf);
 #endif // CCL_BF16_AVX512BF_COMPILER
 
-BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_reduce_impl(const void* in_buf,
-                                                           void* inout_buf,
-                                                           size_t in_cnt,
-                                                           ccl::reduction op) {
+inline ccl_bf16_reduction_func_ptr ccl_bf16_get_reduction_func(ccl::reduction op) {
     ccl_bf16_reduction_func_ptr func = nullptr;
     switch (op) {
         case ccl::reduction::sum: func = &bf16_sum_wrap; break;
@@ -130,6 +165,14 @@ BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_reduce_impl(const void* in_buf,
         case ccl::reduction::max: func = &bf16_max_wrap; break;
         default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(op));
     }
+    return func;
+}
+
+BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_reduce_impl(const void* in_buf,
+                                                           void* inout_buf,
+                                                           size_t in_cnt,
+                                                           ccl::reduction op) {
+    ccl_bf16_reduction_func_ptr func = ccl_bf16_get_reduction_func(op);
 
     auto impl_type = ccl::global_data::env().bf16_impl_type;
 
@@ -146,4 +189,26 @@ BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_reduce_impl(const void* in_buf,
     }
 }
 
+BF16_INLINE_TARGET_ATTRIBUTE_ALL void ccl_bf16_batch_reduce_impl(const void* in_buf,
+                                                                 const std::vector<size_t>& offsets,
+                                                                 size_t in_cnt,
+                                                                 void* inout_buf,
+                                                                 ccl::reduction op) {
+    ccl_bf16_reduction_func_ptr func = ccl_bf16_get_reduction_func(op);
+
+    auto impl_type = ccl::global_data::env().bf16_impl_type;
+
+    if (impl_type == ccl_bf16_avx512f) {
+        ccl_bf16_batch_reduce_impl_avx512f(in_buf, offsets, in_cnt, inout_buf, func);
+    }
+#ifdef CCL_BF16_AVX512BF_COMPILER
+    else if (impl_type == ccl_bf16_avx512bf) {
+        ccl_bf16_batch_reduce_impl_avx512bf(in_buf, offsets, in_cnt, inout_buf, func);
+    }
+#endif // CCL_BF16_AVX512BF_COMPILER
+    else {
+        CCL_THROW("unexpected bf16_impl_type: ", impl_type);
+    }
+}
+
 #endif // CCL_BF16_COMPILER
@@ -16,10 +16,12 @@
 #include "comp/bf16/bf16.hpp"
 #include "comp/comp.hpp"
 #include "comp/fp16/fp16.hpp"
+#include "comp/reduce/reduce.hpp"
 #include "common/log/log.hpp"
 #include "common/global/global.hpp"
 #include "common/utils/enums.hpp"
 #include "common/utils/memcpy.hpp"
+#include "exec/exec.hpp"
 #include "oneapi/ccl/types.hpp"
 #include "sched/queue/queue.hpp"
 
@@ -28,35 +30,6 @@
 #include <sycl/sycl.hpp>
 #endif // CCL_ENABLE_SYCL
 
-#define CCL_REDUCE(type) \
-    do { \
-        type* in_buf_##type = (type*)in_buf; \
-        type* inout_buf_##type = (type*)inout_buf; \
-        switch (reduction) { \
-            case ccl::reduction::sum: \
-                for (i = 0; i < in_count; i++) { \
-                    inout_buf_##type[i] += in_buf_##type[i]; \
-                } \
-                break; \
-            case ccl::reduction::prod: \
-                for (i = 0; i < in_count; i++) { \
-                    inout_buf_##type[i] *= in_buf_##type[i]; \
-                } \
-                break; \
-            case ccl::reduction::min: \
-                for (i = 0; i < in_count; i++) { \
-                    inout_buf_##type[i] = std::min(in_buf_##type[i], inout_buf_##type[i]); \
-                } \
-                break; \
-            case ccl::reduction::max: \
-                for (i = 0; i < in_count; i++) { \
-                    inout_buf_##type[i] = std::max(in_buf_##type[i], inout_buf_##type[i]); \
-                } \
-                break; \
-            default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(reduction)); \
-        } \
-    } while (0)
-
 ccl::status ccl_comp_copy(const void* in_buf, void* out_buf, size_t bytes, bool use_nontemporal) {
     if (bytes == 0) {
         return ccl::status::success;
@@ -64,15 +37,129 @@ ccl::status ccl_comp_copy(const void* in_buf, void* out_buf, size_t bytes, bool
 
     CCL_ASSERT(in_buf, "in_buf is null");
     CCL_ASSERT(out_buf, "out_buf is null");
-    if (use_nontemporal) {
-        ccl::memcpy_nontemporal(out_buf, in_buf, bytes);
+
+    const auto& env = ccl::global_data::env();
+
+    /* large copies would evict the working set, so they bypass the cache on stores */
+    if (env.copy_nontemporal_threshold && bytes >= env.copy_nontemporal_threshold) {
+        use_nontemporal = true;
     }
-    else {
-        ccl::memcpy(out_buf, in_buf, bytes);
+
+    auto copy_slice = [&](size_t offset, size_t count) {
+        char* dst = static_cast<char*>(out_buf) + offset;
+        const char* src = static_cast<const char*>(in_buf) + offset;
+        if (use_nontemporal) {
+            ccl::memcpy_nontemporal(dst, src, count);
+        }
+        else {
+            ccl::memcpy(dst, src, count);
+        }
+    };
+
+    bool is_parallel = false;
+    auto& executor = ccl::global_data::get().executor;
+    ccl_reduce_thread_pool* pool = (executor) ? executor->get_reduce_thread_pool() : nullptr;
+
+    if (pool && env.copy_thread_threshold && (bytes >= env.copy_thread_threshold)) {
+        is_parallel = pool->try_run(bytes, 1, copy_slice);
     }
+
+    if (!is_parallel) {
+        copy_slice(0, bytes);
+    }
+
     return ccl::status::success;
 }
 
+template <class T>
+static void ccl_comp_scale_typed(void* buf, size_t count, size_t divisor) {
+    T* typed_buf = static_cast<T*>(buf);
+    T typed_divisor = static_cast<T>(divisor);
+    for (size_t idx = 0; idx < count; idx++) {
+        typed_buf[idx] /= typed_divisor;
+    }
+}
+
+static void ccl_comp_scale_slice(void* buf,
+                                 size_t count,
+                                 const ccl_datatype& dtype,
+                                 size_t divisor) {
+    switch (dtype.idx()) {
+        case ccl::datatype::int8: ccl_comp_scale_typed<int8_t>(buf, count, divisor); break;
+        case ccl::datatype::uint8: ccl_comp_scale_typed<uint8_t>(buf, count, divisor); break;
+        case ccl::datatype::int16: ccl_comp_scale_typed<int16_t>(buf, count, divisor); break;
+        case ccl::datatype::uint16: ccl_comp_scale_typed<uint16_t>(buf, count, divisor); break;
+        case ccl::datatype::int32: ccl_comp_scale_typed<int32_t>(buf, count, divisor); break;
+        case ccl::datatype::uint32: ccl_comp_scale_typed<uint32_t>(buf, count, divisor); break;
+        case ccl::datatype::int64: ccl_comp_scale_typed<int64_t>(buf, count, divisor); break;
+        case ccl::datatype::uint64: ccl_comp_scale_typed<uint64_t>(buf, count, divisor); break;
+        case ccl::datatype::float32: ccl_comp_scale_typed<float>(buf, count, divisor); break;
+        case ccl::datatype::float64: ccl_comp_scale_typed<double>(buf, count, divisor); break;
+        case ccl::datatype::float16:
+            ccl_fp16_scale(buf, count, static_cast<float>(divisor));
+            break;
+        case ccl::datatype::bfloat16:
+            ccl_bf16_scale(buf, count, static_cast<float>(divisor));
+            break;
+        default: CCL_FATAL("unexpected dtype ", dtype.idx(), " for scaling");
+    }
+}
+
+ccl::status ccl_comp_scale(void* buf, size_t count, const ccl_datatype& dtype, size_t divisor) {
+    if (!count || divisor == 1) {
+        return ccl::status::success;
+    }
+
+    CCL_ASSERT(buf, "buf is null");
+    CCL_THROW_IF_NOT(divisor, "unexpected zero divisor");
+
+    bool is_parallel = false;
+    auto& executor = ccl::global_data::get().executor;
+    ccl_reduce_thread_pool* pool = (executor) ? executor->get_reduce_thread_pool() : nullptr;
+    size_t dtype_size = dtype.size();
+
+    if (pool && (count * dtype_size >= ccl::global_data::env().reduce_thread_threshold)) {
+        is_parallel = pool->try_run(count, dtype_size, [&](size_t offset, size_t slice_count) {
+            ccl_comp_scale_slice(
+                static_cast<char*>(buf) + offset * dtype_size, slice_count, dtype, divisor);
+        });
+    }
+
+    if (!is_parallel) {
+        ccl_comp_scale_slice(buf, count, dtype, divisor);
+    }
+
+    return ccl::status::success;
+}
+
+static void ccl_comp_reduce_slice(const void* in_buf,
+                                  size_t in_count,
+                                  void* inout_buf,
+                                  size_t* out_count,
+                                  const ccl_datatype& dtype,
+                                  ccl::reduction reduction) {
+    switch (dtype.idx()) {
+        case ccl::datatype::float16:
+            ccl_fp16_reduce(in_buf, in_count, inout_buf, out_count, reduction);
+            break;
+        case ccl::datatype::bfloat16:
+            ccl_bf16_reduce(in_buf, in_count, inout_buf, out_count, reduction);
+            break;
+        default: {
+            ccl_reduce_kernel_t kernel = ccl_reduce_get_kernel(
+                ccl::global_data::env().reduce_impl_type, dtype.idx(), reduction);
+            if (!kernel) {
+                CCL_FATAL("unexpected dtype ",
+                          dtype.idx(),
+                          " or reduction ",
+                          ccl::utils::enum_to_underlying(reduction));
+            }
+            kernel(in_buf, inout_buf, in_count);
+            break;
+        }
+    }
+}
+
 ccl::status ccl_comp_reduce_regular(const void* in_buf,
                                     size_t in_count,
                                     void* inout_buf,
@@ -87,30 +174,37 @@ ccl::status ccl_comp_reduce_regular(const void* in_buf,
         return ccl::status::success;
     }
 
+    /* partial results of average are accumulated as sum, division is done by ccl_comp_scale */
+    if (reduction == ccl::reduction::avg) {
+        reduction = ccl::reduction::sum;
+    }
+
 #ifdef CCL_ENABLE_ITT
     __itt_event comp_reduce_itt_event = ccl::profile::itt::event_get("comp_reduce_regular");
     ccl::profile::itt::event_start(comp_reduce_itt_event);
 #endif // CCL_ENABLE_ITT
 
-    size_t i;
-    switch (dtype.idx()) {
-        case ccl::datatype::int8: CCL_REDUCE(int8_t); break;
-        case ccl::datatype::uint8: CCL_REDUCE(uint8_t); break;
-        case ccl::datatype::int16: CCL_REDUCE(int16_t); break;
-        case ccl::datatype::uint16: CCL_REDUCE(uint16_t); break;
-        case ccl::datatype::int32: CCL_REDUCE(int32_t); break;
-        case ccl::datatype::uint32: CCL_REDUCE(uint32_t); break;
-        case ccl::datatype::int64: CCL_REDUCE(int64_t); break;
-        case ccl::datatype::uint64: CCL_REDUCE(uint64_t); break;
-        case ccl::datatype::float16:
-            ccl_fp16_reduce(in_buf, in_count, inout_buf, out_count, reduction);
-            break;
-        case ccl::datatype::float32: CCL_REDUCE(float); break;
-        case ccl::datatype::float64: CCL_REDUCE(double); break;
-        case ccl::datatype::bfloat16:
-            ccl_bf16_reduce(in_buf, in_count, inout_buf, out_count, reduction);
-            break;
-        default: CCL_FATAL("unexpected value ", dtype.idx()); break;
+    bool is_parallel = false;
+    auto& executor = ccl::global_data::get().executor;
+    ccl_reduce_thread_pool* pool = (executor) ? executor->get_reduce_thread_pool() : nullptr;
+
+    if (pool && (in_count * dtype.size() >= ccl::global_data::env().reduce_thread_threshold)) {
+        size_t dtype_size = dtype.size();
+        is_parallel = pool->try_run(in_count, dtype_size, [&](size_t offset, size_t count) {
+            ccl_comp_reduce_slice(static_cast<const char*>(in_buf) + offset * dtype_size,
+                                  count,
+                                  static_cast<char*>(inout_buf) + offset * dtype_size,
+                                  nullptr,
+                                  dtype,
+                                  reduction);
+        });
+        if (is_parallel && out_count) {
+            *out_count = in_count;
+        }
+    }
+
+    if (!is_parallel) {
+        ccl_comp_reduce_slice(in_buf, in_count, inout_buf, out_count, dtype, reduction);
     }
 
 #ifdef CCL_ENABLE_ITT
@@ -208,29 +302,19 @@ ccl::status ccl_comp_batch_reduce(const void* in_buf,
                                   ccl::reduction reduction,
                                   ccl::reduction_fn reduction_fn,
                                   const ccl::fn_context* context,
-                                  int bf16_keep_precision_mode,
-                                  float* tmp,
-                                  float* acc) {
-    if (bf16_keep_precision_mode) {
-        //->acc, tmp fusion_buffer_cache???
-
-        /* inout_buf => inout_buffer + offsets[0] */
-        ccl_convert_bf16_to_fp32_arrays(inout_buf, acc, in_count);
+                                  int keep_precision_mode) {
+    /* inout_buf => inout_buffer + offsets[0] */
+    if (reduction == ccl::reduction::avg) {
+        reduction = ccl::reduction::sum;
+    }
 
-        for (size_t i = 1; i < offsets.size(); i++) {
-            ccl_convert_bf16_to_fp32_arrays(
-                (char*)in_buf + dtype.size() * offsets[i], tmp, in_count);
-            ccl_comp_reduce_regular(tmp,
-                                    in_count,
-                                    acc,
-                                    out_count,
-                                    ccl::global_data::get().dtypes->get(ccl::datatype::float32),
-                                    reduction,
-                                    reduction_fn,
-                                    context);
-        }
+    bool is_fused = keep_precision_mode && (reduction != ccl::reduction::custom);
 
-        ccl_convert_fp32_to_bf16_arrays(acc, inout_buf, in_count);
+    if (is_fused && dtype.idx() == ccl::datatype::bfloat16) {
+        ccl_bf16_batch_reduce(in_buf, offsets, in_count, inout_buf, out_count, reduction);
+    }
+    else if (is_fused && dtype.idx() == ccl::datatype::float16) {
+        ccl_fp16_batch_reduce(in_buf, offsets, in_count, inout_buf, out_count, reduction);
     }
     else {
         for (size_t i = 1; i < offsets.size(); i++) {
@@ -254,6 +338,7 @@ const char* ccl_reduction_to_str(ccl::reduction type) {
         case ccl::reduction::prod: return "prod";
         case ccl::reduction::min: return "min";
         case ccl::reduction::max: return "max";
+        case ccl::reduction::avg: return "avg";
         case ccl::reduction::custom: return "custom";
         default: return "unknown";
     }
@@ -35,6 +35,9 @@ ccl::status ccl_comp_reduce(ccl_sched* sched,
                             ccl::reduction_fn reduction_fn,
                             const ccl::fn_context* context = nullptr);
 
+/* divides elements by divisor in place, finalizes average reduction */
+ccl::status ccl_comp_scale(void* buf, size_t count, const ccl_datatype& dtype, size_t divisor);
+
 ccl::status ccl_comp_batch_reduce(const void* in_buf,
                                   const std::vector<size_t>& offsets,
                                   size_t in_count,
@@ -44,8 +47,6 @@ ccl::status ccl_comp_batch_reduce(const void* in_buf,
                                   ccl::reduction reduction,
                                   ccl::reduction_fn reduction_fn,
                                   const ccl::fn_context* context,
-                                  int bf16_keep_precision_mode,
-                                  float* tmp,
-                                  float* acc);
+                                  int keep_precision_mode);
 
 const char* ccl_reduction_to_str(ccl::reduction type);
@@ -20,7 +20,11 @@
 #include "comp/fp16/fp16_intrisics.hpp"
 #include "common/utils/enums.hpp"
 
-#define CCL_FLOATS_IN_M512 16
+#include <algorithm>
+#include <cstring>
+
+#define CCL_FLOATS_IN_M512      16
+#define CCL_FP16_CONVERT_COUNT 8
 
 std::map<ccl_fp16_impl_type, std::string> fp16_impl_names = {
     std::make_pair(ccl_fp16_no_compiler_support, "no_compiler_support"),
@@ -36,6 +40,103 @@ std::map<ccl_fp16_impl_type, std::string> fp16_env_impl_names = {
     std::make_pair(ccl_fp16_avx512fp16, "avx512fp16")
 };
 
+/* software conversions for cpus without f16c, round to nearest even as vcvtps2ph does */
+static float ccl_convert_fp16_to_fp32_scalar(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exp = (value >> 10) & 0x1F;
+    uint32_t mant = value & 0x3FF;
+    uint32_t bits = 0;
+
+    if (exp == 0x1F) {
+        /* inf or quiet nan */
+        bits = sign | 0x7F800000 | (mant ? (0x400000 | (mant << 13)) : 0);
+    }
+    else if (exp != 0) {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    else if (mant == 0) {
+        bits = sign;
+    }
+    else {
+        /* subnormal fp16 is a normal fp32 */
+        exp = 113;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            exp--;
+        }
+        bits = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static uint16_t ccl_convert_fp32_to_fp16_scalar(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exp = static_cast<int32_t>((bits >> 23) & 0xFF) - 112;
+    uint32_t mant = bits & 0x7FFFFF;
+
+    if (exp == 0xFF - 112) {
+        /* inf or quiet nan */
+        return static_cast<uint16_t>(sign | 0x7C00 | (mant ? (0x200 | (mant >> 13)) : 0));
+    }
+    if (exp >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    uint32_t shift = 13;
+    uint32_t half = 0;
+    if (exp <= 0) {
+        if (exp < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        /* subnormal fp16, implicit bit becomes explicit */
+        mant |= 0x800000;
+        shift = 14 - exp;
+    }
+    else {
+        half = static_cast<uint32_t>(exp) << 10;
+    }
+
+    /* carry of the rounding may move to exponent, it gives the correct encoding */
+    half |= mant >> shift;
+    uint32_t rem = mant & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (rem > halfway || (rem == halfway && (half & 1))) {
+        half++;
+    }
+
+    return static_cast<uint16_t>(sign | half);
+}
+
+static void ccl_fp16_batch_reduce_scalar_impl(const void* in_buf,
+                                              const std::vector<size_t>& offsets,
+                                              size_t in_cnt,
+                                              void* inout_buf,
+                                              ccl::reduction op) {
+    const uint16_t* in_buf_int = (const uint16_t*)in_buf;
+    uint16_t* inout_buf_int = (uint16_t*)inout_buf;
+
+    for (size_t i = 0; i < in_cnt; i++) {
+        float acc = ccl_convert_fp16_to_fp32_scalar(inout_buf_int[i]);
+        for (size_t k = 1; k < offsets.size(); k++) {
+            float in = ccl_convert_fp16_to_fp32_scalar(in_buf_int[offsets[k] + i]);
+            switch (op) {
+                case ccl::reduction::sum: acc = in + acc; break;
+                case ccl::reduction::prod: acc = in * acc; break;
+                case ccl::reduction::min: acc = std::min(in, acc); break;
+                case ccl::reduction::max: acc = std::max(in, acc); break;
+                default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(op));
+            }
+        }
+        inout_buf_int[i] = ccl_convert_fp32_to_fp16_scalar(acc);
+    }
+}
+
 #ifdef CCL_FP16_COMPILER
 
 void ccl_fp16_reduce(const void* in_buf,
@@ -52,6 +153,47 @@ void ccl_fp16_reduce(const void* in_buf,
     ccl_fp16_reduce_impl(in_buf, inout_buf, in_cnt, op);
 }
 
+void ccl_fp16_batch_reduce(const void* in_buf,
+                           const std::vector<size_t>& offsets,
+                           size_t in_cnt,
+                           void* inout_buf,
+                           size_t* out_cnt,
+                           ccl::reduction op) {
+    LOG_DEBUG("FP16 batch reduction for ", in_cnt, " elements, ", offsets.size(), " buffers");
+
+    if (out_cnt != nullptr) {
+        *out_cnt = in_cnt;
+    }
+
+    auto impl_type = ccl::global_data::env().fp16_impl_type;
+    if (impl_type == ccl_fp16_no_compiler_support || impl_type == ccl_fp16_no_hardware_support) {
+        ccl_fp16_batch_reduce_scalar_impl(in_buf, offsets, in_cnt, inout_buf, op);
+    }
+    else {
+        ccl_fp16_batch_reduce_impl(in_buf, offsets, in_cnt, inout_buf, op);
+    }
+}
+
+void ccl_fp16_scale(void* buf, size_t count, float divisor) {
+    uint16_t fp16_values[CCL_FP16_CONVERT_COUNT];
+    float fp32_values[CCL_FP16_CONVERT_COUNT];
+
+    /* tail is processed through the same fixed-size conversion */
+    for (size_t offset = 0; offset < count; offset += CCL_FP16_CONVERT_COUNT) {
+        size_t chunk_count = std::min(count - offset, (size_t)CCL_FP16_CONVERT_COUNT);
+        uint16_t* chunk = (uint16_t*)buf + offset;
+
+        memset(fp16_values, 0, sizeof(fp16_values));
+        memcpy(fp16_values, chunk, chunk_count * sizeof(uint16_t));
+        ccl_convert_fp16_to_fp32(fp16_values, fp32_values);
+        for (size_t i = 0; i < CCL_FP16_CONVERT_COUNT; i++) {
+            fp32_values[i] /= divisor;
+        }
+        ccl_convert_fp32_to_fp16(fp32_values, fp16_values);
+        memcpy(chunk, fp16_values, chunk_count * sizeof(uint16_t));
+    }
+}
+
 void ccl_convert_fp32_to_fp16(const void* src, void* dst) {
     _mm_storeu_si128((__m128i*)dst, _mm256_cvtps_ph((__m256)_mm256_loadu_si256((__m256i*)src), 0));
 }
@@ -70,6 +212,23 @@ void ccl_fp16_reduce(const void* in_buf,
     CCL_FATAL("FP16 reduction was requested but CCL was compiled w/o FP16 support");
 }
 
+void ccl_fp16_batch_reduce(const void* in_buf,
+                           const std::vector<size_t>& offsets,
+                           size_t in_cnt,
+                           void* inout_buf,
+                           size_t* out_cnt,
+                           ccl::reduction op) {
+    if (out_cnt != nullptr) {
+        *out_cnt = in_cnt;
+    }
+
+    ccl_fp16_batch_reduce_scalar_impl(in_buf, offsets, in_cnt, inout_buf, op);
+}
+
+void ccl_fp16_scale(void* buf, size_t count, float divisor) {
+    CCL_FATAL("FP16 scaling was requested but CCL was compiled w/o FP16 support");
+}
+
 void ccl_convert_fp32_to_fp16(const void* src, void* dst) {
     CCL_FATAL("FP32->FP16 conversion was requested but CCL was compiled w/o FP16 support");
 }
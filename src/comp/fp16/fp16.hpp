@@ -15,6 +15,8 @@
 */
 #pragma once
 
+#include <vector>
+
 #include "oneapi/ccl/types.hpp"
 
 #ifdef CCL_FP16_TARGET_ATTRIBUTES
@@ -34,3 +36,17 @@ void ccl_fp16_reduce(const void* in_buf,
 void ccl_convert_fp32_to_fp16(const void* src, void* dst);
 void ccl_convert_fp16_to_fp32(const void* src, void* dst);
 #endif // CCL_FP16_TARGET_ATTRIBUTES
+
+/*
+   reduces inputs located at in_buf + offsets[1..n] into inout_buf in a single pass,
+   intermediate values are kept in fp32
+*/
+void ccl_fp16_batch_reduce(const void* in_buf,
+                           const std::vector<size_t>& offsets,
+                           size_t in_cnt,
+                           void* inout_buf,
+                           size_t* out_cnt,
+                           ccl::reduction reduction_op);
+
+/* divides values in place, intermediate values are kept in fp32 */
+void ccl_fp16_scale(void* buf, size_t count, float divisor);
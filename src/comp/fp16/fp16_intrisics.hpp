@@ -20,6 +20,7 @@
 #include <immintrin.h>
 #include <inttypes.h>
 #include <string.h>
+#include <vector>
 
 #include "common/global/global.hpp"
 #include "comp/fp16/fp16_utils.hpp"
@@ -147,6 +148,57 @@ FP16_INLINE_TARGET_ATTRIBUTE_AVX512F void ccl_fp16_reduce_tile_512(
     _mm256_mask_storeu_epi16(inout, (__mmask16)mask, res);
 }
 
+/* accumulates inout and all inputs in fp32 registers, stores fp16 once */
+FP16_INLINE_TARGET_ATTRIBUTE_F16C void ccl_fp16_batch_reduce_block_256(
+    const void* in_buf,
+    const std::vector<size_t>& offsets,
+    size_t idx,
+    uint8_t len,
+    void* inout_buf,
+    ccl_fp16_reduction_func_ptr_256 op) {
+    uint16_t tile[CCL_FP16_STEP_256] = { 0 };
+    const uint16_t* src = (uint16_t*)inout_buf + idx;
+    if (len < CCL_FP16_STEP_256) {
+        memcpy(tile, src, len * sizeof(uint16_t));
+        src = tile;
+    }
+    __m256 vfp32_acc = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)src));
+    for (size_t k = 1; k < offsets.size(); k++) {
+        src = (uint16_t*)in_buf + offsets[k] + idx;
+        if (len < CCL_FP16_STEP_256) {
+            memcpy(tile, src, len * sizeof(uint16_t));
+            src = tile;
+        }
+        __m256 vfp32_in = _mm256_cvtph_ps(_mm_loadu_si128((__m128i*)src));
+        vfp32_acc = fp16_reduce_256(vfp32_in, vfp32_acc, op);
+    }
+    if (len < CCL_FP16_STEP_256) {
+        _mm_storeu_si128((__m128i*)tile, _mm256_cvtps_ph(vfp32_acc, 0));
+        memcpy((uint16_t*)inout_buf + idx, tile, len * sizeof(uint16_t));
+    }
+    else {
+        _mm_storeu_si128((__m128i*)((uint16_t*)inout_buf + idx), _mm256_cvtps_ph(vfp32_acc, 0));
+    }
+}
+
+FP16_INLINE_TARGET_ATTRIBUTE_AVX512F void ccl_fp16_batch_reduce_block_512(
+    const void* in_buf,
+    const std::vector<size_t>& offsets,
+    size_t idx,
+    uint8_t len,
+    void* inout_buf,
+    ccl_fp16_reduction_func_ptr_512 op) {
+    uint16_t mask = ((uint16_t)0xFFFF) >> (CCL_FP16_STEP_512 - len);
+    __m512 vfp32_acc = _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, (uint16_t*)inout_buf + idx));
+    for (size_t k = 1; k < offsets.size(); k++) {
+        __m512 vfp32_in =
+            _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, (uint16_t*)in_buf + offsets[k] + idx));
+        vfp32_acc = fp16_reduce_512(vfp32_in, vfp32_acc, op);
+    }
+    _mm256_mask_storeu_epi16(
+        (uint16_t*)inout_buf + idx, (__mmask16)mask, _mm512_cvtps_ph(vfp32_acc, 0));
+}
+
 #ifdef CCL_FP16_AVX512FP16_COMPILER
 FP16_INLINE_TARGET_ATTRIBUTE_AVX512FP16 void ccl_fp16_reduce_inputs_512FP16(
     const void* a,
@@ -201,6 +253,27 @@ CCL_FP16_DEFINE_REDUCE_FUNC(512FP16);
 CCL_FP16_DEFINE_REDUCE_FUNC(512);
 CCL_FP16_DEFINE_REDUCE_FUNC(256);
 
+#define CCL_FP16_DEFINE_BATCH_REDUCE_FUNC(VLEN) \
+\
+    void inline ccl_fp16_batch_reduce_impl_##VLEN(const void* in_buf, \
+                                                  const std::vector<size_t>& offsets, \
+                                                  size_t in_cnt, \
+                                                  void* inout_buf, \
+                                                  ccl_fp16_reduction_func_ptr_##VLEN op) { \
+        size_t i = 0; \
+        for (i = 0; i + CCL_FP16_STEP_##VLEN <= in_cnt; i += CCL_FP16_STEP_##VLEN) { \
+            ccl_fp16_batch_reduce_block_##VLEN( \
+                in_buf, offsets, i, CCL_FP16_STEP_##VLEN, inout_buf, op); \
+        } \
+        if (i < in_cnt) { \
+            ccl_fp16_batch_reduce_block_##VLEN( \
+                in_buf, offsets, i, (uint8_t)(in_cnt - i), inout_buf, op); \
+        } \
+    }
+
+CCL_FP16_DEFINE_BATCH_REDUCE_FUNC(512);
+CCL_FP16_DEFINE_BATCH_REDUCE_FUNC(256);
+
 void inline ccl_fp16_reduce_impl(const void* in_buf,
                                  void* inout_buf,
                                  size_t in_cnt,
@@ -247,4 +320,40 @@ void inline ccl_fp16_reduce_impl(const void* in_buf,
 #endif // CCL_FP16_AVX512FP16_COMPILER
 }
 
+/* intermediate values are kept in fp32, so avx512fp16 uses avx512f kernels */
+void inline ccl_fp16_batch_reduce_impl(const void* in_buf,
+                                       const std::vector<size_t>& offsets,
+                                       size_t in_cnt,
+                                       void* inout_buf,
+                                       ccl::reduction op) {
+    ccl_fp16_reduction_func_ptr_256 func_256 = nullptr;
+    ccl_fp16_reduction_func_ptr_512 func_512 = nullptr;
+
+    auto impl_type = ccl::global_data::env().fp16_impl_type;
+
+    if (impl_type == ccl_fp16_f16c) {
+        switch (op) {
+            case ccl::reduction::sum: func_256 = &fp16_sum_wrap_256; break;
+            case ccl::reduction::prod: func_256 = &fp16_prod_wrap_256; break;
+            case ccl::reduction::min: func_256 = &fp16_min_wrap_256; break;
+            case ccl::reduction::max: func_256 = &fp16_max_wrap_256; break;
+            default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(op));
+        }
+        ccl_fp16_batch_reduce_impl_256(in_buf, offsets, in_cnt, inout_buf, func_256);
+    }
+    else if (impl_type == ccl_fp16_avx512f || impl_type == ccl_fp16_avx512fp16) {
+        switch (op) {
+            case ccl::reduction::sum: func_512 = &fp16_sum_wrap_512; break;
+            case ccl::reduction::prod: func_512 = &fp16_prod_wrap_512; break;
+            case ccl::reduction::min: func_512 = &fp16_min_wrap_512; break;
+            case ccl::reduction::max: func_512 = &fp16_max_wrap_512; break;
+            default: CCL_FATAL("unexpected value ", ccl::utils::enum_to_underlying(op));
+        }
+        ccl_fp16_batch_reduce_impl_512(in_buf, offsets, in_cnt, inout_buf, func_512);
+    }
+    else {
+        CCL_THROW("unexpected fp16_impl_type: ", impl_type);
+    }
+}
+
 #endif // CCL_FP16_COMPILER
@@ -0,0 +1,64 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include "common/log/log.hpp"
+#include "comp/reduce/reduce.hpp"
+#include "comp/reduce/reduce_intrisics.hpp"
+
+std::map<ccl_reduce_impl_type, std::string> reduce_impl_names = {
+    std::make_pair(ccl_reduce_scalar, "scalar"),
+    std::make_pair(ccl_reduce_avx2, "avx2"),
+    std::make_pair(ccl_reduce_avx512f, "avx512f")
+};
+
+#define CCL_REDUCE_SCALAR_ROW(type) \
+    { &ccl_reduce_scalar_kernel<type, ccl_reduce_sum_op>, \
+      &ccl_reduce_scalar_kernel<type, ccl_reduce_prod_op>, \
+      &ccl_reduce_scalar_kernel<type, ccl_reduce_min_op>, \
+      &ccl_reduce_scalar_kernel<type, ccl_reduce_max_op> }
+
+/* rows follow ccl::datatype order, float16 is served by comp/fp16 */
+static const ccl_reduce_kernel_t
+    ccl_reduce_kernels_scalar[CCL_REDUCE_KERNEL_DTYPE_COUNT][CCL_REDUCE_KERNEL_OP_COUNT] = {
+        CCL_REDUCE_SCALAR_ROW(int8_t),   CCL_REDUCE_SCALAR_ROW(uint8_t),
+        CCL_REDUCE_SCALAR_ROW(int16_t),  CCL_REDUCE_SCALAR_ROW(uint16_t),
+        CCL_REDUCE_SCALAR_ROW(int32_t),  CCL_REDUCE_SCALAR_ROW(uint32_t),
+        CCL_REDUCE_SCALAR_ROW(int64_t),  CCL_REDUCE_SCALAR_ROW(uint64_t),
+        { nullptr, nullptr, nullptr, nullptr }, CCL_REDUCE_SCALAR_ROW(float),
+        CCL_REDUCE_SCALAR_ROW(double)
+    };
+
+ccl_reduce_kernel_t ccl_reduce_get_kernel(ccl_reduce_impl_type impl_type,
+                                          ccl::datatype dtype,
+                                          ccl::reduction reduction) {
+    int dtype_idx = static_cast<int>(dtype);
+    int op_idx = static_cast<int>(reduction);
+
+    if (dtype_idx < 0 || dtype_idx >= CCL_REDUCE_KERNEL_DTYPE_COUNT || op_idx < 0 ||
+        op_idx >= CCL_REDUCE_KERNEL_OP_COUNT) {
+        return nullptr;
+    }
+
+    switch (impl_type) {
+        case ccl_reduce_scalar: return ccl_reduce_kernels_scalar[dtype_idx][op_idx];
+#ifdef CCL_REDUCE_AVX_COMPILER
+        case ccl_reduce_avx2: return ccl_reduce_kernels_avx2[dtype_idx][op_idx];
+        case ccl_reduce_avx512f: return ccl_reduce_kernels_avx512f[dtype_idx][op_idx];
+#endif // CCL_REDUCE_AVX_COMPILER
+        default: CCL_THROW("unexpected reduce_impl_type: ", impl_type);
+    }
+
+    return nullptr;
+}
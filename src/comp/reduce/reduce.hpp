@@ -0,0 +1,72 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <algorithm>
+
+#include "comp/reduce/reduce_utils.hpp"
+#include "oneapi/ccl/types.hpp"
+
+/* element-wise inout[i] = op(in[i], inout[i]) for a fixed (dtype, reduction) pair */
+typedef void (*ccl_reduce_kernel_t)(const void* in_buf, void* inout_buf, size_t count);
+
+/* dtypes covered by the kernel table: int8..uint64, float32 and float64 */
+#define CCL_REDUCE_KERNEL_DTYPE_COUNT (static_cast<int>(ccl::datatype::float64) + 1)
+/* reductions covered by the kernel table: sum, prod, min, max */
+#define CCL_REDUCE_KERNEL_OP_COUNT (static_cast<int>(ccl::reduction::max) + 1)
+
+template <class T>
+struct ccl_reduce_sum_op {
+    static inline T apply(T a, T b) {
+        return a + b;
+    }
+};
+
+template <class T>
+struct ccl_reduce_prod_op {
+    static inline T apply(T a, T b) {
+        return a * b;
+    }
+};
+
+template <class T>
+struct ccl_reduce_min_op {
+    static inline T apply(T a, T b) {
+        return std::min(a, b);
+    }
+};
+
+template <class T>
+struct ccl_reduce_max_op {
+    static inline T apply(T a, T b) {
+        return std::max(a, b);
+    }
+};
+
+/* also used by vector kernels to process tails */
+template <class T, template <class> class op_type>
+inline void ccl_reduce_scalar_kernel(const void* in_buf, void* inout_buf, size_t count) {
+    const T* in = static_cast<const T*>(in_buf);
+    T* inout = static_cast<T*>(inout_buf);
+    for (size_t i = 0; i < count; i++) {
+        inout[i] = op_type<T>::apply(in[i], inout[i]);
+    }
+}
+
+/* returns nullptr if (dtype, reduction) pair is not served by the kernel table */
+ccl_reduce_kernel_t ccl_reduce_get_kernel(ccl_reduce_impl_type impl_type,
+                                          ccl::datatype dtype,
+                                          ccl::reduction reduction);
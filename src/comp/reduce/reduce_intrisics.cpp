@@ -0,0 +1,274 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include "comp/reduce/reduce_intrisics.hpp"
+
+#ifdef CCL_REDUCE_AVX_COMPILER
+
+#include <immintrin.h>
+#include <inttypes.h>
+
+/* unaligned load/store wrappers with uniform signatures for the kernel macro below */
+#define CCL_REDUCE_DEFINE_LOAD_STORE(isa, vec_type, suffix, load_intrin, store_intrin, ptr_type) \
+    REDUCE_TARGET_ATTRIBUTE_##isa static inline vec_type ccl_reduce_load_##suffix##_##isa( \
+        const void* ptr) { \
+        return load_intrin((const ptr_type*)ptr); \
+    } \
+    REDUCE_TARGET_ATTRIBUTE_##isa static inline void ccl_reduce_store_##suffix##_##isa(void* ptr, \
+                                                                               vec_type v) { \
+        store_intrin((ptr_type*)ptr, v); \
+    }
+
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX2, __m256i, si, _mm256_loadu_si256, _mm256_storeu_si256, __m256i);
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX2, __m256, ps, _mm256_loadu_ps, _mm256_storeu_ps, float);
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX2, __m256d, pd, _mm256_loadu_pd, _mm256_storeu_pd, double);
+
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX512F, __m512i, si, _mm512_loadu_si512, _mm512_storeu_si512, void);
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX512F, __m512, ps, _mm512_loadu_ps, _mm512_storeu_ps, float);
+CCL_REDUCE_DEFINE_LOAD_STORE(AVX512F, __m512d, pd, _mm512_loadu_pd, _mm512_storeu_pd, double);
+
+/* AVX2 has no 64-bit integer min/max, emulate them through compare and blend */
+REDUCE_TARGET_ATTRIBUTE_AVX2 static inline __m256i ccl_avx2_min_epi64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+REDUCE_TARGET_ATTRIBUTE_AVX2 static inline __m256i ccl_avx2_max_epi64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+
+REDUCE_TARGET_ATTRIBUTE_AVX2 static inline __m256i ccl_avx2_min_epu64(__m256i a, __m256i b) {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    __m256i a_gt_b = _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+    return _mm256_blendv_epi8(a, b, a_gt_b);
+}
+
+REDUCE_TARGET_ATTRIBUTE_AVX2 static inline __m256i ccl_avx2_max_epu64(__m256i a, __m256i b) {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    __m256i b_gt_a = _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+    return _mm256_blendv_epi8(a, b, b_gt_a);
+}
+
+/*
+ * main loop works on full vectors, the tail is processed by the scalar kernel,
+ * vec_op is called as vec_op(inout, in): x86 min/max return the second operand on NaN or
+ * equal inputs (+0/-0), which matches std::min(in, inout)/std::max(in, inout) of the scalar path
+ */
+#define CCL_REDUCE_DEFINE_VEC_KERNEL(isa, vec_type, vec_suffix, type, op, vec_op) \
+    REDUCE_TARGET_ATTRIBUTE_##isa static void ccl_reduce_##type##_##op##_##isa( \
+        const void* in_buf, void* inout_buf, size_t count) { \
+        const type* in = static_cast<const type*>(in_buf); \
+        type* inout = static_cast<type*>(inout_buf); \
+        const size_t step = sizeof(vec_type) / sizeof(type); \
+        size_t i = 0; \
+        for (; i + step <= count; i += step) { \
+            vec_type a = ccl_reduce_load_##vec_suffix##_##isa(in + i); \
+            vec_type b = ccl_reduce_load_##vec_suffix##_##isa(inout + i); \
+            ccl_reduce_store_##vec_suffix##_##isa(inout + i, vec_op(b, a)); \
+        } \
+        ccl_reduce_scalar_kernel<type, ccl_reduce_##op##_op>(in + i, inout + i, count - i); \
+    }
+
+#define CCL_REDUCE_KERNEL(isa, type, op)   &ccl_reduce_##type##_##op##_##isa
+#define CCL_REDUCE_SCALAR_KERNEL(type, op) &ccl_reduce_scalar_kernel<type, ccl_reduce_##op##_op>
+
+/* AVX2 */
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int8_t, sum, _mm256_add_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int8_t, min, _mm256_min_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int8_t, max, _mm256_max_epi8);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint8_t, sum, _mm256_add_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint8_t, min, _mm256_min_epu8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint8_t, max, _mm256_max_epu8);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int16_t, sum, _mm256_add_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int16_t, prod, _mm256_mullo_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int16_t, min, _mm256_min_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int16_t, max, _mm256_max_epi16);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint16_t, sum, _mm256_add_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint16_t, prod, _mm256_mullo_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint16_t, min, _mm256_min_epu16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint16_t, max, _mm256_max_epu16);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int32_t, sum, _mm256_add_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int32_t, prod, _mm256_mullo_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int32_t, min, _mm256_min_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int32_t, max, _mm256_max_epi32);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint32_t, sum, _mm256_add_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint32_t, prod, _mm256_mullo_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint32_t, min, _mm256_min_epu32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint32_t, max, _mm256_max_epu32);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int64_t, sum, _mm256_add_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int64_t, min, ccl_avx2_min_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, int64_t, max, ccl_avx2_max_epi64);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint64_t, sum, _mm256_add_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint64_t, min, ccl_avx2_min_epu64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256i, si, uint64_t, max, ccl_avx2_max_epu64);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256, ps, float, sum, _mm256_add_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256, ps, float, prod, _mm256_mul_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256, ps, float, min, _mm256_min_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256, ps, float, max, _mm256_max_ps);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256d, pd, double, sum, _mm256_add_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256d, pd, double, prod, _mm256_mul_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256d, pd, double, min, _mm256_min_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX2, __m256d, pd, double, max, _mm256_max_pd);
+
+/* there is no 8-bit or 64-bit vector multiplication in AVX2, these fall back to scalar */
+const ccl_reduce_kernel_t
+    ccl_reduce_kernels_avx2[CCL_REDUCE_KERNEL_DTYPE_COUNT][CCL_REDUCE_KERNEL_OP_COUNT] = {
+        { CCL_REDUCE_KERNEL(AVX2, int8_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(int8_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, int8_t, min),
+          CCL_REDUCE_KERNEL(AVX2, int8_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, uint8_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(uint8_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, uint8_t, min),
+          CCL_REDUCE_KERNEL(AVX2, uint8_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, int16_t, sum),
+          CCL_REDUCE_KERNEL(AVX2, int16_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, int16_t, min),
+          CCL_REDUCE_KERNEL(AVX2, int16_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, uint16_t, sum),
+          CCL_REDUCE_KERNEL(AVX2, uint16_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, uint16_t, min),
+          CCL_REDUCE_KERNEL(AVX2, uint16_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, int32_t, sum),
+          CCL_REDUCE_KERNEL(AVX2, int32_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, int32_t, min),
+          CCL_REDUCE_KERNEL(AVX2, int32_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, uint32_t, sum),
+          CCL_REDUCE_KERNEL(AVX2, uint32_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, uint32_t, min),
+          CCL_REDUCE_KERNEL(AVX2, uint32_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, int64_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(int64_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, int64_t, min),
+          CCL_REDUCE_KERNEL(AVX2, int64_t, max) },
+        { CCL_REDUCE_KERNEL(AVX2, uint64_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(uint64_t, prod),
+          CCL_REDUCE_KERNEL(AVX2, uint64_t, min),
+          CCL_REDUCE_KERNEL(AVX2, uint64_t, max) },
+        { nullptr, nullptr, nullptr, nullptr },
+        { CCL_REDUCE_KERNEL(AVX2, float, sum),
+          CCL_REDUCE_KERNEL(AVX2, float, prod),
+          CCL_REDUCE_KERNEL(AVX2, float, min),
+          CCL_REDUCE_KERNEL(AVX2, float, max) },
+        { CCL_REDUCE_KERNEL(AVX2, double, sum),
+          CCL_REDUCE_KERNEL(AVX2, double, prod),
+          CCL_REDUCE_KERNEL(AVX2, double, min),
+          CCL_REDUCE_KERNEL(AVX2, double, max) }
+    };
+
+/* AVX512 */
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int8_t, sum, _mm512_add_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int8_t, min, _mm512_min_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int8_t, max, _mm512_max_epi8);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint8_t, sum, _mm512_add_epi8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint8_t, min, _mm512_min_epu8);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint8_t, max, _mm512_max_epu8);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int16_t, sum, _mm512_add_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int16_t, prod, _mm512_mullo_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int16_t, min, _mm512_min_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int16_t, max, _mm512_max_epi16);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint16_t, sum, _mm512_add_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint16_t, prod, _mm512_mullo_epi16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint16_t, min, _mm512_min_epu16);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint16_t, max, _mm512_max_epu16);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int32_t, sum, _mm512_add_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int32_t, prod, _mm512_mullo_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int32_t, min, _mm512_min_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int32_t, max, _mm512_max_epi32);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint32_t, sum, _mm512_add_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint32_t, prod, _mm512_mullo_epi32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint32_t, min, _mm512_min_epu32);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint32_t, max, _mm512_max_epu32);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int64_t, sum, _mm512_add_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int64_t, min, _mm512_min_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, int64_t, max, _mm512_max_epi64);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint64_t, sum, _mm512_add_epi64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint64_t, min, _mm512_min_epu64);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512i, si, uint64_t, max, _mm512_max_epu64);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512, ps, float, sum, _mm512_add_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512, ps, float, prod, _mm512_mul_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512, ps, float, min, _mm512_min_ps);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512, ps, float, max, _mm512_max_ps);
+
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512d, pd, double, sum, _mm512_add_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512d, pd, double, prod, _mm512_mul_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512d, pd, double, min, _mm512_min_pd);
+CCL_REDUCE_DEFINE_VEC_KERNEL(AVX512F, __m512d, pd, double, max, _mm512_max_pd);
+
+/* 8-bit multiplication is absent and 64-bit one requires AVX512DQ, use scalar for them */
+const ccl_reduce_kernel_t
+    ccl_reduce_kernels_avx512f[CCL_REDUCE_KERNEL_DTYPE_COUNT][CCL_REDUCE_KERNEL_OP_COUNT] = {
+        { CCL_REDUCE_KERNEL(AVX512F, int8_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(int8_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, int8_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, int8_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, uint8_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(uint8_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, uint8_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, uint8_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, int16_t, sum),
+          CCL_REDUCE_KERNEL(AVX512F, int16_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, int16_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, int16_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, uint16_t, sum),
+          CCL_REDUCE_KERNEL(AVX512F, uint16_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, uint16_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, uint16_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, int32_t, sum),
+          CCL_REDUCE_KERNEL(AVX512F, int32_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, int32_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, int32_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, uint32_t, sum),
+          CCL_REDUCE_KERNEL(AVX512F, uint32_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, uint32_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, uint32_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, int64_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(int64_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, int64_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, int64_t, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, uint64_t, sum),
+          CCL_REDUCE_SCALAR_KERNEL(uint64_t, prod),
+          CCL_REDUCE_KERNEL(AVX512F, uint64_t, min),
+          CCL_REDUCE_KERNEL(AVX512F, uint64_t, max) },
+        { nullptr, nullptr, nullptr, nullptr },
+        { CCL_REDUCE_KERNEL(AVX512F, float, sum),
+          CCL_REDUCE_KERNEL(AVX512F, float, prod),
+          CCL_REDUCE_KERNEL(AVX512F, float, min),
+          CCL_REDUCE_KERNEL(AVX512F, float, max) },
+        { CCL_REDUCE_KERNEL(AVX512F, double, sum),
+          CCL_REDUCE_KERNEL(AVX512F, double, prod),
+          CCL_REDUCE_KERNEL(AVX512F, double, min),
+          CCL_REDUCE_KERNEL(AVX512F, double, max) }
+    };
+
+#endif // CCL_REDUCE_AVX_COMPILER
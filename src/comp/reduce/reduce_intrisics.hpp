@@ -0,0 +1,32 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include "comp/reduce/reduce.hpp"
+
+#ifdef CCL_REDUCE_AVX_COMPILER
+
+#define REDUCE_TARGET_ATTRIBUTE_AVX2    __attribute__((target("avx2")))
+#define REDUCE_TARGET_ATTRIBUTE_AVX512F __attribute__((target("avx512f,avx512bw")))
+
+#define CCL_REDUCE_DECLARE_ISA_KERNELS(isa) \
+    extern const ccl_reduce_kernel_t \
+        ccl_reduce_kernels_##isa[CCL_REDUCE_KERNEL_DTYPE_COUNT][CCL_REDUCE_KERNEL_OP_COUNT];
+
+CCL_REDUCE_DECLARE_ISA_KERNELS(avx2);
+CCL_REDUCE_DECLARE_ISA_KERNELS(avx512f);
+
+#endif // CCL_REDUCE_AVX_COMPILER
@@ -0,0 +1,77 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+
+/* AVX2/AVX512 kernels are built through target attributes, no global -m flags are required */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CCL_REDUCE_AVX_COMPILER
+#endif
+
+typedef enum { ccl_reduce_scalar = 0, ccl_reduce_avx2, ccl_reduce_avx512f } ccl_reduce_impl_type;
+
+extern std::map<ccl_reduce_impl_type, std::string> reduce_impl_names;
+
+__attribute__((__always_inline__)) inline std::set<ccl_reduce_impl_type>
+ccl_reduce_get_impl_types() {
+    std::set<ccl_reduce_impl_type> result;
+
+    result.insert(ccl_reduce_scalar);
+
+#ifdef CCL_REDUCE_AVX_COMPILER
+    int is_avx2_enabled = 0;
+    int is_avx512f_enabled = 0;
+
+    uint32_t reg[4];
+
+    /* OS support for YMM/ZMM state */
+    /* CPUID.(EAX=01H):ECX.OSXSAVE [bit 27] */
+    /* CPUID.(EAX=01H):ECX.AVX     [bit 28] */
+    __asm__ __volatile__("cpuid" : "=a"(reg[0]), "=b"(reg[1]), "=c"(reg[2]), "=d"(reg[3]) : "a"(1));
+    if (!((reg[2] & (1u << 27)) && (reg[2] & (1u << 28))))
+        return result;
+
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    /* XCR0: SSE [bit 1], AVX [bit 2] */
+    int is_ymm_enabled = ((xcr0_lo & 0x6) == 0x6);
+    /* XCR0: opmask [bit 5], ZMM_Hi256 [bit 6], Hi16_ZMM [bit 7] */
+    int is_zmm_enabled = is_ymm_enabled && ((xcr0_lo & 0xE0) == 0xE0);
+
+    /* CPUID.(EAX=07H, ECX=0):EBX.AVX2     [bit 05] */
+    /* CPUID.(EAX=07H, ECX=0):EBX.AVX512F  [bit 16] */
+    /* CPUID.(EAX=07H, ECX=0):EBX.AVX512BW [bit 30] */
+    __asm__ __volatile__("cpuid"
+                         : "=a"(reg[0]), "=b"(reg[1]), "=c"(reg[2]), "=d"(reg[3])
+                         : "a"(7), "c"(0));
+    is_avx2_enabled = is_ymm_enabled && ((reg[1] & (1u << 5)) >> 5);
+    /* AVX512BW is required for int8/int16 kernels */
+    is_avx512f_enabled = is_zmm_enabled && ((reg[1] & (1u << 16)) >> 16) &
+                         ((reg[1] & (1u << 30)) >> 30);
+
+    if (is_avx2_enabled)
+        result.insert(ccl_reduce_avx2);
+
+    if (is_avx512f_enabled)
+        result.insert(ccl_reduce_avx512f);
+#endif // CCL_REDUCE_AVX_COMPILER
+
+    return result;
+}
@@ -13,7 +13,9 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include <algorithm>
 #include <numeric>
+#include <unistd.h>
 
 #include "exec/exec.hpp"
 #include "exec/thread/service_worker.hpp"
@@ -146,9 +148,71 @@ void ccl_executor::start_workers(atl_proc_coord_t& coord) {
                       mem_affinity);
         }
     }
+
+    if (env.reduce_thread_count) {
+        start_reduce_thread_pool();
+    }
+
     workers_started = true;
 }
 
+void ccl_executor::start_reduce_thread_pool() {
+    auto& env = ccl::global_data::env();
+    auto& global_data = ccl::global_data::get();
+
+    size_t thread_count = env.reduce_thread_count;
+    int local_proc_idx = global_data.get_local_proc_idx();
+    int worker_cpu = env.worker_affinity[local_proc_idx * env.worker_count];
+    int numa_node = global_data.hwloc_wrapper->get_numa_node_by_cpu(worker_cpu);
+
+    /* prefer cores of the worker's NUMA node, otherwise all online cores */
+    std::vector<int> node_cpus;
+    if (numa_node != CCL_UNDEFINED_NUMA_NODE) {
+        node_cpus = global_data.hwloc_wrapper->get_numa_node(numa_node).cpus;
+    }
+    if (node_cpus.empty()) {
+        long system_core_count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < system_core_count; cpu++) {
+            node_cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    /* skip cores of all local workers, take the last cores first as auto worker pinning does */
+    std::vector<int> free_cpus;
+    for (auto it = node_cpus.rbegin(); it != node_cpus.rend(); ++it) {
+        if (std::find(env.worker_affinity.begin(), env.worker_affinity.end(), *it) ==
+            env.worker_affinity.end()) {
+            free_cpus.push_back(*it);
+        }
+    }
+
+    if (free_cpus.empty()) {
+        LOG_WARN("no free cores for reduce helper threads, ",
+                 CCL_REDUCE_THREAD_COUNT,
+                 " is ignored");
+        return;
+    }
+
+    if (free_cpus.size() < thread_count * global_data.get_local_proc_count()) {
+        LOG_WARN("the number of reduce helper threads (",
+                 thread_count,
+                 " per process) exceeds the number of free cores (",
+                 free_cpus.size(),
+                 "), helper threads will share cores");
+    }
+
+    std::vector<int> cpu_affinity(thread_count), mem_affinity(thread_count);
+    for (size_t idx = 0; idx < thread_count; idx++) {
+        cpu_affinity[idx] = free_cpus[(local_proc_idx * thread_count + idx) % free_cpus.size()];
+        mem_affinity[idx] = global_data.hwloc_wrapper->get_numa_node_by_cpu(cpu_affinity[idx]);
+    }
+
+    reduce_thread_pool.reset(new ccl_reduce_thread_pool(thread_count));
+    reduce_thread_pool->start(cpu_affinity, mem_affinity);
+
+    LOG_DEBUG("started ", thread_count, " reduce helper threads, local_proc_idx ", local_proc_idx);
+}
+
 ccl_executor::~ccl_executor() {
     // TODO: Rework to support listener
     //    if (listener) {
@@ -175,6 +239,8 @@ ccl_executor::~ccl_executor() {
 
         workers[idx].reset();
     }
+
+    reduce_thread_pool.reset();
 }
 
 void ccl_executor::lock_workers() {
@@ -21,6 +21,7 @@
 #include "common/log/log.hpp"
 #include "common/request/request.hpp"
 #include "exec/thread/listener.hpp"
+#include "exec/thread/reduce_thread_pool.hpp"
 #include "sched/sched.hpp"
 #include "internal_types.hpp"
 
@@ -86,6 +87,9 @@ public:
         return workers_started;
     };
     size_t get_worker_count() const;
+    ccl_reduce_thread_pool* get_reduce_thread_pool() {
+        return reduce_thread_pool.get();
+    }
     void update_wait_condition(size_t idx,
                                ccl_base_thread::wait_data::update_type type,
                                size_t delta);
@@ -105,8 +109,10 @@ private:
     size_t get_worker_idx_by_sched_id(ccl_sched* sched);
 
     std::unique_ptr<ccl_sched_queue> create_sched_queue(size_t idx, size_t ep_per_worker);
+    void start_reduce_thread_pool();
 
     std::vector<std::unique_ptr<ccl_worker>> workers;
+    std::unique_ptr<ccl_reduce_thread_pool> reduce_thread_pool;
     // TODO: Rework to support listener
     //  std::unique_ptr<ccl_listener> listener;
 
@@ -0,0 +1,201 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include "common/global/global.hpp"
+#include "common/utils/yield.hpp"
+#include "exec/thread/reduce_thread_pool.hpp"
+
+static void* ccl_reduce_helper_func(void* args) {
+    auto thread = static_cast<ccl_reduce_helper_thread*>(args);
+
+    LOG_DEBUG("reduce helper: ",
+              "idx: ",
+              thread->get_idx(),
+              ", cpu: ",
+              thread->get_start_cpu_affinity(),
+              ", numa: ",
+              thread->get_start_mem_affinity());
+
+    ccl::global_data::get().hwloc_wrapper->membind_thread(thread->get_start_mem_affinity());
+
+    thread->started = true;
+
+    while (true) {
+        const ccl_reduce_slice_fn_t* fn = nullptr;
+        size_t offset = 0, count = 0;
+        ccl_reduce_run_state* state = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(thread->wait.mtx);
+            thread->wait.var.wait(lock, [thread] {
+                return thread->should_stop.load(std::memory_order_relaxed) || thread->fn;
+            });
+
+            if (thread->should_stop.load(std::memory_order_relaxed))
+                break;
+
+            fn = thread->fn;
+            offset = thread->offset;
+            count = thread->count;
+            state = thread->state;
+            thread->fn = nullptr;
+        }
+
+        try {
+            (*fn)(offset, count);
+        }
+        catch (...) {
+            LOG_DEBUG("reduce helper ", thread->get_idx(), " caught exception");
+            std::lock_guard<std::mutex> lock(state->error_mtx);
+            if (!state->error)
+                state->error = std::current_exception();
+        }
+
+        state->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    thread->started = false;
+
+    return nullptr;
+}
+
+ccl_reduce_helper_thread::ccl_reduce_helper_thread(size_t idx)
+        : ccl_base_thread(idx, ccl_reduce_helper_func),
+          fn(nullptr),
+          offset(0),
+          count(0),
+          state(nullptr) {}
+
+void ccl_reduce_helper_thread::post(const ccl_reduce_slice_fn_t* slice_fn,
+                                    size_t slice_offset,
+                                    size_t slice_count,
+                                    ccl_reduce_run_state* slice_state) {
+    std::unique_lock<std::mutex> lock(wait.mtx);
+    CCL_THROW_IF_NOT(!fn, "reduce helper ", get_idx(), " already has a task");
+    fn = slice_fn;
+    offset = slice_offset;
+    count = slice_count;
+    state = slice_state;
+    wait.var.notify_one();
+}
+
+void ccl_reduce_helper_thread::notify_stop() {
+    std::unique_lock<std::mutex> lock(wait.mtx);
+    should_stop = true;
+    wait.var.notify_one();
+}
+
+ccl_reduce_thread_pool::ccl_reduce_thread_pool(size_t thread_count) : started(false) {
+    for (size_t idx = 0; idx < thread_count; idx++) {
+        threads.emplace_back(new ccl_reduce_helper_thread(idx));
+    }
+}
+
+ccl_reduce_thread_pool::~ccl_reduce_thread_pool() {
+    stop();
+}
+
+void ccl_reduce_thread_pool::start(const std::vector<int>& cpu_affinity,
+                                   const std::vector<int>& mem_affinity) {
+    CCL_THROW_IF_NOT(cpu_affinity.size() == threads.size() &&
+                         mem_affinity.size() == threads.size(),
+                     "unexpected reduce helper affinity length, cpu ",
+                     cpu_affinity.size(),
+                     ", mem ",
+                     mem_affinity.size(),
+                     ", should be ",
+                     threads.size());
+
+    for (size_t idx = 0; idx < threads.size(); idx++) {
+        CCL_THROW_IF_NOT(
+            threads[idx]->start(cpu_affinity[idx], mem_affinity[idx]) == ccl::status::success,
+            "failed to start reduce helper # ",
+            idx);
+        LOG_DEBUG("started reduce helper # ",
+                  idx,
+                  ", cpu: ",
+                  cpu_affinity[idx],
+                  ", numa: ",
+                  mem_affinity[idx]);
+    }
+
+    started = true;
+}
+
+void ccl_reduce_thread_pool::stop() {
+    if (!started)
+        return;
+
+    std::lock_guard<std::mutex> lock(run_guard);
+
+    for (size_t idx = 0; idx < threads.size(); idx++) {
+        threads[idx]->notify_stop();
+        if (threads[idx]->stop() != ccl::status::success) {
+            LOG_ERROR("failed to stop reduce helper # ", idx);
+        }
+    }
+
+    started = false;
+}
+
+bool ccl_reduce_thread_pool::try_run(size_t count,
+                                     size_t dtype_size,
+                                     const ccl_reduce_slice_fn_t& fn) {
+    if (!started || threads.empty() || !count)
+        return false;
+
+    /* another worker uses the helpers, don't wait for them */
+    std::unique_lock<std::mutex> lock(run_guard, std::try_to_lock);
+    if (!lock.owns_lock())
+        return false;
+
+    /* slice boundaries are kept on cache line boundaries of the buffers */
+    size_t align_count = (CACHELINE_SIZE % dtype_size) ? 1 : (CACHELINE_SIZE / dtype_size);
+    size_t slice_count = (count + threads.size()) / (threads.size() + 1);
+    slice_count = (slice_count + align_count - 1) / align_count * align_count;
+
+    size_t first_count = std::min(slice_count, count);
+    size_t helper_count = (count - first_count + slice_count - 1) / slice_count;
+
+    ccl_reduce_run_state state;
+    state.pending = helper_count;
+
+    for (size_t idx = 0; idx < helper_count; idx++) {
+        size_t offset = (idx + 1) * slice_count;
+        threads[idx]->post(&fn, offset, std::min(slice_count, count - offset), &state);
+    }
+
+    auto wait_helpers = [&state]() {
+        while (state.pending.load(std::memory_order_acquire)) {
+            ccl_yield(ccl::global_data::env().yield_type);
+        }
+    };
+
+    /* helpers reference fn and state, so they have to complete before leaving the scope */
+    try {
+        fn(0, first_count);
+    }
+    catch (...) {
+        wait_helpers();
+        throw;
+    }
+
+    wait_helpers();
+
+    if (state.error)
+        std::rethrow_exception(state.error);
+
+    return true;
+}
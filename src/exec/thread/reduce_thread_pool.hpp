@@ -0,0 +1,93 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "exec/thread/base_thread.hpp"
+
+/* processes elements [offset, offset + count) of the reduction */
+typedef std::function<void(size_t offset, size_t count)> ccl_reduce_slice_fn_t;
+
+/* shared by the slices of a single reduction */
+struct ccl_reduce_run_state {
+    std::atomic<size_t> pending;
+    /* first exception thrown by a helper, rethrown on the calling thread */
+    std::mutex error_mtx;
+    std::exception_ptr error;
+};
+
+class ccl_reduce_helper_thread : public ccl_base_thread {
+public:
+    ccl_reduce_helper_thread(size_t idx);
+
+    const std::string& name() const override {
+        static const std::string name("reduce_helper");
+        return name;
+    };
+
+    void post(const ccl_reduce_slice_fn_t* fn,
+              size_t offset,
+              size_t count,
+              ccl_reduce_run_state* state);
+    void notify_stop();
+
+    /* task slot, protected by wait.mtx */
+    const ccl_reduce_slice_fn_t* fn;
+    size_t offset;
+    size_t count;
+    ccl_reduce_run_state* state;
+};
+
+/*
+   helper threads which split large host reductions issued by workers
+   into cache line aligned slices, the calling worker processes the first slice
+*/
+class ccl_reduce_thread_pool {
+public:
+    ccl_reduce_thread_pool(size_t thread_count);
+    ~ccl_reduce_thread_pool();
+
+    ccl_reduce_thread_pool(const ccl_reduce_thread_pool&) = delete;
+    ccl_reduce_thread_pool& operator=(const ccl_reduce_thread_pool&) = delete;
+
+    void start(const std::vector<int>& cpu_affinity, const std::vector<int>& mem_affinity);
+    void stop();
+
+    bool is_started() const {
+        return started;
+    }
+
+    size_t get_thread_count() const {
+        return threads.size();
+    }
+
+    /*
+       returns false if the pool is not started or is busy with a reduction of another worker,
+       in this case the caller should run the reduction on its own,
+       an exception thrown by any slice is rethrown after all slices complete
+    */
+    bool try_run(size_t count, size_t dtype_size, const ccl_reduce_slice_fn_t& fn);
+
+private:
+    std::vector<std::unique_ptr<ccl_reduce_helper_thread>> threads;
+    std::mutex run_guard;
+    bool started;
+};
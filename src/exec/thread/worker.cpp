@@ -13,6 +13,12 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include <algorithm>
+#include <chrono>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "common/global/global.hpp"
 #include "common/log/log.hpp"
 #include "exec/exec.hpp"
@@ -25,6 +31,27 @@
 #define CCL_WORKER_CHECK_AFFINITY_ITERS (16384)
 #define CCL_WORKER_PROCESS_ALL_ITERS    (4096)
 
+/*
+   spin time calibration for hybrid wait: blocking costs a few syscalls plus sleep and wake-up
+   of the thread, spinning for about the same time keeps both extra latency and CPU time within 2x
+*/
+#define CCL_WORKER_CALIBRATION_ITERS  (16)
+#define CCL_WORKER_WAKEUP_COST_FACTOR (20)
+#define CCL_WORKER_MIN_SPIN_TIME_NS   (10 * 1000)
+#define CCL_WORKER_MAX_SPIN_TIME_NS   (1000 * 1000)
+
+static uint64_t ccl_worker_wall_time_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static uint64_t ccl_worker_cpu_time_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
 static void* ccl_worker_func(void* args);
 
 ccl_worker::ccl_worker(size_t idx, std::unique_ptr<ccl_sched_queue> queue)
@@ -33,7 +60,24 @@ ccl_worker::ccl_worker(size_t idx, std::unique_ptr<ccl_sched_queue> queue)
           is_locked(false),
           process_atl(true),
           strict_sched_queue(std::unique_ptr<ccl_strict_sched_queue>(new ccl_strict_sched_queue())),
-          sched_queue(std::move(queue)) {}
+          sched_queue(std::move(queue)) {
+    if (ccl::global_data::env().worker_hybrid_wait) {
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd < 0) {
+            LOG_WARN("worker ", idx, " can't create eventfd, errno ", errno);
+        }
+    }
+}
+
+ccl_worker::~ccl_worker() {
+    strict_sched_queue.reset();
+    sched_queue.reset();
+
+    if (event_fd >= 0) {
+        close(event_fd);
+        event_fd = -1;
+    }
+}
 
 void ccl_worker::add(ccl_sched* sched) {
     LOG_DEBUG("add sched ",
@@ -57,6 +101,11 @@ void ccl_worker::add(ccl_sched* sched) {
     else {
         sched_queue->add(sched);
     }
+
+    add_counter.fetch_add(1, std::memory_order_seq_cst);
+    if (is_blocked.load(std::memory_order_seq_cst)) {
+        signal_event();
+    }
 }
 
 ccl::status ccl_worker::do_work(size_t& processed_count) {
@@ -203,7 +252,11 @@ ccl::status ccl_worker::process_sched_bin(ccl_sched_bin* bin, size_t& completed_
         ccl_sched* sched = bin->get(sched_idx);
         CCL_ASSERT(sched && bin == sched->bin);
 
+        size_t prev_start_idx = sched->start_idx;
         sched->do_progress();
+        if (sched->start_idx != prev_start_idx) {
+            made_progress = true;
+        }
 
         if (sched->start_idx == sched->entries.size()) {
             // the last entry in the schedule has been completed, clean up the schedule and complete its request
@@ -234,6 +287,189 @@ ccl::status ccl_worker::process_sched_bin(ccl_sched_bin* bin, size_t& completed_
     return ccl::status::success;
 }
 
+void ccl_worker::start_hybrid_wait() {
+    wait_stats = {};
+    wait_stats.start_wall_ns = ccl_worker_wall_time_ns();
+    wait_stats.start_cpu_ns = ccl_worker_cpu_time_ns();
+
+    ssize_t spin_time = ccl::global_data::env().worker_spin_time;
+    if (spin_time != CCL_ENV_SIZET_NOT_SPECIFIED) {
+        spin_time_ns = static_cast<uint64_t>(spin_time) * 1000;
+    }
+    else if (event_fd < 0) {
+        spin_time_ns = CCL_WORKER_MIN_SPIN_TIME_NS;
+    }
+    else {
+        /* measure signal and poll round trip on own eventfd */
+        std::vector<uint64_t> samples;
+        for (size_t iter = 0; iter < CCL_WORKER_CALIBRATION_ITERS; iter++) {
+            uint64_t value = 1;
+            struct pollfd pfd = { event_fd, POLLIN, 0 };
+            uint64_t start = ccl_worker_wall_time_ns();
+            if (write(event_fd, &value, sizeof(value)) != sizeof(value) ||
+                ::poll(&pfd, 1, 0) != 1 || read(event_fd, &value, sizeof(value)) != sizeof(value)) {
+                break;
+            }
+            samples.push_back(ccl_worker_wall_time_ns() - start);
+        }
+
+        spin_time_ns = CCL_WORKER_MIN_SPIN_TIME_NS;
+        if (!samples.empty()) {
+            std::sort(samples.begin(), samples.end());
+            spin_time_ns = std::min(std::max(samples[samples.size() / 2] *
+                                                 CCL_WORKER_WAKEUP_COST_FACTOR,
+                                             static_cast<uint64_t>(CCL_WORKER_MIN_SPIN_TIME_NS)),
+                                    static_cast<uint64_t>(CCL_WORKER_MAX_SPIN_TIME_NS));
+        }
+    }
+
+    LOG_DEBUG("worker ", get_idx(), " hybrid wait, spin time ", spin_time_ns / 1000, " usec");
+}
+
+bool ccl_worker::has_active_scheds() {
+    return sched_queue->peek() != nullptr;
+}
+
+void ccl_worker::check_hybrid_wait_condition() {
+    uint64_t now = ccl_worker_wall_time_ns();
+
+    if (made_progress || !idle_start_ns) {
+        made_progress = false;
+        idle_start_ns = now;
+        return;
+    }
+
+    if (now - idle_start_ns < spin_time_ns)
+        return;
+
+    block_on_events();
+    idle_start_ns = 0;
+}
+
+void ccl_worker::signal_event() {
+    if (event_fd < 0)
+        return;
+
+    signal_time_ns.store(ccl_worker_wall_time_ns(), std::memory_order_relaxed);
+    uint64_t value = 1;
+    if (write(event_fd, &value, sizeof(value)) != sizeof(value)) {
+        LOG_DEBUG("worker ", get_idx(), " can't signal eventfd, errno ", errno);
+    }
+}
+
+void ccl_worker::block_on_events() {
+    /* the same endpoints are polled in process_sched_bin */
+    wait_eps.clear();
+    wait_fds.clear();
+    for (auto bin : sched_queue->peek_all()) {
+        if (!bin->size())
+            continue;
+
+        auto ep = std::make_pair(bin->get(0)->coll_param.comm->get_atl_comm().get(),
+                                 bin->get_atl_ep());
+        if (std::find(wait_eps.begin(), wait_eps.end(), ep) != wait_eps.end())
+            continue;
+
+        if (ep.first->get_wait_fds(ep.second, ep_wait_fds) != ATL_STATUS_SUCCESS) {
+            /* transport can't wake us up, keep polling */
+            ccl_yield(ccl::global_data::env().yield_type);
+            return;
+        }
+
+        wait_eps.push_back(ep);
+        for (auto fd : ep_wait_fds) {
+            if (std::find(wait_fds.begin(), wait_fds.end(), fd) == wait_fds.end())
+                wait_fds.push_back(fd);
+        }
+    }
+
+    if (wait_eps.empty())
+        return;
+
+    size_t add_count = add_counter.load(std::memory_order_seq_cst);
+    is_blocked.store(true, std::memory_order_seq_cst);
+
+    /* a sched may be added right before is_blocked is set, don't miss it */
+    bool can_block = (add_count == add_counter.load(std::memory_order_seq_cst));
+    for (size_t idx = 0; idx < wait_eps.size() && can_block; idx++) {
+        can_block = (wait_eps[idx].first->try_wait(wait_eps[idx].second) == ATL_STATUS_SUCCESS);
+    }
+    if (!can_block) {
+        is_blocked.store(false, std::memory_order_seq_cst);
+        return;
+    }
+
+    wait_pollfds.clear();
+    for (auto fd : wait_fds) {
+        wait_pollfds.push_back({ fd, POLLIN, 0 });
+    }
+    if (event_fd >= 0) {
+        wait_pollfds.push_back({ event_fd, POLLIN, 0 });
+    }
+
+    uint64_t block_start = ccl_worker_wall_time_ns();
+    int ret = ::poll(wait_pollfds.data(),
+                     wait_pollfds.size(),
+                     static_cast<int>(ccl::global_data::env().worker_block_timeout));
+    uint64_t block_end = ccl_worker_wall_time_ns();
+
+    is_blocked.store(false, std::memory_order_seq_cst);
+
+    wait_stats.block_count++;
+    wait_stats.blocked_ns += block_end - block_start;
+
+    if (ret == 0) {
+        wait_stats.timeouts++;
+    }
+    else if (ret > 0) {
+        if (event_fd >= 0 && (wait_pollfds.back().revents & POLLIN)) {
+            uint64_t value = 0;
+            if (read(event_fd, &value, sizeof(value)) == sizeof(value)) {
+                uint64_t signal_time = signal_time_ns.load(std::memory_order_relaxed);
+                if (signal_time >= block_start && signal_time <= block_end) {
+                    wait_stats.submit_latency_ns += block_end - signal_time;
+                    wait_stats.submit_wakeups++;
+                }
+            }
+        }
+        else {
+            wait_stats.transport_wakeups++;
+        }
+    }
+    else if (errno != EINTR) {
+        LOG_DEBUG("worker ", get_idx(), " poll failed, errno ", errno);
+    }
+}
+
+void ccl_worker::report_hybrid_wait_stats() {
+    uint64_t wall_ns = ccl_worker_wall_time_ns() - wait_stats.start_wall_ns;
+    uint64_t cpu_ns = ccl_worker_cpu_time_ns() - wait_stats.start_cpu_ns;
+
+    LOG_INFO("worker ",
+             get_idx(),
+             " hybrid wait: spin time ",
+             spin_time_ns / 1000,
+             " usec, blocks ",
+             wait_stats.block_count,
+             " (transport wakeups ",
+             wait_stats.transport_wakeups,
+             ", submit wakeups ",
+             wait_stats.submit_wakeups,
+             ", timeouts ",
+             wait_stats.timeouts,
+             "), blocked time ",
+             wait_stats.blocked_ns / 1000,
+             " usec, avg submit wakeup latency ",
+             wait_stats.submit_wakeups
+                 ? wait_stats.submit_latency_ns / wait_stats.submit_wakeups / 1000
+                 : 0,
+             " usec, cpu time ",
+             cpu_ns / 1000,
+             " usec of wall time ",
+             wall_ns / 1000,
+             " usec");
+}
+
 void ccl_worker::clear_queue() {
     strict_sched_queue->clear();
     sched_queue->clear();
@@ -336,6 +572,11 @@ static void* ccl_worker_func(void* args) {
 
     ccl::global_data::get().is_worker_thread = true;
 
+    bool use_hybrid_wait = ccl::global_data::env().worker_hybrid_wait;
+    if (use_hybrid_wait) {
+        worker->start_hybrid_wait();
+    }
+
     worker->started = true;
 
     do {
@@ -362,10 +603,15 @@ static void* ccl_worker_func(void* args) {
         iter++;
 
         if (processed_count == 0) {
-            spin_count--;
-            if (!spin_count) {
-                worker->check_wait_condition(iter);
-                spin_count = 1;
+            if (use_hybrid_wait && worker->has_active_scheds()) {
+                worker->check_hybrid_wait_condition();
+            }
+            else {
+                spin_count--;
+                if (!spin_count) {
+                    worker->check_wait_condition(iter);
+                    spin_count = 1;
+                }
             }
         }
         else {
@@ -373,6 +619,10 @@ static void* ccl_worker_func(void* args) {
         }
     } while (true);
 
+    if (use_hybrid_wait) {
+        worker->report_hybrid_wait_stats();
+    }
+
     worker->started = false;
 
     return nullptr;
@@ -22,8 +22,12 @@
 
 #include <memory>
 #include <list>
+#include <utility>
+#include <vector>
+#include <poll.h>
 #include <pthread.h>
 
+class atl_base_comm;
 class ccl_executor;
 
 class ccl_worker : public ccl_base_thread {
@@ -33,10 +37,7 @@ public:
     ccl_worker& operator=(const ccl_worker& other) = delete;
     ccl_worker(size_t idx, std::unique_ptr<ccl_sched_queue> queue);
 
-    virtual ~ccl_worker() {
-        strict_sched_queue.reset();
-        sched_queue.reset();
-    }
+    virtual ~ccl_worker();
 
     virtual void* get_this() override {
         return static_cast<void*>(this);
@@ -68,13 +69,48 @@ public:
     bool check_affinity_condition(size_t iter);
     bool check_stop_condition(size_t iter);
 
+    /* hybrid spin-then-block waiting while scheds are active, see CCL_WORKER_HYBRID_WAIT */
+    void start_hybrid_wait();
+    bool has_active_scheds();
+    void check_hybrid_wait_condition();
+    void report_hybrid_wait_stats();
+
 private:
     ccl::status process_strict_sched_queue();
     ccl::status process_sched_queue(size_t& processed_count, bool process_all);
     ccl::status process_sched_bin(ccl_sched_bin* bin, size_t& processed_count);
+    void block_on_events();
+    void signal_event();
 
     size_t do_work_counter = 0;
 
+    /* eventfd is signalled when a sched is added while the worker is blocked */
+    int event_fd = -1;
+    std::atomic<bool> is_blocked{ false };
+    std::atomic<size_t> add_counter{ 0 };
+    std::atomic<uint64_t> signal_time_ns{ 0 };
+
+    bool made_progress = false;
+    uint64_t spin_time_ns = 0;
+    uint64_t idle_start_ns = 0;
+    /* endpoints of active bins, blocking is possible only if all of them can wake us up */
+    std::vector<std::pair<atl_base_comm*, size_t>> wait_eps;
+    std::vector<int> wait_fds;
+    std::vector<int> ep_wait_fds;
+    std::vector<struct pollfd> wait_pollfds;
+
+    struct hybrid_wait_stats {
+        size_t block_count;
+        size_t transport_wakeups;
+        size_t submit_wakeups;
+        size_t timeouts;
+        uint64_t blocked_ns;
+        uint64_t submit_latency_ns;
+        uint64_t start_wall_ns;
+        uint64_t start_cpu_ns;
+    };
+    hybrid_wait_stats wait_stats{};
+
     std::unique_ptr<ccl_strict_sched_queue> strict_sched_queue;
     std::unique_ptr<ccl_sched_queue> sched_queue;
 };
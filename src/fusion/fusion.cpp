@@ -13,12 +13,15 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include "coll/algorithms/algorithms.hpp"
 #include "exec/exec.hpp"
 #include "fusion/fusion.hpp"
 #include "sched/buffer/buffer_cache.hpp"
 #include "sched/cache/cache.hpp"
 #include "sched/entry/factory/entry_factory.hpp"
 
+#include <algorithm>
+
 #define CCL_FUSION_CHECK_SCHEDS_ITERS (1024)
 
 ccl::status complete_user_request(const void* ctx) {
@@ -31,8 +34,15 @@ ccl::status complete_user_request(const void* ctx) {
 ccl::status release_fusion_buf(const void* ctx) {
     void* buf = (void*)ctx;
 
-    if (ccl::global_data::get().fusion_manager)
+    if (ccl::global_data::get().fusion_manager) {
         ccl::global_data::get().fusion_manager->release_buffer(buf);
+    }
+    else if (ccl::global_data::get().buffer_cache) {
+        /* cached fused scheds may outlive fusion manager */
+        const auto& env = ccl::global_data::env();
+        ccl::global_data::get().buffer_cache->push(
+            0, env.fusion_bytes_threshold * env.fusion_count_threshold, buf);
+    }
 
     return ccl::status::success;
 }
@@ -49,13 +59,13 @@ ccl_fusion_manager::ccl_fusion_manager()
     CCL_THROW_IF_NOT(count_threshold >= 1, "unexpected fusion_count_threshold ", count_threshold);
     CCL_THROW_IF_NOT(buffer_size >= 1, "unexpected fusion_buffer_size ", buffer_size);
 
-    long cycle_usec = long(ccl::global_data::env().fusion_cycle_ms * 1000.0);
-    cycle = std::chrono::microseconds(cycle_usec);
-    last_exec_time = std::chrono::steady_clock::now();
+    if (!ccl::global_data::env().fusion_check_urgent) {
+        LOG_WARN("fusion batches are always closed on wait or test, ",
+                 CCL_FUSION_CHECK_URGENT,
+                 "=0 is ignored");
+    }
 
-    LOG_INFO("created fusion manager, cycle_usec ",
-             cycle_usec,
-             ", bytes_threshold ",
+    LOG_INFO("created fusion manager, bytes_threshold ",
              bytes_threshold,
              ", count_threshold ",
              count_threshold,
@@ -73,15 +83,44 @@ ccl_fusion_manager::~ccl_fusion_manager() {
              ", overlapped_exec_calls ",
              stat_overlapped_exec_calls);
 
+    for (const auto& it : buckets) {
+        const ccl_fusion_bucket& bucket = it.second;
+        auto to_usec = [](ccl_fusion_bucket::clock_t::duration d) {
+            return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(d)
+                .count();
+        };
+        LOG_INFO("fusion bucket: comm ",
+                 bucket.comm_id,
+                 ", fused_ops ",
+                 bucket.stat_fused_ops,
+                 ", fused_bytes ",
+                 bucket.stat_fused_bytes,
+                 ", flushes ",
+                 bucket.stat_flushes,
+                 ", avg_added_latency_usec ",
+                 (bucket.stat_fused_ops ? to_usec(bucket.stat_sum_latency) / bucket.stat_fused_ops
+                                        : 0.0),
+                 ", max_added_latency_usec ",
+                 to_usec(bucket.stat_max_latency));
+    }
+
     reset();
 
-    CCL_ASSERT(postponed_queue.empty() && exec_queue.empty() && tracked_scheds.empty(),
+    CCL_ASSERT(!pending_count && tracked_scheds.empty(),
                "queues are not empty, ",
-               postponed_queue.size(),
-               " ",
-               exec_queue.size(),
+               pending_count.load(),
                " ",
                tracked_scheds.size());
+
+    /* buffers of cached fused scheds are returned to buffer cache on sched cache cleanup */
+    LOG_DEBUG("fusion buffers: allocated ",
+              allocated_buffer_count,
+              ", released ",
+              free_buffers.size());
+    for (auto buf : free_buffers) {
+        ccl::global_data::get().buffer_cache->push(0, buffer_size, buf);
+    }
+    free_buffers.clear();
 }
 
 bool ccl_fusion_manager::can_reset() {
@@ -134,15 +173,43 @@ bool ccl_fusion_manager::add(ccl_sched* sched) {
     CCL_THROW_IF_NOT(sched->is_completed(), "incorrect completion counter");
     sched->get_request()->set_counter(1);
 
+    const ccl_coll_param& param = sched->coll_param;
+    auto arrival_time = ccl_fusion_bucket::clock_t::now();
+
     {
         std::lock_guard<ccl_fusion_manager::lock_t> lock{ guard };
-        postponed_queue.push_back(sched);
+
+        auto it = buckets.find(param.comm);
+        if (it == buckets.end()) {
+            it = buckets.emplace(param.comm, ccl_fusion_bucket()).first;
+            it->second.comm_id = param.comm->id();
+        }
+
+        it->second.queue.push_back({ sched, arrival_time });
+        pending_count++;
     }
 
     return true;
 }
 
-ccl_sched* ccl_fusion_manager::build_sched() {
+void* ccl_fusion_manager::get_buffer() {
+    {
+        std::lock_guard<ccl_fusion_manager::lock_t> lock{ guard };
+        if (!free_buffers.empty()) {
+            void* buf = free_buffers.back();
+            free_buffers.pop_back();
+            return buf;
+        }
+        allocated_buffer_count++;
+    }
+
+    void* buf = nullptr;
+    ccl::global_data::get().buffer_cache->get(0, buffer_size, &buf);
+    LOG_DEBUG("allocated fusion buffer ", buf, ", buffer_count ", allocated_buffer_count);
+    return buf;
+}
+
+ccl_sched* ccl_fusion_manager::build_sched(const sched_list_t& scheds) {
     size_t sum_count = 0, sum_bytes = 0, dtype_size;
     size_t max_priority = 0;
     bool use_cache = true;
@@ -152,11 +219,12 @@ ccl_sched* ccl_fusion_manager::build_sched() {
     const ccl_stream* stream __attribute__((unused)) = nullptr;
     void* fusion_buf = nullptr;
     bool fill_sched = true;
+    bool zero_copy = ccl::global_data::env().fusion_zero_copy;
 
-    CCL_THROW_IF_NOT(exec_queue.size(), "empty queue");
+    CCL_THROW_IF_NOT(scheds.size(), "empty queue");
 
-    auto first_sched = exec_queue.front();
-    auto last_sched = exec_queue.back();
+    auto first_sched = scheds.front();
+    auto last_sched = scheds.back();
     const ccl_datatype& dtype = first_sched->coll_param.dtype;
     dtype_size = dtype.size();
     reduction = first_sched->coll_param.reduction;
@@ -165,7 +233,14 @@ ccl_sched* ccl_fusion_manager::build_sched() {
     stream = first_sched->coll_param.stream;
     max_priority = first_sched->coll_attr.priority;
 
-    for (const auto& s : exec_queue) {
+#ifdef CCL_ENABLE_SYCL
+    if (stream && stream->is_sycl_device_stream()) {
+        /* device buffers are staged through the fusion buffer */
+        zero_copy = false;
+    }
+#endif // CCL_ENABLE_SYCL
+
+    for (const auto& s : scheds) {
         sum_count += s->coll_param.get_send_count();
         if (!s->coll_attr.to_cache) {
             use_cache = false;
@@ -179,17 +254,28 @@ ccl_sched* ccl_fusion_manager::build_sched() {
               ", sum_bytes ",
               sum_bytes,
               ", sched_count ",
-              exec_queue.size());
+              scheds.size());
 
     ccl_sched* sched = nullptr;
-    auto create_fn = [this, ctype, &fusion_buf, sum_count, dtype, reduction, comm, stream]() {
+    auto create_fn = [this,
+                      ctype,
+                      &fusion_buf,
+                      zero_copy,
+                      first_sched,
+                      sum_count,
+                      dtype,
+                      reduction,
+                      comm,
+                      stream]() {
         ccl_sched* sched = nullptr;
         switch (ctype) {
             case ccl_coll_allreduce: {
-                ccl::global_data::get().buffer_cache->get(0, buffer_size, &fusion_buf);
+                /* in zero-copy mode the fused sched works on user buffers */
+                void* buf = (zero_copy) ? first_sched->coll_param.get_recv_buf() : get_buffer();
+                fusion_buf = (zero_copy) ? nullptr : buf;
                 ccl_coll_attr coll_attr;
-                ccl_coll_param coll_param = ccl_coll_param::create_allreduce_param(fusion_buf,
-                                                                                   fusion_buf,
+                ccl_coll_param coll_param = ccl_coll_param::create_allreduce_param(buf,
+                                                                                   buf,
                                                                                    sum_count,
                                                                                    dtype.idx(),
                                                                                    reduction,
@@ -207,7 +293,7 @@ ccl_sched* ccl_fusion_manager::build_sched() {
         ccl_sched_key key{};
         key.f.ctype = ctype;
         key.f.count1 = sum_count;
-        key.f.count2 = exec_queue.size();
+        key.f.count2 = scheds.size();
         key.f.dtype = dtype.idx();
         key.f.reduction = reduction;
         key.f.comm = comm;
@@ -250,16 +336,20 @@ ccl_sched* ccl_fusion_manager::build_sched() {
     sched->coll_attr.to_cache = use_cache;
 
     stat_fused_bytes += sum_bytes;
-    stat_fused_ops += exec_queue.size();
+    stat_fused_ops += scheds.size();
 
     if (!fill_sched) {
-        clear_exec_queue();
+        return sched;
+    }
+
+    if (zero_copy) {
+        fill_zero_copy_sched(sched, scheds);
         return sched;
     }
 
     sched->commit(ccl::global_data::get().parallelizer.get());
 
-    size_t exec_queue_size = exec_queue.size();
+    size_t exec_queue_size = scheds.size();
     size_t part_count = sched->get_subscheds().size();
     std::vector<std::shared_ptr<ccl_sched>>& part_scheds = sched->get_subscheds();
     size_t copies_per_part = exec_queue_size / part_count;
@@ -291,12 +381,12 @@ ccl_sched* ccl_fusion_manager::build_sched() {
                 entry_factory::create<copy_entry>(
                     part_scheds[idx].get(),
                     ccl_buffer(
-                        exec_queue[global_copy_idx]->coll_param.get_send_buf_ptr(
+                        scheds[global_copy_idx]->coll_param.get_send_buf_ptr(
                             0, ccl_coll_param::buf_type::device),
-                        exec_queue[global_copy_idx]->coll_param.get_send_count() * dtype_size,
+                        scheds[global_copy_idx]->coll_param.get_send_count() * dtype_size,
                         ccl_buffer_type::INDIRECT),
                     ccl_buffer(fusion_buf, buffer_size, offset),
-                    exec_queue[global_copy_idx]->coll_param.get_send_count(),
+                    scheds[global_copy_idx]->coll_param.get_send_count(),
                     dtype,
                     copy_attr(copy_direction::d2h));
             else
@@ -304,14 +394,14 @@ ccl_sched* ccl_fusion_manager::build_sched() {
                 entry_factory::create<copy_entry>(
                     part_scheds[idx].get(),
                     ccl_buffer(
-                        exec_queue[global_copy_idx]->coll_param.get_send_buf_ptr(),
-                        exec_queue[global_copy_idx]->coll_param.get_send_count() * dtype_size,
+                        scheds[global_copy_idx]->coll_param.get_send_buf_ptr(),
+                        scheds[global_copy_idx]->coll_param.get_send_count() * dtype_size,
                         ccl_buffer_type::INDIRECT),
                     ccl_buffer(fusion_buf, buffer_size, offset),
-                    exec_queue[global_copy_idx]->coll_param.get_send_count(),
+                    scheds[global_copy_idx]->coll_param.get_send_count(),
                     dtype);
 
-            offset += exec_queue[global_copy_idx]->coll_param.get_send_count() * dtype_size;
+            offset += scheds[global_copy_idx]->coll_param.get_send_count() * dtype_size;
         }
     }
 
@@ -332,11 +422,11 @@ ccl_sched* ccl_fusion_manager::build_sched() {
                     part_scheds[idx].get(),
                     ccl_buffer(fusion_buf, buffer_size, offset),
                     ccl_buffer(
-                        exec_queue[global_copy_idx]->coll_param.get_recv_buf_ptr(
+                        scheds[global_copy_idx]->coll_param.get_recv_buf_ptr(
                             0, ccl_coll_param::buf_type::device),
-                        exec_queue[global_copy_idx]->coll_param.get_recv_count() * dtype_size,
+                        scheds[global_copy_idx]->coll_param.get_recv_count() * dtype_size,
                         ccl_buffer_type::INDIRECT),
-                    exec_queue[global_copy_idx]->coll_param.get_recv_count(),
+                    scheds[global_copy_idx]->coll_param.get_recv_count(),
                     dtype,
                     copy_attr(copy_direction::h2d));
             else
@@ -345,18 +435,18 @@ ccl_sched* ccl_fusion_manager::build_sched() {
                     part_scheds[idx].get(),
                     ccl_buffer(fusion_buf, buffer_size, offset),
                     ccl_buffer(
-                        exec_queue[global_copy_idx]->coll_param.get_recv_buf_ptr(),
-                        exec_queue[global_copy_idx]->coll_param.get_recv_count() * dtype_size,
+                        scheds[global_copy_idx]->coll_param.get_recv_buf_ptr(),
+                        scheds[global_copy_idx]->coll_param.get_recv_count() * dtype_size,
                         ccl_buffer_type::INDIRECT),
-                    exec_queue[global_copy_idx]->coll_param.get_recv_count(),
+                    scheds[global_copy_idx]->coll_param.get_recv_count(),
                     dtype);
 
             part_scheds[idx]->add_barrier();
 
-            offset += exec_queue[global_copy_idx]->coll_param.get_recv_count() * dtype_size;
+            offset += scheds[global_copy_idx]->coll_param.get_recv_count() * dtype_size;
             entry_factory::create<function_entry>(
-                part_scheds[idx].get(), complete_user_request, exec_queue[global_copy_idx]);
-            CCL_THROW_IF_NOT(!exec_queue[global_copy_idx]->is_completed(),
+                part_scheds[idx].get(), complete_user_request, scheds[global_copy_idx]);
+            CCL_THROW_IF_NOT(!scheds[global_copy_idx]->is_completed(),
                              "incorrect completion counter");
         }
     }
@@ -370,108 +460,183 @@ ccl_sched* ccl_fusion_manager::build_sched() {
         entry_factory::create<function_entry>(part_scheds[0].get(), release_fusion_buf, fusion_buf);
     }
 
-    clear_exec_queue();
-
     return sched;
 }
 
-void ccl_fusion_manager::execute() {
-    auto this_time = std::chrono::steady_clock::now();
-    auto diff = (last_exec_time + cycle - this_time);
-    if (diff > std::chrono::steady_clock::duration::zero()) {
-        /* it is too early, do nothing */
-        stat_empty_exec_calls++;
-        return;
+void ccl_fusion_manager::fill_zero_copy_sched(ccl_sched* sched, const sched_list_t& scheds) {
+    const ccl_coll_param& param = sched->coll_param;
+    const ccl_datatype& dtype = param.dtype;
+    size_t dtype_size = dtype.size();
+
+    /* single partial sched, the fused vector is already split by segments */
+    sched->commit();
+
+    ccl_coll_param part_coll_param{};
+    part_coll_param.ctype = ccl_coll_partial;
+    part_coll_param.stream = param.stream;
+    part_coll_param.comm = param.comm;
+    sched->add_subsched(part_coll_param);
+
+    ccl_sched* part_sched = sched->get_subscheds().front().get();
+    part_sched->coll_attr = sched->coll_attr;
+
+    std::vector<ccl_buffer> bufs;
+    std::vector<size_t> counts;
+    bufs.reserve(scheds.size());
+    counts.reserve(scheds.size());
+
+    for (const auto& s : scheds) {
+        size_t count = s->coll_param.get_recv_count();
+        ccl_buffer recv_buf(
+            s->coll_param.get_recv_buf_ptr(), count * dtype_size, ccl_buffer_type::INDIRECT);
+        if (!s->coll_param.is_inplace()) {
+            entry_factory::create<copy_entry>(
+                part_sched,
+                ccl_buffer(s->coll_param.get_send_buf_ptr(),
+                           count * dtype_size,
+                           ccl_buffer_type::INDIRECT),
+                recv_buf,
+                count,
+                dtype);
+        }
+        bufs.push_back(recv_buf);
+        counts.push_back(count);
     }
-    last_exec_time = std::chrono::steady_clock::now();
+    part_sched->add_barrier();
 
-    bool flush_exec_queue = false;
-    if (ccl::global_data::env().fusion_check_urgent && !exec_queue.empty()) {
-        /* recheck scheds from exec_queue, maybe some of them were marked as urgent since previous call */
-        for (auto it = exec_queue.begin(); it != exec_queue.end(); ++it) {
-            if ((*it)->get_request()->urgent) {
-                LOG_DEBUG("found urgent sched in exec_queue, flush exec_queue");
-                flush_exec_queue = true;
-                break;
-            }
+    ccl_coll_build_ring_allreduce_segments(
+        part_sched, bufs, counts, dtype, param.reduction, param.comm);
+
+    for (const auto& s : scheds) {
+        entry_factory::create<function_entry>(part_sched, complete_user_request, s);
+        CCL_THROW_IF_NOT(!s->is_completed(), "incorrect completion counter");
+    }
+
+    LOG_DEBUG("built zero-copy fused_sched, segments ", bufs.size());
+}
+
+size_t ccl_fusion_manager::get_flush_count(const ccl_fusion_bucket& bucket) const {
+    size_t sum_bytes = 0;
+
+    for (size_t idx = 0; idx < bucket.queue.size(); idx++) {
+        const ccl_sched* sched = bucket.queue[idx].sched;
+        sum_bytes += sched->coll_param.get_send_count() * sched->coll_param.dtype.size();
+
+        if ((sum_bytes >= buffer_size) || (idx + 1 >= count_threshold)) {
+            return idx + 1;
+        }
+
+        /* the application waits for this sched, ranks are expected to wait for the same ops */
+        if (sched->get_request()->urgent) {
+            LOG_DEBUG("found urgent sched in bucket, flush ", idx + 1, " scheds");
+            return idx + 1;
         }
     }
 
-    /* separate block to reduce lock scope */
-    {
-        std::lock_guard<ccl_fusion_manager::lock_t> lock{ guard };
-        if (!postponed_queue.empty()) {
-            LOG_DEBUG("postponed_queue size ", postponed_queue.size());
+    return 0;
+}
 
-            ccl_sched* first_sched;
-            if (!exec_queue.empty()) {
-                first_sched = exec_queue.front();
-            }
-            else {
-                first_sched = postponed_queue.front();
-                exec_queue.push_back(first_sched);
-                postponed_queue.pop_front();
-                exec_queue_sum_bytes =
-                    first_sched->coll_param.get_send_count() * first_sched->coll_param.dtype.size();
+void ccl_fusion_manager::get_batches(ccl_fusion_bucket& bucket,
+                                     size_t sched_count,
+                                     ccl_fusion_bucket::clock_t::time_point now,
+                                     std::vector<sched_list_t>& batches) {
+    CCL_THROW_IF_NOT(sched_count && sched_count <= bucket.queue.size(),
+                     "unexpected sched_count ",
+                     sched_count,
+                     ", queue size ",
+                     bucket.queue.size());
+
+    /* open batch per key in order of the first appearance in the prefix */
+    std::vector<std::pair<ccl_fusion_bucket_key, size_t>> open_batches;
+    std::vector<size_t> batch_bytes;
+
+    for (size_t idx = 0; idx < sched_count; idx++) {
+        const auto& entry = bucket.queue.front();
+        const ccl_coll_param& param = entry.sched->coll_param;
+        ccl_fusion_bucket_key key{ param.ctype, param.dtype.idx(), param.reduction, param.stream };
+        size_t bytes = param.get_send_count() * param.dtype.size();
+
+        auto it = std::find_if(open_batches.begin(), open_batches.end(), [&key](const auto& b) {
+            return b.first == key;
+        });
+        if (it != open_batches.end()) {
+            const sched_list_t& batch = batches[it->second];
+            if ((batch.size() >= count_threshold) ||
+                (batch_bytes[it->second] + bytes > buffer_size)) {
+                open_batches.erase(it);
+                it = open_batches.end();
             }
+        }
+        if (it == open_batches.end()) {
+            open_batches.emplace_back(key, batches.size());
+            batches.emplace_back();
+            batch_bytes.push_back(0);
+            it = open_batches.end() - 1;
+        }
 
-            for (auto it = postponed_queue.begin(); it != postponed_queue.end();) {
-                auto s = *it;
-                if (s->coll_param.dtype == first_sched->coll_param.dtype &&
-                    s->coll_param.comm == first_sched->coll_param.comm &&
-                    s->coll_param.ctype == first_sched->coll_param.ctype &&
-                    s->coll_param.reduction == first_sched->coll_param.reduction &&
-                    s->coll_param.stream == first_sched->coll_param.stream) {
-                    size_t size = s->coll_param.get_send_count() * s->coll_param.dtype.size();
-                    if (exec_queue_sum_bytes + size > buffer_size) {
-                        LOG_DEBUG("too much bytes in buffer, flush exec_queue");
-                        flush_exec_queue = true;
-                        break;
-                    }
-                    exec_queue_sum_bytes += size;
-
-                    if (ccl::global_data::env().fusion_check_urgent && !flush_exec_queue &&
-                        s->get_request()->urgent) {
-                        LOG_DEBUG(
-                            "found urgent sched in postponed_queue, flush exec_queue, postponed_queue size ",
-                            postponed_queue.size());
-                        flush_exec_queue = true;
-                    }
-
-                    exec_queue.push_back(s);
-                    it = postponed_queue.erase(it);
-
-                    if (exec_queue.size() == count_threshold) {
-                        LOG_DEBUG("too many scheds, flush exec_queue");
-                        flush_exec_queue = true;
-                        break;
-                    }
-                }
-                else {
-                    ++it;
+        auto latency = now - entry.arrival_time;
+        bucket.stat_sum_latency += latency;
+        bucket.stat_max_latency = std::max(bucket.stat_max_latency, latency);
+        bucket.stat_fused_bytes += bytes;
+
+        batches[it->second].push_back(entry.sched);
+        batch_bytes[it->second] += bytes;
+        bucket.queue.pop_front();
+    }
+
+    bucket.stat_fused_ops += sched_count;
+    bucket.stat_flushes++;
+}
+
+void ccl_fusion_manager::execute() {
+    size_t prev_fused_ops = stat_fused_ops;
+
+    /* another thread creates fused scheds, their order has to match across ranks */
+    std::unique_lock<ccl_fusion_manager::lock_t> exec_lock(exec_guard, std::try_to_lock);
+    if (!exec_lock.owns_lock()) {
+        return;
+    }
+
+    if (!pending_count.load(std::memory_order_relaxed)) {
+        stat_empty_exec_calls++;
+    }
+    else {
+        std::vector<sched_list_t> batches;
+        auto now = ccl_fusion_bucket::clock_t::now();
+
+        /* separate block to reduce lock scope */
+        {
+            std::lock_guard<ccl_fusion_manager::lock_t> lock{ guard };
+            for (auto& it : buckets) {
+                ccl_fusion_bucket& bucket = it.second;
+                size_t flush_count = 0;
+                while ((flush_count = get_flush_count(bucket))) {
+                    get_batches(bucket, flush_count, now, batches);
+                    pending_count -= flush_count;
                 }
             }
         }
-    }
 
-    if (flush_exec_queue) {
-        LOG_DEBUG("exec_queue size ", exec_queue.size(), ", bytes ", exec_queue_sum_bytes);
-        ccl_sched* sched = build_sched();
-        sched->start(ccl::global_data::get().executor.get());
+        if (batches.empty()) {
+            stat_empty_exec_calls++;
+        }
+
+        for (const auto& batch : batches) {
+            LOG_DEBUG("flush fusion batch, size ", batch.size());
+            ccl_sched* sched = build_sched(batch);
+            sched->start(ccl::global_data::get().executor.get());
+        }
     }
 
-    if (stat_fused_ops % CCL_FUSION_CHECK_SCHEDS_ITERS == 0) {
+    if (prev_fused_ops / CCL_FUSION_CHECK_SCHEDS_ITERS !=
+        stat_fused_ops / CCL_FUSION_CHECK_SCHEDS_ITERS) {
         check_tracked_scheds();
     }
 }
 
 void ccl_fusion_manager::release_buffer(void* buf) {
-    ccl::global_data::get().buffer_cache->push(0, buffer_size, buf);
-}
-
-void ccl_fusion_manager::clear_exec_queue() {
-    exec_queue.clear();
-    exec_queue_sum_bytes = 0;
+    std::lock_guard<ccl_fusion_manager::lock_t> lock{ guard };
+    free_buffers.push_back(buf);
 }
 
 void ccl_fusion_manager::check_tracked_scheds(bool force_release) {
@@ -18,9 +18,54 @@
 #include "common/utils/spinlock.hpp"
 #include "sched/sched.hpp"
 
+#include <atomic>
 #include <chrono>
-#include <mutex>
 #include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/* scheds can be fused only if they have the same key */
+struct ccl_fusion_bucket_key {
+    ccl_coll_type ctype;
+    ccl::datatype dtype;
+    ccl::reduction reduction;
+    const ccl_stream* stream;
+
+    bool operator==(const ccl_fusion_bucket_key& other) const {
+        return std::tie(ctype, dtype, reduction, stream) ==
+               std::tie(other.ctype, other.dtype, other.reduction, other.stream);
+    }
+};
+
+/*
+   pending scheds of a single communicator in submission order
+
+   the queue is cut after the sched which reaches count or bytes threshold
+   and after the sched the application waits for or tests, cut points depend
+   on submission order only, so all ranks flush the same prefixes without
+   exchanging messages, a prefix is split into batches by key, count and bytes
+*/
+struct ccl_fusion_bucket {
+    using clock_t = std::chrono::steady_clock;
+
+    struct entry {
+        ccl_sched* sched;
+        clock_t::time_point arrival_time;
+    };
+
+    std::deque<entry> queue{};
+
+    int comm_id = 0;
+
+    size_t stat_fused_ops = 0;
+    size_t stat_fused_bytes = 0;
+    size_t stat_flushes = 0;
+    clock_t::duration stat_sum_latency = clock_t::duration::zero();
+    clock_t::duration stat_max_latency = clock_t::duration::zero();
+};
 
 class ccl_fusion_manager {
 public:
@@ -38,8 +83,16 @@ public:
     void release_buffer(void* buf);
 
 private:
-    ccl_sched* build_sched();
-    void clear_exec_queue();
+    using sched_list_t = std::vector<ccl_sched*>;
+
+    ccl_sched* build_sched(const sched_list_t& scheds);
+    void fill_zero_copy_sched(ccl_sched* sched, const sched_list_t& scheds);
+    size_t get_flush_count(const ccl_fusion_bucket& bucket) const;
+    void get_batches(ccl_fusion_bucket& bucket,
+                     size_t sched_count,
+                     ccl_fusion_bucket::clock_t::time_point now,
+                     std::vector<sched_list_t>& batches);
+    void* get_buffer();
     void check_tracked_scheds(bool force_release = false);
 
     const size_t bytes_threshold;
@@ -48,18 +101,18 @@ private:
 
     using lock_t = ccl_spinlock;
     lock_t guard{};
+    /* fused scheds take internal sched ids, so they are created by one thread at a time */
+    lock_t exec_guard{};
 
-    using sched_queue_t = std::deque<ccl_sched*>;
-    sched_queue_t postponed_queue{};
-    sched_queue_t exec_queue{};
+    std::map<ccl_comm*, ccl_fusion_bucket> buckets{};
+    std::atomic<size_t> pending_count{ 0 };
 
-    size_t exec_queue_sum_bytes = 0;
+    /* fusion buffers are allocated once and reused, so their addresses stay stable for transport */
+    std::vector<void*> free_buffers{};
+    size_t allocated_buffer_count = 0;
 
     std::list<ccl_sched*> tracked_scheds{};
 
-    std::chrono::steady_clock::duration cycle;
-    std::chrono::steady_clock::time_point last_exec_time;
-
     size_t stat_fused_ops = 0;
     size_t stat_fused_bytes = 0;
     size_t stat_empty_exec_calls = 0;
@@ -270,6 +270,34 @@ ccl_numa_node ccl_hwloc_wrapper::get_numa_node(int numa_node) {
               ". (But this should've been caught by is_valid_numa_node)");
 }
 
+int ccl_hwloc_wrapper::get_package_idx() {
+    if (!is_initialized()) {
+        return CCL_HWLOC_INVALID_PACKAGE;
+    }
+
+    auto get_package = [this](hwloc_const_cpuset_t cpuset) -> hwloc_obj_t {
+        hwloc_obj_t obj = hwloc_get_obj_covering_cpuset(topology, cpuset);
+        while (obj && obj->type != HWLOC_OBJ_PACKAGE) {
+            obj = obj->parent;
+        }
+        return obj;
+    };
+
+    hwloc_obj_t package = get_package(bindset);
+
+    if (!package) {
+        // process is not bound or its binding spans several packages,
+        // use the package of the cpu where the process runs now
+        hwloc_cpuset_t last_cpuset = hwloc_bitmap_alloc();
+        if (hwloc_get_last_cpu_location(topology, last_cpuset, HWLOC_CPUBIND_PROCESS) == 0) {
+            package = get_package(last_cpuset);
+        }
+        hwloc_bitmap_free(last_cpuset);
+    }
+
+    return (package) ? static_cast<int>(package->logical_index) : CCL_HWLOC_INVALID_PACKAGE;
+}
+
 bool ccl_hwloc_wrapper::is_valid_numa_node(int numa_node) {
     if ((numa_node == CCL_UNDEFINED_NUMA_NODE) || (numa_node < 0)) {
         return false;
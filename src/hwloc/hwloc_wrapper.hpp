@@ -21,6 +21,7 @@
 #include <string>
 
 #define CCL_HWLOC_INVALID_NUMA_NODE (-1)
+#define CCL_HWLOC_INVALID_PACKAGE   (-1)
 
 struct ccl_numa_node {
     int os_idx;
@@ -55,6 +56,7 @@ public:
     void membind_thread(int numa_node);
     int get_numa_node_by_cpu(int cpu);
     ccl_numa_node get_numa_node(int numa_node);
+    int get_package_idx();
 
     void* alloc_memory(size_t alignment, size_t size, int numa_node_os_idx);
     void dealloc_memory(void* buffer);
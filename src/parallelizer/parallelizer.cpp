@@ -568,6 +568,7 @@ ccl::status ccl_parallelizer::process_base(ccl_sched* sched, bool update_sched_i
             for (idx = 0; idx < part_count; idx++) {
                 ccl_coll_param param{ false };
                 param.ctype = ccl_coll_allreduce;
+                param.hint_algo = coll_param.hint_algo;
                 param.send_buf = ccl_buffer(coll_param.get_send_buf_ptr(),
                                             coll_param.get_send_count() * dtype_size,
                                             offsets[idx],
@@ -16,6 +16,9 @@
 #include "common/global/global.hpp"
 #include "sched/buffer/buffer_cache.hpp"
 
+#include <sstream>
+#include <sys/mman.h>
+
 namespace ccl {
 
 buffer_cache::buffer_cache(size_t instance_count)
@@ -28,8 +31,12 @@ buffer_cache::buffer_cache(size_t instance_count)
 }
 
 buffer_cache::~buffer_cache() {
-    for (auto& instance : reg_buffers) {
-        instance.clear();
+    for (size_t idx = 0; idx < reg_buffers.size(); idx++) {
+        if (global_data::env().sched_profile) {
+            ccl_logger::get_instance().info(
+                "\nbuffer cache [", idx, "]: ", reg_buffers[idx].get_stats());
+        }
+        reg_buffers[idx].clear();
     }
 
 #ifdef CCL_ENABLE_SYCL
@@ -57,49 +64,139 @@ void buffer_cache::push(size_t idx, size_t bytes, const sycl::context& ctx, void
 }
 #endif // CCL_ENABLE_SYCL
 
+static constexpr int buffer_cache_tag_shift = 48;
+static constexpr uint64_t buffer_cache_ptr_mask = (1ULL << buffer_cache_tag_shift) - 1;
+
+regular_buffer_cache::regular_buffer_cache() {
+    for (auto& list : free_lists) {
+        list.store(0, std::memory_order_relaxed);
+    }
+}
+
 regular_buffer_cache::~regular_buffer_cache() {
-    if (!cache.empty()) {
-        LOG_WARN("buffer cache is not empty, size: ", cache.size());
+    if (resident_bytes.load()) {
+        LOG_WARN("buffer cache is not empty, resident bytes: ", resident_bytes.load());
         clear();
     }
 }
 
+size_t regular_buffer_cache::get_class_idx(size_t bytes) {
+    if (bytes <= (1UL << CCL_BUFFER_CACHE_MIN_CLASS_SHIFT)) {
+        return 0;
+    }
+
+    /* bytes is in (2^shift, 2^(shift + 1)] */
+    size_t shift = 63 - __builtin_clzl(bytes - 1);
+    size_t step_shift = shift - CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT;
+    size_t sub_idx = ((bytes - (1UL << shift)) + (1UL << step_shift) - 1) >> step_shift;
+
+    size_t class_idx =
+        ((shift - CCL_BUFFER_CACHE_MIN_CLASS_SHIFT) << CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT) +
+        sub_idx;
+    CCL_THROW_IF_NOT(class_idx < CCL_BUFFER_CACHE_CLASS_COUNT,
+                     "unexpected buffer size for buffer cache: ",
+                     bytes);
+    return class_idx;
+}
+
+size_t regular_buffer_cache::get_class_size(size_t class_idx) {
+    size_t split = 1UL << CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT;
+    size_t shift = (class_idx >> CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT) +
+                   CCL_BUFFER_CACHE_MIN_CLASS_SHIFT - CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT;
+    return (split + (class_idx & (split - 1))) << shift;
+}
+
+void* regular_buffer_cache::alloc_block(size_t class_size) {
+    void* ptr = CCL_MALLOC(class_size, "buffer");
+    if (class_size >= CCL_BUFFER_CACHE_HUGEPAGE_THRESHOLD) {
+        /* CCL_MALLOC aligns large buffers on 2MB, so the whole block can use huge pages */
+        if (madvise(ptr, class_size, MADV_HUGEPAGE)) {
+            LOG_DEBUG("madvise(MADV_HUGEPAGE) failed for ptr: ", ptr, ", bytes: ", class_size);
+        }
+    }
+    allocated_bytes += class_size;
+    return ptr;
+}
+
+void* regular_buffer_cache::pop_block(size_t class_idx) {
+    std::atomic<uint64_t>& list = free_lists[class_idx];
+    uint64_t head = list.load(std::memory_order_acquire);
+    while (true) {
+        void* ptr = reinterpret_cast<void*>(head & buffer_cache_ptr_mask);
+        if (!ptr) {
+            return nullptr;
+        }
+        /* blocks are not freed while cache is alive, stale next is rejected by tag */
+        void* next = __atomic_load_n(static_cast<void**>(ptr), __ATOMIC_RELAXED);
+        uint64_t new_head = (((head >> buffer_cache_tag_shift) + 1) << buffer_cache_tag_shift) |
+                            reinterpret_cast<uint64_t>(next);
+        if (list.compare_exchange_weak(
+                head, new_head, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return ptr;
+        }
+    }
+}
+
+void regular_buffer_cache::push_block(size_t class_idx, void* ptr) {
+    CCL_THROW_IF_NOT(!(reinterpret_cast<uint64_t>(ptr) & ~buffer_cache_ptr_mask),
+                     "unexpected pointer for buffer cache: ",
+                     ptr);
+    std::atomic<uint64_t>& list = free_lists[class_idx];
+    uint64_t head = list.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+        __atomic_store_n(static_cast<void**>(ptr),
+                         reinterpret_cast<void*>(head & buffer_cache_ptr_mask),
+                         __ATOMIC_RELAXED);
+        new_head = (((head >> buffer_cache_tag_shift) + 1) << buffer_cache_tag_shift) |
+                   reinterpret_cast<uint64_t>(ptr);
+    } while (!list.compare_exchange_weak(
+        head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
 void regular_buffer_cache::clear() {
-    std::lock_guard<buffer_cache::lock_t> lock{ guard };
-    LOG_DEBUG("clear buffer cache: size: ", cache.size());
-    for (auto& key_value : cache) {
-        CCL_FREE(key_value.second);
+    LOG_DEBUG("clear buffer cache: resident bytes: ", resident_bytes.load());
+    for (size_t class_idx = 0; class_idx < CCL_BUFFER_CACHE_CLASS_COUNT; class_idx++) {
+        void* ptr = nullptr;
+        while ((ptr = pop_block(class_idx))) {
+            resident_bytes -= get_class_size(class_idx);
+            CCL_FREE(ptr);
+        }
     }
-    cache.clear();
 }
 
 void regular_buffer_cache::get(size_t bytes, void** pptr) {
+    size_t alloc_bytes = bytes;
     if (global_data::env().enable_buffer_cache) {
-        std::lock_guard<buffer_cache::lock_t> lock{ guard };
-        key_t key(bytes);
-        auto key_value = cache.find(key);
-        if (key_value != cache.end()) {
-            *pptr = key_value->second;
-            cache.erase(key_value);
+        size_t class_idx = get_class_idx(bytes);
+        alloc_bytes = get_class_size(class_idx);
+        *pptr = pop_block(class_idx);
+        if (*pptr) {
+            resident_bytes -= alloc_bytes;
+            hit_count.fetch_add(1, std::memory_order_relaxed);
             LOG_DEBUG("loaded from buffer cache: bytes: ", bytes, ", ptr: ", *pptr);
             return;
         }
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        *pptr = alloc_block(alloc_bytes);
+    }
+    else {
+        *pptr = CCL_MALLOC(bytes, "buffer");
     }
-    *pptr = CCL_MALLOC(bytes, "buffer");
 #if defined(CCL_ENABLE_SYCL) && defined(CCL_ENABLE_ZE)
     if (global_data::get().ze_data &&
         global_data::get().ze_data->external_pointer_registration_enabled &&
         bytes < global_data::env().ze_pointer_registration_threshold) {
-        global_data::get().ze_data->import_external_pointer(*pptr, bytes);
+        global_data::get().ze_data->import_external_pointer(*pptr, alloc_bytes);
     }
 #endif // CCL_ENABLE_SYCL && CCL_ENABLE_ZE
 }
 
 void regular_buffer_cache::push(size_t bytes, void* ptr) {
     if (global_data::env().enable_buffer_cache) {
-        std::lock_guard<buffer_cache::lock_t> lock{ guard };
-        key_t key(bytes);
-        cache.insert({ std::move(key), ptr });
+        size_t class_idx = get_class_idx(bytes);
+        push_block(class_idx, ptr);
+        resident_bytes += get_class_size(class_idx);
         LOG_DEBUG("inserted to buffer cache: bytes: ", bytes, ", ptr: ", ptr);
         return;
     }
@@ -113,6 +210,19 @@ void regular_buffer_cache::push(size_t bytes, void* ptr) {
     CCL_FREE(ptr);
 }
 
+std::string regular_buffer_cache::get_stats() const {
+    size_t hits = hit_count.load(std::memory_order_relaxed);
+    size_t misses = miss_count.load(std::memory_order_relaxed);
+    size_t total = hits + misses;
+
+    std::stringstream ss;
+    ss << "hits: " << hits << ", misses: " << misses
+       << ", hit rate: " << (total ? (100.0 * hits / total) : 0.0) << "%"
+       << ", resident bytes: " << resident_bytes.load()
+       << ", allocated bytes: " << allocated_bytes.load();
+    return ss.str();
+}
+
 #ifdef CCL_ENABLE_SYCL
 sycl_buffer_cache::~sycl_buffer_cache() {
     if (!cache.empty()) {
@@ -15,6 +15,8 @@
 */
 #pragma once
 
+#include <atomic>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -58,9 +60,28 @@ private:
 #endif // CCL_ENABLE_SYCL
 };
 
+/* size classes: 4 geometric classes per power of two starting from 64 bytes */
+#define CCL_BUFFER_CACHE_MIN_CLASS_SHIFT   (6)
+#define CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT (2)
+#define CCL_BUFFER_CACHE_MAX_CLASS_SHIFT   (47)
+#define CCL_BUFFER_CACHE_CLASS_COUNT \
+    ((CCL_BUFFER_CACHE_MAX_CLASS_SHIFT - CCL_BUFFER_CACHE_MIN_CLASS_SHIFT) \
+     << CCL_BUFFER_CACHE_CLASS_SPLIT_SHIFT)
+
+/* blocks of this size and larger are advised to be backed by huge pages */
+#define CCL_BUFFER_CACHE_HUGEPAGE_THRESHOLD (2 * 1024 * 1024)
+
+/*
+   slab cache of host buffers, one instance per worker
+
+   requested sizes are rounded up to a size class, so close sizes share blocks,
+   each class has a lock-free free list which is linked through the blocks themselves,
+   blocks are allocated by the requesting worker thread, so they follow
+   its NUMA memory binding
+*/
 class regular_buffer_cache {
 public:
-    regular_buffer_cache() = default;
+    regular_buffer_cache();
     ~regular_buffer_cache();
     regular_buffer_cache(const regular_buffer_cache& other) = delete;
     regular_buffer_cache& operator=(const regular_buffer_cache& other) = delete;
@@ -69,12 +90,23 @@ public:
     void get(size_t bytes, void** pptr);
     void push(size_t bytes, void* ptr);
 
+    std::string get_stats() const;
+
+    static size_t get_class_idx(size_t bytes);
+    static size_t get_class_size(size_t class_idx);
+
 private:
-    buffer_cache::lock_t guard{};
+    void* alloc_block(size_t class_size);
+    void* pop_block(size_t class_idx);
+    void push_block(size_t class_idx, void* ptr);
 
-    using key_t = size_t;
-    using value_t = void*;
-    std::unordered_multimap<key_t, value_t> cache;
+    /* head of the free list, upper 16 bits keep ABA tag */
+    std::atomic<uint64_t> free_lists[CCL_BUFFER_CACHE_CLASS_COUNT];
+
+    std::atomic<size_t> hit_count{ 0 };
+    std::atomic<size_t> miss_count{ 0 };
+    std::atomic<size_t> resident_bytes{ 0 };
+    std::atomic<size_t> allocated_bytes{ 0 };
 };
 
 #ifdef CCL_ENABLE_SYCL
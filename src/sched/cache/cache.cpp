@@ -16,65 +16,305 @@
 #include "common/global/global.hpp"
 #include "sched/cache/cache.hpp"
 
-ccl_sched* ccl_sched_cache::find_unsafe(const ccl_sched_key& key) const {
-    ccl_sched* sched = nullptr;
-    {
-        auto it = table.find(key);
-        if (it != table.end()) {
-            sched = it->second;
+#include <algorithm>
+#include <sstream>
+
+ccl_sched_cache::bucket_array::bucket_array(size_t count)
+        : count(count),
+          buckets(new std::atomic<node*>[count]) {
+    for (size_t idx = 0; idx < count; idx++) {
+        buckets[idx].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ccl_sched_cache::node::node(ccl_sched_key&& key, size_t pool_size)
+        : key(std::move(key)),
+          pool_size(pool_size),
+          pool(new std::atomic<ccl_sched*>[pool_size]) {
+    for (size_t idx = 0; idx < pool_size; idx++) {
+        pool[idx].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ccl_sched_cache::ccl_sched_cache() : pool_size(ccl::global_data::env().sched_cache_pool_size) {
+    for (auto& s : shards) {
+        s.table.store(new bucket_array(CCL_SCHED_CACHE_INITIAL_BUCKET_COUNT),
+                      std::memory_order_release);
+    }
+}
+
+ccl_sched_cache::~ccl_sched_cache() {
+    size_t iter = 0;
+    static const size_t check_period = 1000;
+    while (!try_flush()) {
+        if (iter % check_period) {
+            LOG_DEBUG("can't destruct cache because reference_counter = ",
+                      get_reference_count(),
+                      ", expected 0");
+        }
+        iter++;
+    }
+
+    if (ccl::global_data::env().sched_profile) {
+        ccl_logger::get_instance().info(get_stats());
+    }
+
+    for (auto& s : shards) {
+        clear_unsafe(s, false);
+        delete s.table.load(std::memory_order_relaxed);
+    }
+}
+
+size_t ccl_sched_cache::get_hash(const ccl_sched_key& key) const {
+    /* key fingerprint is already well mixed, so shard and bucket indexes use its low bits */
+    return hasher(key);
+}
+
+ccl_sched_cache::shard& ccl_sched_cache::get_shard(size_t hash) {
+    return shards[hash % CCL_SCHED_CACHE_SHARD_COUNT];
+}
+
+ccl_sched_cache::shard& ccl_sched_cache::get_release_shard(const ccl_sched* sched) {
+    return shards[(reinterpret_cast<uintptr_t>(sched) / CACHELINE_SIZE) %
+                  CCL_SCHED_CACHE_SHARD_COUNT];
+}
+
+void ccl_sched_cache::lock_shard(shard& s) {
+    if (!s.guard.try_lock()) {
+        s.contention_count.fetch_add(1, std::memory_order_relaxed);
+        s.guard.lock();
+    }
+}
+
+ccl_sched_cache::node* ccl_sched_cache::find_node(const shard& s,
+                                                  const ccl_sched_key& key,
+                                                  size_t hash) const {
+    const bucket_array* table = s.table.load(std::memory_order_acquire);
+    size_t bucket_idx = (hash / CCL_SCHED_CACHE_SHARD_COUNT) % table->count;
+
+    /* chains can be relinked by grow_unsafe concurrently, a miss is rechecked under lock */
+    for (node* n = table->buckets[bucket_idx].load(std::memory_order_acquire); n;
+         n = n->next.load(std::memory_order_acquire)) {
+        if (n->key == key) {
+            return n;
         }
     }
 
+    return nullptr;
+}
+
+ccl_sched_cache::node* ccl_sched_cache::find(shard& s, const ccl_sched_key& key, size_t hash) {
+    /* pin the shard before traversal to not race with flush */
+    s.reference_counter.fetch_add(1);
+    if (s.flushing.load()) {
+        s.reference_counter.fetch_sub(1);
+        return nullptr;
+    }
+
+    node* n = find_node(s, key, hash);
+    if (!n) {
+        s.reference_counter.fetch_sub(1);
+        return nullptr;
+    }
+
 #ifdef ENABLE_DEBUG
-    if (sched && ccl::global_data::env().cache_key_type != ccl_cache_key_full) {
+    if (ccl::global_data::env().cache_key_type != ccl_cache_key_full) {
+        ccl_sched* sched = n->pool[0].load(std::memory_order_acquire);
         LOG_DEBUG("do sanity check for found sched ", sched);
         CCL_THROW_IF_NOT(key.check(sched->coll_param, sched->coll_attr));
         LOG_DEBUG("sanity check is passed for sched ", sched);
     }
 #endif
 
-    return sched;
+    return n;
 }
 
-void ccl_sched_cache::recache(const ccl_sched_key& old_key, ccl_sched_key&& new_key) {
-    {
-        std::lock_guard<sched_cache_lock_t> lock{ guard };
-        auto it = table.find(old_key);
-        if (it == table.end()) {
-            std::string error_message = "old_key wasn't found";
-            CCL_ASSERT(false, error_message, old_key.match_id);
-            throw ccl::exception(error_message + old_key.match_id);
+void ccl_sched_cache::insert_unsafe(shard& s, node* n, size_t hash) {
+    bucket_array* table = s.table.load(std::memory_order_relaxed);
+    if (s.size >= table->count * CCL_SCHED_CACHE_MAX_LOAD_FACTOR) {
+        grow_unsafe(s);
+        table = s.table.load(std::memory_order_relaxed);
+    }
+
+    size_t bucket_idx = (hash / CCL_SCHED_CACHE_SHARD_COUNT) % table->count;
+
+    n->next.store(table->buckets[bucket_idx].load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    /* publish fully constructed node to lock-free readers */
+    table->buckets[bucket_idx].store(n, std::memory_order_release);
+    s.size++;
+}
+
+void ccl_sched_cache::grow_unsafe(shard& s) {
+    bucket_array* old_table = s.table.load(std::memory_order_relaxed);
+    bucket_array* new_table = new bucket_array(old_table->count * 2);
+
+    /*
+       nodes are relinked in place, readers which traverse old chains
+       may see a partial chain and fall back to the locked path
+    */
+    for (size_t idx = 0; idx < old_table->count; idx++) {
+        node* n = old_table->buckets[idx].load(std::memory_order_relaxed);
+        while (n) {
+            node* next = n->next.load(std::memory_order_relaxed);
+            size_t bucket_idx =
+                (get_hash(n->key) / CCL_SCHED_CACHE_SHARD_COUNT) % new_table->count;
+            n->next.store(new_table->buckets[bucket_idx].load(std::memory_order_relaxed),
+                          std::memory_order_release);
+            new_table->buckets[bucket_idx].store(n, std::memory_order_relaxed);
+            n = next;
+        }
+    }
+
+    s.table.store(new_table, std::memory_order_release);
+    s.retired_tables.push_back(old_table);
+
+    LOG_DEBUG("grow shard bucket_count from ", old_table->count, " to ", new_table->count);
+}
+
+void ccl_sched_cache::clear_unsafe(shard& s, bool delete_scheds) {
+    bucket_array* table = s.table.load(std::memory_order_relaxed);
+    for (size_t idx = 0; idx < table->count; idx++) {
+        node* n = table->buckets[idx].load(std::memory_order_relaxed);
+        while (n) {
+            node* next = n->next.load(std::memory_order_relaxed);
+            if (delete_scheds) {
+                CCL_ASSERT(n->pool[0].load(std::memory_order_relaxed));
+                for (size_t pool_idx = 0; pool_idx < n->pool_size; pool_idx++) {
+                    ccl_sched* sched = n->pool[pool_idx].load(std::memory_order_relaxed);
+                    if (sched) {
+                        LOG_DEBUG("remove sched ", sched, " from cache");
+                        delete sched;
+                    }
+                }
+            }
+            delete n;
+            n = next;
         }
-        ccl_sched* sched = it->second;
-        table.erase(it);
-        auto emplace_result = table.emplace(std::move(new_key), sched);
-        CCL_THROW_IF_NOT(emplace_result.second);
+        table->buckets[idx].store(nullptr, std::memory_order_relaxed);
+    }
+    s.size = 0;
+
+    for (auto n : s.retired_nodes) {
+        delete n;
+    }
+    s.retired_nodes.clear();
+
+    for (auto t : s.retired_tables) {
+        delete t;
+    }
+    s.retired_tables.clear();
+}
+
+void ccl_sched_cache::recache(const ccl_sched_key& old_key, ccl_sched_key&& new_key) {
+    size_t old_hash = get_hash(old_key);
+    size_t new_hash = get_hash(new_key);
+    shard& old_shard = get_shard(old_hash);
+    shard& new_shard = get_shard(new_hash);
+
+    /* lock shards in address order to avoid deadlock with concurrent recache */
+    shard* first = std::min(&old_shard, &new_shard);
+    shard* second = std::max(&old_shard, &new_shard);
+    lock_shard(*first);
+    std::lock_guard<shard::lock_t> first_lock{ first->guard, std::adopt_lock };
+    std::unique_lock<shard::lock_t> second_lock;
+    if (second != first) {
+        lock_shard(*second);
+        second_lock = std::unique_lock<shard::lock_t>(second->guard, std::adopt_lock);
+    }
+
+    bucket_array* table = old_shard.table.load(std::memory_order_relaxed);
+    size_t bucket_idx = (old_hash / CCL_SCHED_CACHE_SHARD_COUNT) % table->count;
+
+    std::atomic<node*>* link = &table->buckets[bucket_idx];
+    node* n = link->load(std::memory_order_relaxed);
+    while (n && !(n->key == old_key)) {
+        link = &n->next;
+        n = link->load(std::memory_order_relaxed);
+    }
+
+    if (!n) {
+        std::string error_message = "old_key wasn't found";
+        CCL_ASSERT(false, error_message, old_key.match_id);
+        throw ccl::exception(error_message + old_key.match_id);
+    }
+
+    CCL_THROW_IF_NOT(!find_node(new_shard, new_key, new_hash), "new_key is already cached");
+
+    /* readers may still stay on the unlinked node, so retire it instead of deletion */
+    link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+    old_shard.size--;
+    old_shard.retired_nodes.push_back(n);
+
+    /* the retired node keeps the old key, instances move to the new node */
+    node* new_n = new node(std::move(new_key), n->pool_size);
+    for (size_t idx = 0; idx < n->pool_size; idx++) {
+        new_n->pool[idx].store(n->pool[idx].load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
     }
+    new_n->launch_count.store(n->launch_count.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+    insert_unsafe(new_shard, new_n, new_hash);
 }
 
 void ccl_sched_cache::release(ccl_sched* sched) {
-    reference_counter--;
+    get_release_shard(sched).reference_counter.fetch_sub(1);
     LOG_DEBUG("releasing sched to cache: ", sched);
-    LOG_TRACE("reference_counter=", reference_counter);
+    LOG_TRACE("reference_counter=", get_reference_count());
+}
+
+size_t ccl_sched_cache::get_reference_count() const {
+    size_t count = 0;
+    for (auto& s : shards) {
+        count += s.reference_counter.load();
+    }
+    return count;
 }
 
 bool ccl_sched_cache::try_flush() {
     if (!ccl::global_data::env().enable_cache_flush)
         return true;
 
-    std::lock_guard<sched_cache_lock_t> lock{ guard };
+    for (auto& s : shards) {
+        lock_shard(s);
+        s.flushing.store(true);
+    }
+
+    bool is_flushed = (get_reference_count() == 0);
 
-    if (reference_counter == 0) {
-        for (auto it = table.begin(); it != table.end(); ++it) {
-            ccl_sched* sched = it->second;
-            CCL_ASSERT(sched);
-            LOG_DEBUG("remove sched ", sched, " from cache");
-            delete sched;
+    for (auto& s : shards) {
+        if (is_flushed) {
+            clear_unsafe(s, true);
         }
-        table.clear();
-        return true;
+        s.flushing.store(false);
+        s.guard.unlock();
     }
-    else {
-        return false;
+
+    return is_flushed;
+}
+
+std::string ccl_sched_cache::get_stats() const {
+    size_t hit_count = 0, miss_count = 0, contention_count = 0, size = 0, bucket_count = 0;
+    size_t pool_hit_count = 0, pool_miss_count = 0;
+    size_t max_shard_size = 0;
+
+    for (auto& s : shards) {
+        hit_count += s.hit_count.load(std::memory_order_relaxed);
+        miss_count += s.miss_count.load(std::memory_order_relaxed);
+        contention_count += s.contention_count.load(std::memory_order_relaxed);
+        pool_hit_count += s.pool_hit_count.load(std::memory_order_relaxed);
+        pool_miss_count += s.pool_miss_count.load(std::memory_order_relaxed);
+        size += s.size;
+        bucket_count += s.table.load(std::memory_order_relaxed)->count;
+        max_shard_size = std::max(max_shard_size, s.size);
     }
+
+    std::stringstream ss;
+    ss << "\nsched cache: shards: " << CCL_SCHED_CACHE_SHARD_COUNT << ", size: " << size
+       << ", max shard size: " << max_shard_size << ", buckets: " << bucket_count
+       << "\n  hits: " << hit_count << ", misses: " << miss_count
+       << ", lock contention: " << contention_count << "\n  pool size: " << pool_size
+       << ", pool hits: " << pool_hit_count << ", pool misses: " << pool_miss_count
+       << "\n-----------------------------";
+    return ss.str();
 }
@@ -15,6 +15,7 @@
 */
 #pragma once
 
+#include "common/log/trace.hpp"
 #include "common/utils/spinlock.hpp"
 #include "sched/cache/key.hpp"
 #include "sched/sched.hpp"
@@ -22,63 +23,176 @@
 
 #include <atomic>
 #include <functional>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
-#define CCL_SCHED_CACHE_INITIAL_BUCKET_COUNT (4096)
+#define CCL_SCHED_CACHE_SHARD_COUNT          (64)
+#define CCL_SCHED_CACHE_INITIAL_BUCKET_COUNT (64) /* per shard */
+#define CCL_SCHED_CACHE_MAX_LOAD_FACTOR      (2)
+#define CCL_SCHED_CACHE_MAX_POOL_SIZE        (16) /* per key */
 
+/*
+   sharded hash table with lock-free lookups
+
+   - keys are distributed across shards by hash, each shard has its own lock
+     which is taken only to insert/recache/flush
+   - lookups traverse bucket chains without lock, nodes and bucket arrays which are
+     unlinked from the table are retired and deleted on flush only
+   - references to cached scheds are counted per shard, release may decrement a shard
+     which differs from the one incremented on lookup, only the sum over all shards is
+     meaningful (unsigned wraparound keeps it exact)
+   - flush excludes concurrent lookups through per-shard flushing flags:
+     lookup increments reference_counter and then checks flushing,
+     flush sets flushing and then checks reference_counter
+   - with use_pool each key keeps up to CCL_SCHED_CACHE_POOL_SIZE sched instances,
+     launches take instances round-robin by launch number, so instance creation
+     (and sched_id consumption) is the same on all ranks; a launch whose instance is
+     still executing is delayed by sched_restart_manager as without pool
+*/
 class ccl_sched_cache {
 public:
-    ccl_sched_cache() : reference_counter(0){};
-    ~ccl_sched_cache() {
-        size_t iter = 0;
-        static const size_t check_period = 1000;
-        while (!try_flush()) {
-            if (iter % check_period) {
-                LOG_DEBUG("can't destruct cache because reference_counter = ",
-                          reference_counter,
-                          ", expected 0");
-            }
-            iter++;
-        }
-    }
+    ccl_sched_cache();
+    ~ccl_sched_cache();
     ccl_sched_cache(const ccl_sched_cache& other) = delete;
     ccl_sched_cache& operator=(const ccl_sched_cache& other) = delete;
     template <class Lambda>
-    std::pair<ccl_sched*, bool> find_or_create(ccl_sched_key&& key, const Lambda& create_fn);
+    std::pair<ccl_sched*, bool> find_or_create(ccl_sched_key&& key,
+                                               const Lambda& create_fn,
+                                               bool use_pool = false);
     void recache(const ccl_sched_key& old_key, ccl_sched_key&& new_key);
     void release(ccl_sched* sched);
     bool try_flush();
 
+    std::string get_stats() const;
+
 private:
-    ccl_sched* find_unsafe(const ccl_sched_key& key) const;
-    using sched_cache_lock_t = ccl_spinlock;
-    mutable sched_cache_lock_t guard{}; //could be changed in constant method
-    //TODO use smart ptr for ccl_master_sched in table
-    using sched_table_t = std::unordered_map<ccl_sched_key, ccl_sched*, ccl_sched_key_hasher>;
-    sched_table_t table{ CCL_SCHED_CACHE_INITIAL_BUCKET_COUNT };
-    std::atomic<size_t> reference_counter;
+    struct node {
+        node(ccl_sched_key&& key, size_t pool_size);
+        ccl_sched_key key;
+        /* instance 0 is created together with the node, others on demand */
+        size_t pool_size;
+        std::unique_ptr<std::atomic<ccl_sched*>[]> pool;
+        std::atomic<size_t> launch_count{ 0 };
+        std::atomic<node*> next{ nullptr };
+    };
+
+    struct bucket_array {
+        explicit bucket_array(size_t count);
+        size_t count;
+        std::unique_ptr<std::atomic<node*>[]> buckets;
+    };
+
+    struct alignas(CACHELINE_SIZE) shard {
+        using lock_t = ccl_spinlock;
+        lock_t guard{};
+        std::atomic<bool> flushing{ false };
+        std::atomic<size_t> reference_counter{ 0 };
+        std::atomic<size_t> hit_count{ 0 };
+        std::atomic<size_t> miss_count{ 0 };
+        std::atomic<size_t> contention_count{ 0 };
+        std::atomic<size_t> pool_hit_count{ 0 };
+        std::atomic<size_t> pool_miss_count{ 0 };
+        std::atomic<bucket_array*> table{ nullptr };
+
+        /* below fields are protected by guard */
+        size_t size = 0;
+        std::vector<node*> retired_nodes;
+        std::vector<bucket_array*> retired_tables;
+    };
+
+    size_t get_hash(const ccl_sched_key& key) const;
+    shard& get_shard(size_t hash);
+    shard& get_release_shard(const ccl_sched* sched);
+    void lock_shard(shard& s);
+
+    node* find_node(const shard& s, const ccl_sched_key& key, size_t hash) const;
+    node* find(shard& s, const ccl_sched_key& key, size_t hash);
+    void insert_unsafe(shard& s, node* n, size_t hash);
+    template <class Lambda>
+    ccl_sched* get_pool_instance(shard& s, node* n, const Lambda& create_fn, bool& is_created);
+    void grow_unsafe(shard& s);
+    void clear_unsafe(shard& s, bool delete_scheds);
+    size_t get_reference_count() const;
+
+    ccl_sched_key_hasher hasher{};
+    size_t pool_size;
+    shard shards[CCL_SCHED_CACHE_SHARD_COUNT];
 };
 
+template <class Lambda>
+ccl_sched* ccl_sched_cache::get_pool_instance(shard& s,
+                                              node* n,
+                                              const Lambda& create_fn,
+                                              bool& is_created) {
+    if (n->pool_size == 1) {
+        return n->pool[0].load(std::memory_order_acquire);
+    }
+
+    size_t idx = n->launch_count.fetch_add(1, std::memory_order_relaxed) % n->pool_size;
+    ccl_sched* sched = n->pool[idx].load(std::memory_order_acquire);
+    if (sched) {
+        s.pool_hit_count.fetch_add(1, std::memory_order_relaxed);
+        return sched;
+    }
+
+    lock_shard(s);
+    std::lock_guard<shard::lock_t> lock{ s.guard, std::adopt_lock };
+
+    sched = n->pool[idx].load(std::memory_order_relaxed);
+    if (!sched) {
+        sched = create_fn();
+        n->pool[idx].store(sched, std::memory_order_release);
+        is_created = true;
+        s.pool_miss_count.fetch_add(1, std::memory_order_relaxed);
+        LOG_DEBUG("created pool instance ", idx, " of ", n->pool_size, ": ", sched);
+    }
+    else {
+        s.pool_hit_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return sched;
+}
+
 template <class Lambda>
 /// create_fn lmbda is NOT copied internally or used after function exit
 std::pair<ccl_sched*, bool> ccl_sched_cache::find_or_create(ccl_sched_key&& key,
-                                                            const Lambda& create_fn) {
-    ccl_sched* sched = nullptr;
-
+                                                            const Lambda& create_fn,
+                                                            bool use_pool) {
+    size_t hash = get_hash(key);
+    shard& s = get_shard(hash);
     bool is_created = false;
-    {
-        std::lock_guard<sched_cache_lock_t> lock{ guard };
-        sched = find_unsafe(key);
-        if (sched) {
-#ifdef CCL_ENABLE_ITT
-            __itt_event sched_cached_event = ccl::profile::itt::event_get("SCHED_CACHED");
-            ccl::profile::itt::event_start(sched_cached_event);
-#endif // CCL_ENABLE_ITT
-            reference_counter++;
+
+    /* fast path, no lock */
+    node* n = find(s, key, hash);
+    if (n) {
 #ifdef CCL_ENABLE_ITT
-            ccl::profile::itt::event_end(sched_cached_event);
+        __itt_event sched_cached_event = ccl::profile::itt::event_get("SCHED_CACHED");
+        ccl::profile::itt::event_start(sched_cached_event);
+        ccl::profile::itt::event_end(sched_cached_event);
 #endif // CCL_ENABLE_ITT
+        s.hit_count.fetch_add(1, std::memory_order_relaxed);
+        ccl_sched* sched = get_pool_instance(s, n, create_fn, is_created);
+        CCL_TRACE(cache_hit, sched, ccl_coll_type_to_str(sched->coll_param.ctype), is_created);
+        return std::make_pair(sched, is_created);
+    }
+
+    ccl_sched* sched = nullptr;
+    {
+        lock_shard(s);
+        std::unique_lock<shard::lock_t> lock{ s.guard, std::adopt_lock };
+
+        /* another thread could insert the same key before we took the lock */
+        n = find_node(s, key, hash);
+        if (n) {
+            s.reference_counter.fetch_add(1);
+            s.hit_count.fetch_add(1, std::memory_order_relaxed);
+            lock.unlock();
+            sched = get_pool_instance(s, n, create_fn, is_created);
+            CCL_TRACE(
+                cache_hit, sched, ccl_coll_type_to_str(sched->coll_param.ctype), is_created);
         }
         else {
 #ifdef CCL_ENABLE_ITT
@@ -87,26 +201,24 @@ std::pair<ccl_sched*, bool> ccl_sched_cache::find_or_create(ccl_sched_key&& key,
 #endif // CCL_ENABLE_ITT
             LOG_DEBUG("didn't find sched in cache, the new one will be created");
             sched = create_fn();
-            {
-                reference_counter++;
-                auto emplace_result = table.emplace(std::move(key), sched);
-                CCL_ASSERT(emplace_result.second);
-            }
+            s.reference_counter.fetch_add(1);
+            n = new node(std::move(key), (use_pool) ? pool_size : 1);
+            n->pool[0].store(sched, std::memory_order_relaxed);
+            /* the current launch takes instance 0 */
+            n->launch_count.store(1, std::memory_order_relaxed);
+            insert_unsafe(s, n, hash);
             is_created = true;
+            s.miss_count.fetch_add(1, std::memory_order_relaxed);
+            CCL_TRACE(cache_miss, sched, ccl_coll_type_to_str(sched->coll_param.ctype));
 
-            LOG_DEBUG("size ",
-                      table.size(),
+            LOG_DEBUG("shard size ",
+                      s.size,
                       ", bucket_count ",
-                      table.bucket_count(),
-                      ", load_factor ",
-                      table.load_factor(),
-                      ", max_load_factor ",
-                      table.max_load_factor());
+                      s.table.load(std::memory_order_relaxed)->count);
 #ifdef CCL_ENABLE_ITT
             ccl::profile::itt::event_end(sched_new_event);
 #endif // CCL_ENABLE_ITT
         }
     }
-    LOG_TRACE("reference_counter=", reference_counter);
     return std::make_pair(sched, is_created);
 }
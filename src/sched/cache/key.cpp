@@ -19,7 +19,6 @@
 #include "common/utils/enums.hpp"
 
 #include <cstring>
-#include <numeric>
 
 std::map<ccl_cache_key_type, std::string> ccl_sched_key::key_type_names = {
     std::make_pair(ccl_cache_key_full, "full"),
@@ -36,6 +35,11 @@ void ccl_sched_key::set(const ccl_coll_param& param, const ccl_coll_attr& attr)
         memset((void*)&f, 0, sizeof(ccl_sched_key_inner_fields));
     }
 
+    has_fingerprint = false;
+    vec_hash = {};
+    vec1.clear();
+    vec2.clear();
+
     f.reduction_fn = attr.reduction_fn;
     match_id = attr.match_id;
 
@@ -47,7 +51,7 @@ void ccl_sched_key::set(const ccl_coll_param& param, const ccl_coll_attr& attr)
         case ccl_coll_allgather: f.count1 = param.get_send_count(); break;
         case ccl_coll_allgatherv:
             f.count1 = param.get_send_count();
-            vec1 = param.recv_counts;
+            set_vecs(param.recv_counts, {});
             break;
         case ccl_coll_allreduce:
             f.count1 = param.get_send_count();
@@ -55,8 +59,7 @@ void ccl_sched_key::set(const ccl_coll_param& param, const ccl_coll_attr& attr)
             break;
         case ccl_coll_alltoall: f.count1 = param.get_send_count(); break;
         case ccl_coll_alltoallv:
-            vec1 = param.send_counts;
-            vec2 = param.recv_counts;
+            set_vecs(param.send_counts, param.recv_counts);
             break;
         case ccl_coll_barrier: break;
         case ccl_coll_bcast:
@@ -87,6 +90,44 @@ void ccl_sched_key::set(const ccl_coll_param& param, const ccl_coll_attr& attr)
     }
 }
 
+ccl::utils::hash128_value ccl_sched_key::hash_vecs(const std::vector<size_t>& v1,
+                                                   const std::vector<size_t>& v2) {
+    ccl::utils::hash128 hasher;
+    hasher.update(v1.size());
+    hasher.update(v1.data(), v1.size() * sizeof(size_t));
+    hasher.update(v2.size());
+    hasher.update(v2.data(), v2.size() * sizeof(size_t));
+    return hasher.digest();
+}
+
+void ccl_sched_key::set_vecs(const std::vector<size_t>& v1, const std::vector<size_t>& v2) {
+#ifdef ENABLE_DEBUG
+    vec1 = v1;
+    vec2 = v2;
+#endif // ENABLE_DEBUG
+
+    vec_hash = hash_vecs(v1, v2);
+}
+
+const ccl::utils::hash128_value& ccl_sched_key::get_fingerprint() const {
+    if (has_fingerprint)
+        return fingerprint;
+
+    ccl::utils::hash128 hasher;
+    hasher.update(match_id.data(), match_id.size());
+    if (ccl::global_data::env().cache_key_type == ccl_cache_key_full) {
+        hasher.update(&f, sizeof(ccl_sched_key_inner_fields));
+        hasher.update(vec_hash.lo);
+        hasher.update(vec_hash.hi);
+    }
+    fingerprint = hasher.digest();
+    has_fingerprint = true;
+
+    LOG_DEBUG("fingerprint ", fingerprint.hi, ":", fingerprint.lo);
+
+    return fingerprint;
+}
+
 bool ccl_sched_key::check(const ccl_coll_param& param, const ccl_coll_attr& attr) const {
     bool result = true;
 
@@ -96,14 +137,15 @@ bool ccl_sched_key::check(const ccl_coll_param& param, const ccl_coll_attr& attr
     switch (f.ctype) {
         case ccl_coll_allgather: result &= (param.get_send_count() == f.count1); break;
         case ccl_coll_allgatherv:
-            result &= (param.get_send_count() == f.count1 && param.recv_counts == vec1);
+            result &= (param.get_send_count() == f.count1 &&
+                       hash_vecs(param.recv_counts, {}) == vec_hash);
             break;
         case ccl_coll_allreduce:
             result &= (param.get_send_count() == f.count1 && param.reduction == f.reduction);
             break;
         case ccl_coll_alltoall: result &= (param.get_send_count() == f.count1); break;
         case ccl_coll_alltoallv:
-            result &= (param.send_counts == vec1 && param.recv_counts == vec2);
+            result &= (hash_vecs(param.send_counts, param.recv_counts) == vec_hash);
             break;
         case ccl_coll_barrier: break;
         case ccl_coll_bcast:
@@ -132,11 +174,16 @@ bool ccl_sched_key::check(const ccl_coll_param& param, const ccl_coll_attr& attr
 }
 
 bool ccl_sched_key::operator==(const ccl_sched_key& k) const {
+    /* different fingerprints mean different keys, no need to look at fields */
+    if (get_fingerprint() != k.get_fingerprint())
+        return false;
+
     bool are_fields_equal = 1;
     if (ccl::global_data::env().cache_key_type == ccl_cache_key_full) {
         are_fields_equal = !memcmp(&f, &(k.f), sizeof(ccl_sched_key_inner_fields));
-        are_fields_equal &= (vec1 == k.vec1) ? 1 : 0;
-        are_fields_equal &= (vec2 == k.vec2) ? 1 : 0;
+        /* count vectors are represented by their hash which is part of the fingerprint */
+        CCL_ASSERT(!are_fields_equal || (vec1 == k.vec1 && vec2 == k.vec2),
+                   "count vectors differ for equal fingerprints");
     }
 
     bool are_keys_equal = are_fields_equal && !match_id.compare(k.match_id);
@@ -169,34 +216,10 @@ void ccl_sched_key::print() const {
               f.comm,
               ", reduction_fn ",
               (void*)f.reduction_fn,
-              ", vec1.size ",
-              vec1.size(),
-              ", vec2.size ",
-              vec2.size(),
+              ", vec_hash ",
+              vec_hash.hi,
+              ":",
+              vec_hash.lo,
               ", match_id ",
               match_id);
 }
-
-size_t ccl_sched_key_hasher::operator()(const ccl_sched_key& k) const {
-    if (k.has_hasher_result)
-        return k.get_hasher_result();
-
-    size_t hash_value = string_hasher(k.match_id);
-    if (ccl::global_data::env().cache_key_type == ccl_cache_key_full) {
-        /* TODO: improve hashing for vec fields to reduce probability of collisions
-           e.g. sum(a[idx]*(idx+1)) */
-        size_t vec1_sum = std::accumulate(k.vec1.begin(), k.vec1.end(), size_t(0));
-        size_t vec2_sum = std::accumulate(k.vec2.begin(), k.vec2.end(), size_t(0));
-        hash_value += k.f.ctype + ccl::utils::enum_to_underlying(k.f.dtype) +
-                      ccl::utils::enum_to_underlying(k.f.reduction) + k.f.count1 + k.f.count2 +
-                      k.f.root + (size_t)k.f.buf1 + (size_t)k.f.buf2 + (size_t)k.f.comm +
-                      (size_t)k.f.reduction_fn + vec1_sum + vec2_sum;
-    }
-
-    const_cast<ccl_sched_key&>(k).set_hasher_result(hash_value);
-
-    LOG_DEBUG("hash_value ", hash_value);
-    k.print();
-
-    return hash_value;
-}
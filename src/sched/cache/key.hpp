@@ -16,6 +16,7 @@
 #pragma once
 
 #include "coll/coll.hpp"
+#include "common/utils/hash.hpp"
 #include "comp/comp.hpp"
 
 #include <map>
@@ -31,10 +32,15 @@ enum ccl_cache_key_type {
 
 const char* ccl_cache_key_type_to_str(ccl_cache_key_type type);
 
-class ccl_sched_key {
-private:
-    size_t hasher_result = 0;
+/*
+   key: bit comparable fields, match_id, hash of count vectors and a 128-bit fingerprint
 
+   set() hashes count vectors in a single pass without copying them, the fingerprint
+   is computed once on first use, keys are compared by fingerprint, fields and match_id,
+   so lookup cost doesn't depend on comm size except for the hashing in set(),
+   count vectors themselves are kept and compared in debug build only
+*/
+class ccl_sched_key {
 public:
     ccl_sched_key() = default;
     ~ccl_sched_key() = default;
@@ -45,16 +51,8 @@ public:
     void set(const ccl_coll_param& param, const ccl_coll_attr& attr);
     bool check(const ccl_coll_param& param, const ccl_coll_attr& attr) const;
 
-    size_t get_hasher_result() const {
-        return hasher_result;
-    }
-
-    void set_hasher_result(size_t value) {
-        has_hasher_result = true;
-        hasher_result = value;
-    }
-
-    bool has_hasher_result = false;
+    /* fields must not be changed after the first call */
+    const ccl::utils::hash128_value& get_fingerprint() const;
 
     struct ccl_sched_key_inner_fields {
         ccl_coll_type ctype = ccl_coll_undefined;
@@ -74,6 +72,7 @@ public:
     /* inner structure for bit comparison */
     ccl_sched_key_inner_fields f;
 
+    /* filled in debug build only */
     std::vector<size_t> vec1;
     std::vector<size_t> vec2;
 
@@ -84,12 +83,23 @@ public:
     void print() const;
 
     static std::map<ccl_cache_key_type, std::string> key_type_names;
+
+private:
+    void set_vecs(const std::vector<size_t>& v1, const std::vector<size_t>& v2);
+
+    static ccl::utils::hash128_value hash_vecs(const std::vector<size_t>& v1,
+                                               const std::vector<size_t>& v2);
+
+    /* hash of count vectors, filled by set() */
+    ccl::utils::hash128_value vec_hash{};
+
+    mutable ccl::utils::hash128_value fingerprint{};
+    mutable bool has_fingerprint = false;
 };
 
 class ccl_sched_key_hasher {
 public:
-    size_t operator()(const ccl_sched_key& k) const;
-
-private:
-    std::hash<std::string> string_hasher{};
+    size_t operator()(const ccl_sched_key& k) const {
+        return k.get_fingerprint().lo;
+    }
 };
@@ -0,0 +1,99 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <vector>
+
+#include "common/global/global.hpp"
+#include "comp/comp.hpp"
+#include "sched/entry/entry.hpp"
+
+/*
+   reduces inputs located at in_buf + offsets[1..n] into inout_buf in a single pass,
+   bf16/fp16 intermediate values are kept in fp32 and rounded once
+*/
+class batch_reduce_local_entry final : public sched_entry {
+public:
+    static constexpr const char* class_name() noexcept {
+        return "BATCH_REDUCE_LOCAL";
+    }
+
+    const char* name() const override {
+        return class_name();
+    }
+
+    batch_reduce_local_entry() = delete;
+    batch_reduce_local_entry(ccl_sched* sched,
+                             ccl_buffer in_buf,
+                             const std::vector<size_t>& offsets,
+                             size_t in_cnt,
+                             ccl_buffer inout_buf,
+                             const ccl_datatype& dtype,
+                             ccl::reduction op)
+            : sched_entry(sched),
+              in_buf(in_buf),
+              offsets(offsets),
+              in_cnt(in_cnt),
+              inout_buf(inout_buf),
+              dtype(dtype),
+              op(op) {
+        CCL_THROW_IF_NOT(op != ccl::reduction::custom,
+                         "custom reduction is not supported by batch reduction");
+    }
+
+    void start() override {
+        size_t bytes = in_cnt * dtype.size();
+        size_t in_bytes = (offsets.empty() ? 0 : offsets.back()) * dtype.size() + bytes;
+        ccl::status comp_status = ccl_comp_batch_reduce(in_buf.get_ptr(in_bytes),
+                                                        offsets,
+                                                        in_cnt,
+                                                        inout_buf.get_ptr(bytes),
+                                                        nullptr,
+                                                        dtype,
+                                                        op,
+                                                        nullptr,
+                                                        nullptr,
+                                                        1 /* keep_precision_mode */);
+        CCL_ASSERT(comp_status == ccl::status::success, "bad status ", comp_status);
+        status = ccl_sched_entry_status_complete;
+    }
+
+protected:
+    void dump_detail(std::stringstream& str) const override {
+        ccl_logger::format(str,
+                           "dt ",
+                           ccl::global_data::get().dtypes->name(dtype),
+                           ", in_buf ",
+                           in_buf,
+                           ", in_bufs ",
+                           offsets.size() - 1,
+                           ", in_cnt ",
+                           in_cnt,
+                           ", inout_buf ",
+                           inout_buf,
+                           ", op ",
+                           ccl_reduction_to_str(op),
+                           "\n");
+    }
+
+private:
+    ccl_buffer in_buf;
+    std::vector<size_t> offsets;
+    size_t in_cnt;
+    ccl_buffer inout_buf;
+    ccl_datatype dtype;
+    ccl::reduction op;
+};
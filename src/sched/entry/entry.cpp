@@ -15,6 +15,7 @@
 */
 #include "common/global/global.hpp"
 #include "common/log/log.hpp"
+#include "common/log/trace.hpp"
 #include "sched/entry/entry.hpp"
 #include "sched/sched.hpp"
 
@@ -62,6 +63,7 @@ void sched_entry::do_progress() {
         ccl::profile::itt::event_start(this->itt_event);
 #endif // CCL_ENABLE_ITT
 
+        CCL_TRACE(entry_start, this, trace_name());
         start();
         CCL_THROW_IF_NOT(status >= ccl_sched_entry_status_again,
                          "bad status ",
@@ -110,6 +112,8 @@ void sched_entry::do_progress() {
         ccl::profile::itt::event_end(this->itt_event);
 #endif // CCL_ENABLE_ITT
 
+        CCL_TRACE(entry_complete, this, trace_name());
+
         if (use_total_timer) {
             total_timer.update();
         }
@@ -197,6 +201,15 @@ bool sched_entry::is_barrier() const {
     return barrier;
 }
 
+void sched_entry::add_dependency(sched_entry* entry) {
+    CCL_THROW_IF_NOT(entry && entry != this, "unexpected dependency for entry ", name());
+    dependencies.push_back(entry);
+}
+
+const std::vector<sched_entry*>& sched_entry::get_dependencies() const {
+    return dependencies;
+}
+
 bool sched_entry::is_coll() const {
     return coll;
 }
@@ -23,6 +23,7 @@
 #include "internal_types.hpp"
 
 #include <memory>
+#include <vector>
 
 #if defined(CCL_ENABLE_ZE) && defined(CCL_ENABLE_SYCL)
 #include "sched/entry/ze/ze_command.hpp"
@@ -74,6 +75,8 @@ public:
 
     void make_barrier();
     bool is_barrier() const;
+    void add_dependency(sched_entry* entry);
+    const std::vector<sched_entry*>& get_dependencies() const;
     bool is_coll() const;
     bool is_deps() const;
     ccl_sched_entry_status get_status() const;
@@ -82,6 +85,10 @@ public:
 
     virtual const char* name() const = 0;
     virtual std::string name_ext() const;
+    /* recorded into trace events, must point to static storage */
+    virtual const char* trace_name() const {
+        return name();
+    }
 
     static const char* status_to_str(ccl_sched_entry_status status);
 
@@ -113,6 +120,8 @@ protected:
     size_t start_idx = 0;
     ccl_sched_entry_status status = ccl_sched_entry_status_not_started;
     ccl_sched_entry_exec_mode exec_mode = ccl_sched_entry_exec_regular;
+    /* entries of the same sched which have to be completed before this one is started */
+    std::vector<sched_entry*> dependencies;
 
     bool use_total_timer = false;
     bool detect_update_time_expiration = false;
@@ -0,0 +1,68 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#include <algorithm>
+
+#include "common/log/log.hpp"
+#include "common/utils/utils.hpp"
+#include "sched/entry/entry.hpp"
+#include "sched/entry/entry_arena.hpp"
+
+ccl_sched_entry_arena::~ccl_sched_entry_arena() {
+    for (auto& b : blocks) {
+        CCL_FREE(b.data);
+    }
+    blocks.clear();
+}
+
+void* ccl_sched_entry_arena::alloc(size_t size, size_t alignment) {
+    CCL_THROW_IF_NOT(alignment && !(alignment & (alignment - 1)),
+                     "unexpected entry alignment ",
+                     alignment);
+
+    if (!blocks.empty()) {
+        auto& b = blocks.back();
+        size_t offset = (b.offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= b.size) {
+            b.offset = offset + size;
+            return b.data + offset;
+        }
+    }
+
+    /* blocks grow geometrically, so large schedules need only a few of them */
+    size_t block_size =
+        blocks.empty() ? min_block_size : std::min(blocks.back().size * 2, max_block_size);
+    block_size = std::max(block_size, size);
+
+    block b;
+    b.data = static_cast<char*>(CCL_MEMALIGN(
+        block_size, std::max(alignment, static_cast<size_t>(CACHELINE_SIZE)), "entry_arena"));
+    b.size = block_size;
+    b.offset = size;
+    blocks.push_back(b);
+
+    LOG_DEBUG("entry arena: allocated block ", blocks.size(), ", size ", block_size);
+
+    return b.data;
+}
+
+void sched_entry_deleter::operator()(sched_entry* entry) const {
+    if (is_arena) {
+        entry->~sched_entry();
+    }
+    else {
+        delete entry;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class sched_entry;
+
+/*
+   bump allocator for entries of a single sched,
+   entries are placed contiguously in creation order and memory is released in bulk with the sched
+*/
+class ccl_sched_entry_arena {
+public:
+    ccl_sched_entry_arena() = default;
+    ~ccl_sched_entry_arena();
+
+    ccl_sched_entry_arena(const ccl_sched_entry_arena&) = delete;
+    ccl_sched_entry_arena& operator=(const ccl_sched_entry_arena&) = delete;
+
+    void* alloc(size_t size, size_t alignment);
+
+    size_t get_block_count() const {
+        return blocks.size();
+    }
+
+private:
+    struct block {
+        char* data;
+        size_t size;
+        size_t offset;
+    };
+
+    static constexpr size_t min_block_size = 4096;
+    static constexpr size_t max_block_size = 256 * 1024;
+
+    std::vector<block> blocks;
+};
+
+/*
+   destroys entry placed in the arena without releasing its memory,
+   entries allocated by new are deleted as usual
+*/
+struct sched_entry_deleter {
+    sched_entry_deleter() = default;
+    explicit sched_entry_deleter(bool is_arena) : is_arena(is_arena) {}
+
+    template <class EntryType>
+    sched_entry_deleter(const std::default_delete<EntryType>&) {}
+
+    void operator()(sched_entry* entry) const;
+
+    bool is_arena = false;
+};
@@ -27,6 +27,7 @@
 
 #include "sched/entry/factory/entry_factory.h"
 
+#include "sched/entry/batch_reduce_local_entry.hpp"
 #include "sched/entry/copy/copy_entry.hpp"
 #include "sched/entry/deps_entry.hpp"
 #include "sched/entry/deregister_entry.hpp"
@@ -37,7 +38,9 @@
 #include "sched/entry/recv_reduce_entry.hpp"
 #include "sched/entry/reduce_local_entry.hpp"
 #include "sched/entry/register_entry.hpp"
+#include "sched/entry/scale_entry.hpp"
 #include "sched/entry/send_entry.hpp"
+#include "sched/entry/shm_barrier_entry.hpp"
 #include "sched/entry/subsched_entry.hpp"
 #include "sched/entry/sync_entry.hpp"
 #include "sched/entry/wait_value_entry.hpp"
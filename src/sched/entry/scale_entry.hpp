@@ -0,0 +1,71 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include "common/global/global.hpp"
+#include "comp/comp.hpp"
+#include "sched/entry/entry.hpp"
+
+/* divides elements of the buffer in place, used to finalize average reduction */
+class scale_entry final : public sched_entry {
+public:
+    static constexpr const char* class_name() noexcept {
+        return "SCALE";
+    }
+
+    const char* name() const override {
+        return class_name();
+    }
+
+    scale_entry() = delete;
+    scale_entry(ccl_sched* sched,
+                ccl_buffer buf,
+                size_t cnt,
+                const ccl_datatype& dtype,
+                size_t divisor)
+            : sched_entry(sched),
+              buf(buf),
+              cnt(cnt),
+              dtype(dtype),
+              divisor(divisor) {}
+
+    void start() override {
+        size_t bytes = cnt * dtype.size();
+        ccl::status comp_status = ccl_comp_scale(buf.get_ptr(bytes), cnt, dtype, divisor);
+        CCL_ASSERT(comp_status == ccl::status::success, "bad status ", comp_status);
+        status = ccl_sched_entry_status_complete;
+    }
+
+protected:
+    void dump_detail(std::stringstream& str) const override {
+        ccl_logger::format(str,
+                           "dt ",
+                           ccl::global_data::get().dtypes->name(dtype),
+                           ", buf ",
+                           buf,
+                           ", cnt ",
+                           cnt,
+                           ", divisor ",
+                           divisor,
+                           "\n");
+    }
+
+private:
+    ccl_buffer buf;
+    size_t cnt;
+    ccl_datatype dtype;
+    size_t divisor;
+};
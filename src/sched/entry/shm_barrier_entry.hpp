@@ -0,0 +1,102 @@
+/*
+ Copyright 2016-2020 Intel Corporation
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+     http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+#pragma once
+
+#include "comm/shm_barrier.hpp"
+#include "sched/entry/entry.hpp"
+
+#include <memory>
+
+enum class shm_barrier_phase { gather, release };
+
+/*
+   non-leader ranks complete gather right after arrival and wait in release,
+   leader waits in gather and completes release right after it,
+   so leader can sync with other nodes between the phases
+*/
+class shm_barrier_entry : public sched_entry {
+public:
+    static constexpr const char* class_name() noexcept {
+        return "SHM_BARRIER";
+    }
+
+    shm_barrier_entry() = delete;
+    shm_barrier_entry(ccl_sched* sched,
+                      std::shared_ptr<ccl_shm_barrier> barrier,
+                      shm_barrier_phase phase,
+                      const shm_barrier_entry* gather_entry = nullptr)
+            : sched_entry(sched),
+              barrier(barrier),
+              phase(phase),
+              gather_entry(gather_entry) {
+        CCL_THROW_IF_NOT(barrier, "no shm barrier");
+        CCL_THROW_IF_NOT((phase == shm_barrier_phase::gather) == !gather_entry,
+                         "release phase requires gather entry");
+    }
+
+    void start() override {
+        if (phase == shm_barrier_phase::gather) {
+            generation = barrier->next_generation();
+            if (!barrier->is_leader()) {
+                barrier->arrive(generation);
+            }
+        }
+        else {
+            /* both phases of the barrier instance use the same generation */
+            generation = gather_entry->get_generation();
+            if (barrier->is_leader()) {
+                barrier->release(generation);
+            }
+        }
+        status = ccl_sched_entry_status_started;
+        update();
+    }
+
+    void update() override {
+        bool is_done = (phase == shm_barrier_phase::gather)
+                           ? (!barrier->is_leader() || barrier->is_arrived(generation))
+                           : (barrier->is_leader() || barrier->is_released(generation));
+        if (is_done) {
+            status = ccl_sched_entry_status_complete;
+        }
+    }
+
+    uint64_t get_generation() const {
+        return generation;
+    }
+
+    const char* name() const override {
+        return class_name();
+    }
+
+protected:
+    void dump_detail(std::stringstream& str) const override {
+        ccl_logger::format(str,
+                           "phase ",
+                           (phase == shm_barrier_phase::gather) ? "gather" : "release",
+                           ", generation ",
+                           generation,
+                           ", barrier ",
+                           barrier->to_string(),
+                           "\n");
+    }
+
+private:
+    std::shared_ptr<ccl_shm_barrier> barrier;
+    shm_barrier_phase phase;
+    const shm_barrier_entry* gather_entry;
+    uint64_t generation = 0;
+};
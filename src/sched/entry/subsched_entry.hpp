@@ -167,6 +167,10 @@ public:
         return !subsched_name.empty() ? subsched_name.c_str() : class_name();
     }
 
+    const char* trace_name() const override {
+        return class_name();
+    }
+
     ccl_sched* get_subsched() {
         build_subsched({ build_sched_id, sched->coll_param });
         return subsched.get();
@@ -13,11 +13,16 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
 #include "coll/coll_check.hpp"
 #include "coll/coll_util.hpp"
 #include "coll/selection/selection.hpp"
 #include "common/global/global.hpp"
 #include "common/log/log.hpp"
+#include "common/log/trace.hpp"
 #include "common/request/request.hpp"
 #include "common/utils/sync_object.hpp"
 #include "parallelizer/parallelizer.hpp"
@@ -216,6 +221,7 @@ ccl_request* ccl_sched::start(ccl_executor* exec,
         ccl_logger::get_instance().info(ostream.str());
     }
 
+    CCL_TRACE(sched_start, this, ccl_coll_type_to_str(coll_param.ctype), sched_id);
     exec->start(this);
 
     return get_request();
@@ -250,6 +256,10 @@ std::vector<std::shared_ptr<ccl_sched>>& ccl_sched::get_subscheds() {
 void ccl_sched::prepare_subscheds(bool update_sched_id) {
     for (auto& sched : subscheds) {
         sched->renew(update_sched_id, true);
+        CCL_TRACE(sched_start,
+                  sched.get(),
+                  ccl_coll_type_to_str(sched->coll_param.ctype),
+                  sched->sched_id);
     }
 }
 
@@ -358,8 +368,11 @@ ccl_sched::ccl_sched_ptr ccl_sched::create(const ccl_coll_param& param, const cc
 
     if (attr.to_cache) {
         key.set(param, attr);
-        std::tie(sched, is_created) =
-            ccl::global_data::get().sched_cache->find_or_create(std::move(key), create_fn);
+        // several instances per key let back-to-back launches overlap instead of
+        // being delayed, device scheds and recached unordered colls use a single instance
+        bool use_pool = !param.stream && !ccl::global_data::env().enable_unordered_coll;
+        std::tie(sched, is_created) = ccl::global_data::get().sched_cache->find_or_create(
+            std::move(key), create_fn, use_pool);
     }
     else {
         sched = create_fn();
@@ -436,7 +449,186 @@ bool ccl_sched::has_deps_entry() {
     return false;
 }
 
+bool ccl_sched::is_dag_progress() const {
+    return has_explicit_deps || ccl::global_data::env().sched_dag;
+}
+
+void ccl_sched::build_dag() {
+    size_t entry_count = entries.size();
+
+    std::unordered_map<const sched_entry*, size_t> entry_idxs;
+    for (size_t idx = 0; idx < entry_count; idx++) {
+        entry_idxs[entries[idx].get()] = idx;
+    }
+
+    dag_successors.assign(entry_count, {});
+    dag_dep_counts.assign(entry_count, 0);
+    dag_entry_segments.resize(entry_count);
+    dag_segment_starts.assign(1, 0);
+
+    size_t segment = 0;
+    for (size_t idx = 0; idx < entry_count; idx++) {
+        dag_entry_segments[idx] = segment;
+
+        /* implicit dependency on completion of the previous segment */
+        if (segment > 0) {
+            dag_dep_counts[idx]++;
+        }
+
+        for (auto dep : entries[idx]->get_dependencies()) {
+            auto it = entry_idxs.find(dep);
+            CCL_THROW_IF_NOT(it != entry_idxs.end(),
+                             "dependency of entry ",
+                             entries[idx]->name(),
+                             " does not belong to sched ",
+                             this);
+            /* dependencies point only backward, so the graph has no cycles */
+            CCL_THROW_IF_NOT(it->second < idx,
+                             "dependency ",
+                             dep->name(),
+                             " is added after entry ",
+                             entries[idx]->name());
+            dag_successors[it->second].push_back(idx);
+            dag_dep_counts[idx]++;
+        }
+
+        if (entries[idx]->is_barrier() && (idx + 1 < entry_count)) {
+            segment++;
+            dag_segment_starts.push_back(idx + 1);
+        }
+    }
+    dag_segment_starts.push_back(entry_count);
+
+    is_dag_built = true;
+
+    LOG_DEBUG("built graph for sched ",
+              this,
+              ", entries ",
+              entry_count,
+              ", segments ",
+              dag_segment_starts.size() - 1);
+}
+
+void ccl_sched::start_dag() {
+    size_t segment_count = dag_segment_starts.size() - 1;
+
+    dag_pending_deps = dag_dep_counts;
+    dag_segment_pending.resize(segment_count);
+    for (size_t segment = 0; segment < segment_count; segment++) {
+        dag_segment_pending[segment] =
+            dag_segment_starts[segment + 1] - dag_segment_starts[segment];
+    }
+
+    dag_ready.clear();
+    for (size_t idx = 0; idx < dag_pending_deps.size(); idx++) {
+        if (!dag_pending_deps[idx]) {
+            dag_ready.push_back(idx);
+        }
+    }
+
+    is_dag_started = true;
+}
+
+void ccl_sched::complete_dag_entry(size_t entry_idx) {
+    for (auto successor : dag_successors[entry_idx]) {
+        if (--dag_pending_deps[successor] == 0) {
+            dag_ready.push_back(successor);
+        }
+    }
+
+    size_t segment = dag_entry_segments[entry_idx];
+    if (--dag_segment_pending[segment] == 0 && (segment + 2 < dag_segment_starts.size())) {
+        for (size_t idx = dag_segment_starts[segment + 1]; idx < dag_segment_starts[segment + 2];
+             idx++) {
+            if (--dag_pending_deps[idx] == 0) {
+                dag_ready.push_back(idx);
+            }
+        }
+    }
+}
+
+void ccl_sched::do_dag_progress() {
+    if (!is_dag_built || dag_dep_counts.size() != entries.size()) {
+        CCL_THROW_IF_NOT(!is_dag_started, "entries can't be added to sched ", this, " in progress");
+        build_dag();
+    }
+
+    if (!is_dag_started) {
+        start_dag();
+    }
+
+    /* completed entries are marked in dag_ready and removed after the pass */
+    const size_t completed_mark = std::numeric_limits<size_t>::max();
+    size_t ready_count = dag_ready.size();
+    bool has_completed = false;
+
+    for (size_t ready_idx = 0; ready_idx < ready_count; ++ready_idx) {
+        size_t entry_idx = dag_ready[ready_idx];
+        auto& entry = entries[entry_idx];
+
+        if (entry->get_status() == ccl_sched_entry_status_not_started) {
+            LOG_DEBUG("starting entry: ",
+                      entry.get(),
+                      ", name: ",
+                      entry->name(),
+                      " [",
+                      entry_idx,
+                      "/",
+                      entries.size(),
+                      "]");
+        }
+
+        entry->do_progress();
+
+        if (entry->get_status() == ccl_sched_entry_status_again) {
+            LOG_DEBUG("entry ",
+                      entry->name(),
+                      " is in again state, stop progressing [",
+                      entry_idx,
+                      "/",
+                      entries.size(),
+                      "]");
+            break;
+        }
+
+        if (entry->is_completed()) {
+            LOG_DEBUG("completed entry: ",
+                      entry.get(),
+                      ", name: ",
+                      entry->name(),
+                      " [",
+                      entry_idx,
+                      "/",
+                      entries.size(),
+                      "], sched ",
+                      this);
+            dag_ready[ready_idx] = completed_mark;
+            complete_dag_entry(entry_idx);
+            has_completed = true;
+        }
+    }
+
+    if (!has_completed) {
+        return;
+    }
+
+    /* released entries are picked up on the next pass, lower indexes go first as in linear mode */
+    dag_ready.erase(std::remove(dag_ready.begin(), dag_ready.end(), completed_mark),
+                    dag_ready.end());
+    std::sort(dag_ready.begin(), dag_ready.end());
+
+    /* keep start_idx as the completed prefix, it is used to detect completion of the sched */
+    while (start_idx < entries.size() && entries[start_idx]->is_completed()) {
+        ++start_idx;
+    }
+}
+
 void ccl_sched::do_progress() {
+    if (is_dag_progress()) {
+        do_dag_progress();
+        return;
+    }
+
     for (auto entry_idx = start_idx; entry_idx < entries.size(); ++entry_idx) {
         auto& entry = entries[entry_idx];
 
@@ -535,6 +727,7 @@ void ccl_sched::complete() {
             }
         }
 
+        CCL_TRACE(sched_complete, this, ccl_coll_type_to_str(coll_param.ctype), sched_id);
         sched_complete_hook();
 
         // now we completed everything related to finalization of the current sched,
@@ -551,6 +744,10 @@ void ccl_sched::complete() {
                 // itt tracks only top-level sched execution
                 if (top_level_sched)
                     complete_itt(parent_schedule->coll_param.stream);
+                CCL_TRACE(sched_complete,
+                          parent_schedule,
+                          ccl_coll_type_to_str(parent_schedule->coll_param.ctype),
+                          parent_schedule->sched_id);
                 // if we don't use cache, it doesn't make sense to restart the sched
                 // as there are never be any requests to restart
                 if (parent_schedule->coll_attr.to_cache) {
@@ -574,6 +771,7 @@ void ccl_sched::renew(bool need_update_id, bool reset) {
     }
 
     start_idx = 0;
+    is_dag_started = false;
 
     if (ccl::global_data::env().sched_profile) {
         timer.start();
@@ -594,6 +792,7 @@ void ccl_sched::renew(bool need_update_id, bool reset) {
 }
 
 void ccl_sched::add_barrier() {
+    is_dag_built = false;
     if (!entries.empty()) {
         if (add_mode == ccl_sched_add_back)
             entries.back()->make_barrier();
@@ -604,6 +803,13 @@ void ccl_sched::add_barrier() {
     }
 }
 
+void ccl_sched::add_dependency(sched_entry* entry, sched_entry* dep) {
+    CCL_THROW_IF_NOT(entry && dep, "unexpected dependency for sched ", this);
+    entry->add_dependency(dep);
+    has_explicit_deps = true;
+    is_dag_built = false;
+}
+
 std::vector<ccl::event>& ccl_sched::get_deps() const {
     // if parent is not set then we should have own deps
     if (parent_sched)
@@ -17,6 +17,7 @@
 
 #include "common/request/request.hpp"
 #include "common/utils/sync_object.hpp"
+#include "sched/entry/entry_arena.hpp"
 #include "sched/sched_base.hpp"
 #include "sched/sched_timer.hpp"
 #include "sched/sched_group.hpp"
@@ -62,6 +63,8 @@ public:
         return "sched";
     }
 
+    using sched_entry_ptr = std::unique_ptr<sched_entry, sched_entry_deleter>;
+
     ccl_sched(const ccl_sched_create_param& param, bool top_level_sched = false);
     ccl_sched(const ccl_sched_create_param& param, ccl_sched* master_sched);
 
@@ -165,7 +168,7 @@ public:
     using ccl_sched_base::add_entry_front_t;
     using ccl_sched_base::add_entry_back_t;
 
-    sched_entry* add_entry(std::unique_ptr<sched_entry>&& entry) {
+    sched_entry* add_entry(sched_entry_ptr&& entry) {
         entry->set_exec_mode(exec_mode);
 
         sched_entry* raw_ptr = entry.get();
@@ -182,12 +185,12 @@ public:
     /**
      * Policy-based add_entry
      */
-    sched_entry* add_entry(std::unique_ptr<sched_entry>&& entry,
+    sched_entry* add_entry(sched_entry_ptr&& entry,
                            add_entry_mode_t<ccl_sched_add_mode_last_value>) {
         return add_entry(std::move(entry));
     }
 
-    sched_entry* add_entry(std::unique_ptr<sched_entry>&& entry, add_entry_front_t) {
+    sched_entry* add_entry(sched_entry_ptr&& entry, add_entry_front_t) {
         entry->set_exec_mode(exec_mode);
 
         sched_entry* raw_ptr = entry.get();
@@ -195,7 +198,7 @@ public:
         return raw_ptr;
     }
 
-    sched_entry* add_entry(std::unique_ptr<sched_entry>&& entry, add_entry_back_t) {
+    sched_entry* add_entry(sched_entry_ptr&& entry, add_entry_back_t) {
         entry->set_exec_mode(exec_mode);
 
         sched_entry* raw_ptr = entry.get();
@@ -209,6 +212,13 @@ public:
      */
     void add_barrier();
 
+    /**
+     * Require that @b dep is completed before @b entry may begin execution,
+     * schedules with explicit dependencies are progressed as a graph of entries,
+     * barriers keep their meaning there and order all entries around them
+     */
+    void add_dependency(sched_entry* entry, sched_entry* dep);
+
     std::vector<ccl::event>& get_deps() const;
 
     ccl_sched_bin* bin = nullptr; /* valid only during execution */
@@ -225,7 +235,8 @@ public:
     /* to track status of schedule wrt execution bin, not atomic as updated by single thread in time */
     ccl_sched_in_bin_status in_bin_status = ccl_sched_in_bin_none;
 
-    using sched_entry_ptr = std::unique_ptr<sched_entry>;
+    /* backs entries created through entry_factory, has to outlive them */
+    ccl_sched_entry_arena entry_arena;
     std::deque<sched_entry_ptr> entries{};
 
     /* whether sched should be executed in the same order as in user code */
@@ -252,6 +263,28 @@ public:
 private:
     void reset_state();
     void prepare_subscheds(bool update_sched_id = true);
+
+    bool is_dag_progress() const;
+    void build_dag();
+    void start_dag();
+    void complete_dag_entry(size_t entry_idx);
+    void do_dag_progress();
+
+    /* static part of the graph, rebuilt when entries, barriers or dependencies are changed */
+    bool has_explicit_deps = false;
+    bool is_dag_built = false;
+    std::vector<std::vector<size_t>> dag_successors;
+    std::vector<size_t> dag_dep_counts;
+    /* barriers split entries into segments, entry of segment N waits for whole segment N-1 */
+    std::vector<size_t> dag_entry_segments;
+    std::vector<size_t> dag_segment_starts;
+
+    /* runtime part of the graph, reset on renew */
+    bool is_dag_started = false;
+    std::vector<size_t> dag_pending_deps;
+    std::vector<size_t> dag_segment_pending;
+    /* started or startable entries in the order of their indexes */
+    std::vector<size_t> dag_ready;
     std::vector<std::shared_ptr<ccl_sched>> subscheds;
     ccl_sched_finalize_fn_t finalize_fn = nullptr;
     void* finalize_fn_ctx = nullptr;
@@ -53,6 +53,8 @@ private:
     // when the execution is delayed, we need update the parameters
     // only once the corresponding execution is started(because there
     // is only a single sched state, updated on each execution).
+    // sched cache may keep several instances per key (CCL_SCHED_CACHE_POOL_SIZE),
+    // each of them has its own restart manager.
     // for simplicity, delayed setting of parameters is used every
     // time the schedule is retrieved from the cache
     std::list<std::pair<ccl_coll_param, ccl_coll_attr>> launch_params;
@@ -105,6 +105,9 @@ typedef enum {
     REDUCTION_PROD,
     REDUCTION_MIN,
     REDUCTION_MAX,
+#ifndef CCL_ENABLE_SYCL
+    REDUCTION_AVG,
+#endif // CCL_ENABLE_SYCL
 #ifdef TEST_CCL_CUSTOM_REDUCE
     REDUCTION_CUSTOM,
     REDUCTION_CUSTOM_NULL,
@@ -318,8 +318,24 @@ case "$runtime" in
             run_test_cmd "${func_exec_env} ctest --output-junit ${TESTS_DIR}/junit/allreduce_fusion_${transport}.junit.xml -V -C allreduce_fusion"
         done
         ;;
+    shm_mode )
+        # shm transport requires all ranks on a single host
+        func_exec_env+=" CCL_ATL_TRANSPORT=shm"
+        run_test_cmd "${func_exec_env} ctest --output-junit ${TESTS_DIR}/junit/shm.junit.xml -V -C shm"
+        func_exec_env+=" CCL_ATL_SHM_RING_CELLS=1"
+        run_test_cmd "${func_exec_env} ctest --output-junit ${TESTS_DIR}/junit/shm_single_cell.junit.xml -V -C shm"
+        ;;
+    barrier_shm_mode )
+        # tests call barrier on the service comm, shm config places both ranks on one host
+        func_exec_env+=" CCL_BARRIER=shm"
+        for transport in ${CCL_ATL_TRANSPORT_LIST}
+        do
+            func_exec_env=$(set_tests_option "CCL_ATL_TRANSPORT=${transport}" "${func_exec_env}")
+            run_test_cmd "${func_exec_env} ctest --output-junit ${TESTS_DIR}/junit/barrier_shm_${transport}.junit.xml -V -C shm"
+        done
+        ;;
     * )
-        echo "Please specify runtime mode: runtime=ofi|mpi|ofi_adjust|mpi_adjust|priority_mode|dynamic_pointer_mode|fusion_mode|"
+        echo "Please specify runtime mode: runtime=ofi|mpi|ofi_adjust|mpi_adjust|priority_mode|dynamic_pointer_mode|fusion_mode|shm_mode|barrier_shm_mode|"
         exit 1
         ;;
 esac
@@ -280,6 +280,12 @@ T base_test<T>::calculate_reduce_value(test_operation<T>& op, size_t buf_idx, si
             break;
         case REDUCTION_MIN: expected = (T)(buf_idx); break;
         case REDUCTION_MAX: expected = (T)(op.comm_size - 1 + buf_idx); break;
+#ifndef CCL_ENABLE_SYCL
+        case REDUCTION_AVG:
+            expected = ((op.comm_size * (op.comm_size - 1)) / 2 + op.comm_size * buf_idx) /
+                       op.comm_size;
+            break;
+#endif // CCL_ENABLE_SYCL
         default: ASSERT(0, "unexpected reduction %d", op.param.reduction); break;
     }
     return expected;
@@ -318,6 +324,11 @@ float base_test<float>::calculate_reduce_value(test_operation<float>& op,
         case REDUCTION_MAX:
             expected = op.first_fp_coeff * (op.comm_size - 1) + op.second_fp_coeff * buf_idx;
             break;
+#ifndef CCL_ENABLE_SYCL
+        case REDUCTION_AVG:
+            expected = op.first_fp_coeff * (op.comm_size - 1) / 2 + op.second_fp_coeff * buf_idx;
+            break;
+#endif // CCL_ENABLE_SYCL
         default: ASSERT(0, "unexpected reduction %d", op.param.reduction); break;
     }
     return expected;